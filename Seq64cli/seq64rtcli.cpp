@@ -223,7 +223,11 @@ main (int argc, char * argv [])
                     {
                         s_seq64cli_running = true;
                         while (s_seq64cli_running)
-                            usleep(1000000);
+                        {
+                            p.publish_patterns();       /* recorded notes   */
+                            (void) p.get_tempo_map();   /* rebuild if stale */
+                            usleep(100000);
+                        }
                     }
                     else
                         printf("? Cannot set SIGTERM handler\n");
@@ -0,0 +1,108 @@
+#ifndef SEQ64_ALSA_TIMESTAMP_HPP
+#define SEQ64_ALSA_TIMESTAMP_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          alsa_timestamp.hpp
+ *
+ *  This module defines the conversion of ALSA input time-stamps to the
+ *  arrival time used for recording.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-03-17
+ * \updates       2018-03-17
+ * \license       GNU GPLv2 or above
+ *
+ *  Both ALSA back-ends (seq_alsamidi and the ALSA API of seq_rtmidi) use
+ *  this helper.  It is header-only, so that libseq64 itself does not depend
+ *  on ALSA; include it only from code that is built with ALSA.
+ */
+
+#include <alsa/asoundlib.h>
+
+#include "midibase.hpp"                 /* seq64::monotonic_us()        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Converts the real-time stamp that ALSA puts on an input event, when its
+ *  port is subscribed with a time-stamping queue, into the arrival time on
+ *  the monotonic_us() clock used by perform::arrival_tick().  The age of the
+ *  event is the current real time of the queue minus its stamp, and that age
+ *  is subtracted from the current monotonic time.  Events that carry no
+ *  real-time stamp from our queue (for example, those sent to a virtual
+ *  port), or whose queue is not running, are taken to arrive now.
+ *
+ * \param seq
+ *      The ALSA sequencer client.
+ *
+ * \param queue
+ *      The queue with which the input ports are subscribed.
+ *
+ * \param ev
+ *      The input event.
+ *
+ * \return
+ *      Returns the arrival time in microseconds, or 0 if not available.
+ *      Stored in the midipulse time-stamp of an event, it may keep only its
+ *      low 32 bits; see arrival_us_from_stamp().
+ */
+
+inline int64_t
+alsa_arrival_us (snd_seq_t * seq, int queue, const snd_seq_event_t * ev)
+{
+    if (snd_seq_ev_is_real(ev) && ev->queue == queue)
+    {
+        snd_seq_queue_status_t * status;
+        snd_seq_queue_status_alloca(&status);
+        if (snd_seq_get_queue_status(seq, queue, status) == 0)
+        {
+            int64_t now = monotonic_us();
+            const snd_seq_real_time_t * rt =
+                snd_seq_queue_status_get_real_time(status);
+
+            int64_t age =
+                (int64_t(rt->tv_sec) - int64_t(ev->time.time.tv_sec)) *
+                    1000000 +
+                (int64_t(rt->tv_nsec) - int64_t(ev->time.time.tv_nsec)) /
+                    1000;
+
+            return age > 0 && now > age ? now - age : now ;
+        }
+    }
+    return monotonic_us();
+}
+
+}           // namespace seq64
+
+#endif      // SEQ64_ALSA_TIMESTAMP_HPP
+
+/*
+ * alsa_timestamp.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -274,6 +274,21 @@ private:
 
     std::vector<businfo> m_container;
 
+    /**
+     *  The input bus that the last poll_for_midi() found to have data, or -1
+     *  if unknown.  get_midi_event() starts there, rather than asking every
+     *  bus in turn.
+     */
+
+    int m_ready_bus;
+
+    /**
+     *  The bus after the one that provided the last input event.  Polling
+     *  starts here, so that a busy bus cannot starve the busses after it.
+     */
+
+    int m_next_bus;
+
 public:
 
     busarray ();
@@ -303,7 +318,12 @@ public:
     void init_clock (midipulse tick);
     void clock (midipulse tick);
     void sysex (event * ev);
+    void get_busses (std::vector<midibus *> & busses);
     void play (bussbyte bus, event * e24, midibyte channel);
+    void play_at
+    (
+        bussbyte bus, event * e24, midibyte channel, int64_t when_us
+    );
     bool set_clock (bussbyte bus, clock_e clocktype);
     void set_all_clocks ();
     clock_e get_clock (bussbyte bus);
@@ -71,6 +71,7 @@
 
 namespace seq64
 {
+    class tempo_map;                    /* forward reference            */
 
 /**
  *  Provides a clear enumation of wave types supported by the wave function.
@@ -125,6 +126,14 @@ extern std::string pulses_to_timestring
 (
     midipulse pulses, midibpm bpm, int ppqn, bool showus = true
 );
+extern std::string pulses_to_timestring
+(
+    midipulse pulses, const tempo_map & tmap, bool showus = true
+);
+extern std::string microseconds_to_timestring
+(
+    unsigned long microseconds, bool showus = true
+);
 extern midipulse measurestring_to_pulses
 (
     const std::string & measures,
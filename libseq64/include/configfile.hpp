@@ -36,7 +36,9 @@
  */
 
 #include <fstream>
+#include <map>
 #include <string>
+#include <vector>
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -64,12 +66,73 @@ class configfile
 
 private:
 
+    /**
+     *  Holds the lines of the configuration file, without their newlines.
+     */
+
+    typedef std::vector<std::string> LineList;
+
+    /**
+     *  Maps a section tag, such as "[midi-control]", to the index of its
+     *  line in the LineList.
+     */
+
+    typedef std::map<std::string, int> SectionIndex;
+
     /**
      *  Holds the last error message, if any.  Not a 100% foolproof yet.
      */
 
     std::string m_error_message;
 
+    /**
+     *  The whole configuration file, read in one pass by load_file(), and
+     *  split into lines.  The parsers walk this list instead of the file.
+     */
+
+    LineList m_lines;
+
+    /**
+     *  The index of each section marker in m_lines, built by load_file(),
+     *  so that line_after() can go straight to a section instead of
+     *  rescanning the file from the beginning for every tag.  If a tag
+     *  appears more than once, the first occurrence is indexed, as before.
+     */
+
+    SectionIndex m_sections;
+
+    /**
+     *  The index in m_lines of the next line that next_data_line() will
+     *  read.
+     */
+
+    int m_line_index;
+
+    /**
+     *  Indicates that the line most recently read was the last one in the
+     *  file (or that there was none), matching the end-of-file condition of
+     *  the stream that the parsers used to read.
+     */
+
+    bool m_at_eof;
+
+    /**
+     *  True if the file ended with a newline.  If not, reading its last
+     *  line sets m_at_eof, just as std::getline() would.
+     */
+
+    bool m_final_newline;
+
+    /**
+     *  The modification time and size of the file when it was loaded.  If
+     *  they have not changed, load_file() reuses m_lines and m_sections,
+     *  so a second parse of the same file (e.g. the mute-group section of
+     *  the "rc" file) does not read it again.
+     */
+
+    long m_file_mtime;
+    long m_file_size;
+
 protected:
 
     /**
@@ -94,8 +157,9 @@ protected:
 
 protected:
 
-    bool next_data_line (std::ifstream & file);
-    bool line_after (std::ifstream & file, const std::string & tag);
+    bool load_file ();
+    bool next_data_line ();
+    bool line_after (const std::string & tag);
 
     /**
      *  Sometimes we need to know if there are new data lines at the end of an
@@ -139,6 +203,10 @@ protected:
         m_error_message = msg;
     }
 
+private:
+
+    bool get_line ();
+
 };
 
 }           // namespace seq64
@@ -45,10 +45,17 @@
  *  release mode, and a lot faster in debug mode.  Why?  Probably because
  *  the std::list implementation calls std::list::sort() a lot, and the
  *  std::multimap implementation is a lot faster at sorting.
+ *
+ *  Whichever node container is used, it now serves as the editing store.
+ *  Playback reads a second, contiguous and time-sorted array of compact
+ *  records that is rebuilt ("compacted") from the editing store after edits,
+ *  as an immutable, shared snapshot.  See event_list::compact().
  */
 
+#include <memory>                       /* std::shared_ptr              */
 #include <string>
 #include <stack>
+#include <vector>                       /* std::vector                  */
 
 #include "seq64_features.h"             /* SEQ64_USE_EVENT_MAP          */
 
@@ -153,6 +160,140 @@ private:
     typedef Events::reverse_iterator reverse_iterator;
     typedef Events::const_reverse_iterator const_reverse_iterator;
 
+public:
+
+    /**
+     *  Provides a compact playback record, a small copy of the parts of an
+     *  event that playback and drawing need in order to decide whether to
+     *  use the event.  An array of these records is much friendlier to the
+     *  cache than the nodes of the editing container, each of which holds a
+     *  full event with its own sysex vector.  The full event is reached
+     *  through the pr_event pointer only when it is actually emitted.  The
+     *  data bytes are copied from the snapshot's own copy of the event,
+     *  which is never changed, so they cannot go stale.
+     */
+
+    typedef struct
+    {
+        /**
+         *  Holds the time-stamp of the event, in pulses.
+         */
+
+        midipulse pr_timestamp;
+
+        /**
+         *  Points to the snapshot's copy of the event.  This pointer is
+         *  valid as long as the snapshot holding the record.  The copy's
+         *  own link is cleared, since it would point into the editing
+         *  container; use pr_link instead.
+         */
+
+        event * pr_event;
+
+        /**
+         *  Holds the index of the record of the linked event (for example,
+         *  the Note Off of a Note On), or -1 if the event is not linked.
+         */
+
+        int pr_link;
+
+        /**
+         *  Holds the status byte of the event, without the channel.
+         */
+
+        midibyte pr_status;
+
+        /**
+         *  Holds the channel of the event, or, for Meta events, the type of
+         *  Meta event.
+         */
+
+        midibyte pr_channel;
+
+        /**
+         *  Holds the two data bytes of the event.
+         */
+
+        midibyte pr_d0;
+        midibyte pr_d1;
+
+    } playback_record_t;
+
+    /**
+     *  The contiguous container of playback records, sorted by time-stamp in
+     *  the same order as the editing container.
+     */
+
+    typedef std::vector<playback_record_t> PlaybackArray;
+
+    /**
+     *  Provides a snapshot of the event list for playback:  copies of the
+     *  events, the playback records that index them, and the pattern length
+     *  that goes with them.  A snapshot is never modified once compact() has
+     *  built it, so a reader holding a reference to it needs no lock, and an
+     *  edit simply leads to a new snapshot.
+     */
+
+    typedef struct
+    {
+        /**
+         *  Holds copies of the events, in time order.  The records point
+         *  into this vector.
+         */
+
+        std::vector<event> ps_events;
+
+        /**
+         *  Holds the playback records, one per event.
+         */
+
+        PlaybackArray ps_records;
+
+        /**
+         *  Holds the edit count of the event list when compacted.
+         */
+
+        unsigned long ps_edit_count;
+
+        /**
+         *  Holds the pattern length supplied to compact().
+         */
+
+        midipulse ps_length;
+
+    } playback_snapshot_t;
+
+    /**
+     *  The reference-counted handle to a playback snapshot.  The last holder
+     *  to let go of a replaced snapshot frees it.
+     */
+
+    typedef std::shared_ptr<const playback_snapshot_t> PlaybackSnapshot;
+
+    /**
+     *  Provides an undo/redo record for a sequence edit.  Rather than a copy
+     *  of the whole event list, it holds only the events that the edit
+     *  removed and the events that it added.  A modified event is simply a
+     *  removal of the old version plus an insertion of the new one.  The
+     *  record is filled in as the edit is made; see journal() and apply().
+     */
+
+    typedef struct
+    {
+        /**
+         *  Holds copies of the events that the edit removed from the list.
+         */
+
+        std::vector<event> ed_removed;
+
+        /**
+         *  Holds copies of the events that the edit added to the list.
+         */
+
+        std::vector<event> ed_added;
+
+    } edit_delta_t;
+
 private:
 
     /**
@@ -188,6 +329,56 @@ private:
 
     bool m_has_time_signature;
 
+    /**
+     *  Counts the structural changes made to the container:  insertions,
+     *  removals, sorts, merges, and assignments.  Unlike m_is_modified, this
+     *  value is never reset, so that a client (such as the playback cursor
+     *  in sequence::play()) can save it and later tell cheaply whether any
+     *  iterator it is holding might have been invalidated.
+     */
+
+    unsigned long m_edit_count;
+
+    /**
+     *  Holds the latest playback snapshot.  A new one is built from m_events
+     *  by compact() whenever m_edit_count or the pattern length has moved on
+     *  since the last compaction.  It is null until the first compaction.
+     */
+
+    PlaybackSnapshot m_playback;
+
+    /**
+     *  Points to the undo record that the owner of the list is filling in,
+     *  or is null.  While it is set, every event added to or removed from
+     *  the list, and every event changed in place through touch(), is copied
+     *  into it.  It is never copied with the list.
+     */
+
+    edit_delta_t * m_journal;
+
+    /**
+     *  Holds the Note Ons and Note Offs left unlinked by the last call to
+     *  link_new(), so that link_appended() can pair newly added notes with
+     *  them without a pass over the whole list.
+     */
+
+    std::vector<event *> m_link_pending;
+
+    /**
+     *  Holds the Note Ons and Note Offs added by append() since the last
+     *  call to link_new() or link_appended().
+     */
+
+    std::vector<event *> m_link_appended;
+
+    /**
+     *  Indicates that m_link_pending and m_link_appended are still good.
+     *  Any change to the list other than append() makes them unreliable,
+     *  and link_appended() then falls back to link_new().
+     */
+
+    bool m_link_valid;
+
 public:
 
     event_list ();
@@ -304,7 +495,12 @@ public:
 
     void push_back (const event & e)
     {
+        if (not_nullptr(m_journal))
+            m_journal->ed_added.push_back(e);
+
         m_events.push_back(e);
+        ++m_edit_count;
+        unlink_state();
     }
 
 #endif
@@ -336,6 +532,92 @@ public:
         return m_has_time_signature;
     }
 
+    /**
+     * \getter m_edit_count
+     */
+
+    unsigned long edit_count () const
+    {
+        return m_edit_count;
+    }
+
+    /**
+     *  Counts a change made to an event in place, such as a new velocity or
+     *  a transposition, as an edit.  Such a change does not move or relink
+     *  any event, so nothing else is reset, but the playback snapshot, which
+     *  holds copies of the events, must be rebuilt.  If an undo record is
+     *  being filled in, the change goes into it as a removal of the old
+     *  version plus an insertion of the new one.  Sets the modified-flag.
+     *
+     * \param before
+     *      A copy of the event as it was before the change.
+     *
+     * \param after
+     *      The event as changed.
+     */
+
+    void touch (const event & before, const event & after)
+    {
+        if (not_nullptr(m_journal))
+        {
+            m_journal->ed_removed.push_back(before);
+            m_journal->ed_added.push_back(after);
+        }
+        m_is_modified = true;
+        ++m_edit_count;
+    }
+
+    /**
+     * \setter m_journal
+     *
+     * \param delta
+     *      The undo record to fill in as the list is edited, or null to stop
+     *      recording.  The caller owns it, and must keep it alive, and must
+     *      not change it, while it is set.
+     */
+
+    void journal (edit_delta_t * delta)
+    {
+        m_journal = delta;
+    }
+
+    /**
+     *  Indicates that the playback snapshot no longer reflects the editing
+     *  container or the given pattern length.
+     *
+     * \param length
+     *      The current length of the pattern.
+     */
+
+    bool playback_stale (midipulse length) const
+    {
+        return
+        (
+            ! m_playback ||
+            m_playback->ps_edit_count != m_edit_count ||
+            m_playback->ps_length != length
+        );
+    }
+
+    void compact (midipulse length);
+
+    /**
+     *  Provides the playback snapshot, compacting it first if it is stale.
+     *  The caller must hold whatever lock protects the event list, but the
+     *  snapshot itself can be kept and read without it.
+     *
+     * \param length
+     *      The current length of the pattern.
+     */
+
+    PlaybackSnapshot playback (midipulse length)
+    {
+        if (playback_stale(length))
+            compact(length);
+
+        return m_playback;
+    }
+
     /**
      * \setter m_is_modified
      *      This function may be needed by some of the sequence editors.
@@ -358,8 +640,13 @@ public:
 
     void remove (iterator ie)
     {
+        if (not_nullptr(m_journal))
+            m_journal->ed_removed.push_back(dref(ie));
+
         m_events.erase(ie);
         m_is_modified = true;
+        ++m_edit_count;
+        unlink_state();
     }
 
     /**
@@ -368,14 +655,21 @@ public:
 
     void clear ()
     {
+        journal_removed_all();
         m_events.clear();
         m_is_modified = true;
+        ++m_edit_count;
+        unlink_state();
     }
 
     void merge (event_list & el, bool presort = true);
+    void apply (const edit_delta_t & delta, bool reverse = false);
+    static void cancel_common (edit_delta_t & delta);
+    static size_t delta_bytes (const edit_delta_t & delta);
 
     /**
      *  Sorts the event list; active only for the std::list implementation.
+     *  Sorting reorders the list, so the edit count is bumped.
      */
 
     void sort ()
@@ -384,6 +678,7 @@ public:
         // we need nothin' for sorting a multimap
 #else
         m_events.sort();
+        ++m_edit_count;
 #endif
     }
 
@@ -419,6 +714,25 @@ public:
 #endif
     }
 
+private:
+
+    /**
+     *  Forgets the note-linking state kept for link_appended(), whose event
+     *  pointers may no longer be valid.  The next link_appended() does a
+     *  full link_new() pass.
+     */
+
+    void unlink_state ()
+    {
+        m_link_valid = false;
+        m_link_pending.clear();
+        m_link_appended.clear();
+    }
+
+    static int link_key (const event & e);
+    void journal_added_all (const event_list & el);
+    void journal_removed_all ();
+
 private:                                // functions for friend sequence
 
     /*
@@ -427,6 +741,7 @@ private:                                // functions for friend sequence
      */
 
     void link_new ();
+    void link_appended ();
     void clear_links ();
 #ifdef USE_FILL_TIME_SIG_AND_TEMPO
     void scan_meta_events ();
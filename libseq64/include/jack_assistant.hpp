@@ -637,8 +637,11 @@ private:
     }
 
     /**
-     *  Convenience function for internal use.  Should we change 4.0 to a
-     *  member value?  What does it mean?
+     *  Convenience function for internal use.  A JACK beat is one beat_type
+     *  note, and our pulses (like the tempo map) count quarter notes, so the
+     *  4.0 converts JACK beats to quarter notes.  All JACK tick conversions
+     *  (position(), sync(), output(), and jack_timebase_callback()) use this
+     *  convention.
      *
      * \return
      *      Returns the multiplier to convert a JACK tick value according to
@@ -62,6 +62,7 @@ class mastermidibase
 
     friend class perform;
     friend class midi_alsa_info;
+    friend void * sysex_thread_func (void * mmb);
 
 protected:
 
@@ -155,6 +156,44 @@ protected:
 
     sequence * m_seq;
 
+    /**
+     *  The tick at which the output thread last anchored the scheduling of
+     *  lookahead output, or -1 if events are to be sent directly.  See
+     *  set_schedule_anchor().
+     */
+
+    midipulse m_anchor_tick;
+
+    /**
+     *  The output-queue time, in microseconds, that corresponds to
+     *  m_anchor_tick.
+     */
+
+    int64_t m_anchor_us;
+
+    /**
+     *  The furthest ahead of m_anchor_us, in microseconds, that an event may
+     *  be scheduled.
+     */
+
+    long m_lookahead_us;
+
+    /**
+     *  Counts the events played through play() and play_at(), for the
+     *  output statistics.  Before output was batched per frame, each of
+     *  these cost a flush.
+     */
+
+    long m_play_count;
+
+    /**
+     *  Counts the calls to flush(), each of which is a drain system call for
+     *  ALSA.  The difference from m_play_count is the number of flushes saved
+     *  by batching.
+     */
+
+    long m_flush_count;
+
     /**
      *  The locking mutex.  This object is passed to an automutex object that
      *  lends exception-safety to the mutex locking.
@@ -162,6 +201,47 @@ protected:
 
     mutex m_mutex;
 
+    /**
+     *  The thread that sends the queued SysEx data of the output busses, at
+     *  the rate given by rc().sysex_rate().  It is launched by the first
+     *  sysex() call, so it exists only if SysEx is actually passed through.
+     */
+
+    pthread_t m_sysex_thread;
+
+    /**
+     *  Indicates that m_sysex_thread was created, and must be joined.
+     */
+
+    bool m_sysex_thread_launched;
+
+    /**
+     *  Tells the SysEx thread to exit.  Protected by m_sysex_cond.
+     */
+
+    bool m_sysex_stop;
+
+    /**
+     *  Set by sysex() when it queues data, so that the SysEx thread does not
+     *  go to sleep after missing it.  Protected by m_sysex_cond.
+     */
+
+    bool m_sysex_pending;
+
+    /**
+     *  Wakes the SysEx thread when data is queued or the thread must stop.
+     */
+
+    condition_var m_sysex_cond;
+
+    /**
+     *  The output busses, as copied by the SysEx thread under m_mutex on
+     *  each pass, so that it sends without holding m_mutex.  Used only by
+     *  that thread.
+     */
+
+    std::vector<midibus *> m_sysex_busses;
+
 public:
 
     mastermidibase
@@ -268,6 +348,24 @@ public:
         return m_ppqn;
     }
 
+    /**
+     * \getter m_play_count
+     */
+
+    long play_count () const
+    {
+        return m_play_count;
+    }
+
+    /**
+     * \getter m_flush_count
+     */
+
+    long flush_count () const
+    {
+        return m_flush_count;
+    }
+
     /**
      * \getter m_dumping_input
      */
@@ -291,10 +389,14 @@ public:
     void port_start (int client, int port);
     void port_exit (int client, int port);
     void play (bussbyte bus, event * e24, midibyte channel);
+    void play_at (bussbyte bus, event * e24, midibyte channel, midipulse tick);
+    bool set_schedule_anchor (midipulse tick, int lookaheadms);
+    void cancel_scheduled ();
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void emit_clock (midipulse tick);
     void sysex (event * event);
+    void stop_sysex_thread ();
     void print () const;
     void flush ();
     void panic ();                                          /* kepler34 func  */
@@ -423,6 +525,28 @@ protected:
         // no code for base or portmidi
     }
 
+    /**
+     *  Provides the current real time of the output queue, in microseconds,
+     *  for lookahead scheduling.  Only ALSA has such a queue; a negative
+     *  value means that events must be sent directly.
+     */
+
+    virtual int64_t api_queue_time_us ()
+    {
+        return -1;
+    }
+
+    /**
+     *  Removes the pattern events that are scheduled on the output queue but
+     *  not yet delivered.  Note-offs are left in place, so that no notes are
+     *  left hanging.
+     */
+
+    virtual void api_cancel_scheduled ()
+    {
+        // no code for base or portmidi
+    }
+
     /**
      *  Provides MIDI API-specific functionality for the clock() function.
      */
@@ -444,7 +568,6 @@ protected:
 /*
  *  So far, there is no need for these API-specific functions.
  *
- *  virtual void api_sysex (event * ev) = 0;
  *  virtual void api_play (bussbyte bus, event * e24, midibyte channel) = 0;
  *  virtual void api_set_clock (bussbyte bus, clock_e clocktype) = 0;
  *  virtual void api_get_clock (bussbyte bus) = 0;
@@ -456,12 +579,19 @@ private:
 
     bool save_clock (bussbyte bus, clock_e clock);
     bool save_input (bussbyte bus, bool inputing);
+    void sysex_func ();
 #if 0
     void swap ();
 #endif
 
 };          // class mastermidibase
 
+/*
+ *  Free functions
+ */
+
+extern void * sysex_thread_func (void * mmb);
+
 }           // namespace seq64
 
 #endif      // SEQ64_MASTERMIDIBASE_HPP
@@ -297,6 +297,42 @@ public:
 
     virtual void put (midibyte b) = 0;
 
+    /**
+     *  Adds a run of MIDI bytes to the container.  This default version
+     *  simply calls put() for each byte; a contiguous container overrides it
+     *  to append the whole run at once, so that SysEx data, track names, and
+     *  the multi-byte fields cost one virtual call instead of one per byte.
+     *
+     * \param b
+     *      Points to the first byte to add.
+     *
+     * \param count
+     *      The number of bytes to add.
+     */
+
+    virtual void put_bytes (const midibyte * b, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            put(b[i]);
+    }
+
+    /**
+     *  Provides direct access to the bytes of the container, in output
+     *  order, if the container stores them contiguously.  This lets
+     *  midifile::write_track() copy a track in one operation instead of
+     *  calling get() for each byte.
+     *
+     * \return
+     *      Returns a pointer to the first byte, or a null pointer if the
+     *      container is empty or not contiguous, in which case get() must
+     *      be used.
+     */
+
+    virtual const midibyte * bytes () const
+    {
+        return nullptr;
+    }
+
     /**
      *  Provide a way to get the next byte from the container.  It also
      *  increments m_position_for_get.
@@ -354,6 +390,7 @@ private:
     void fill_seq_name (const std::string & name);
     void fill_meta_track_end (midipulse deltatime);
     void fill_proprietary ();
+    void fill_start_tempo (midibpm bpm);
 
 #ifdef USE_FILL_TIME_SIG_AND_TEMPO
     void fill_time_sig_and_tempo
@@ -101,6 +101,13 @@ const int c_midi_control_quan_record  = c_midi_track_ctrl + 18;
 const int c_midi_control_19           = c_midi_track_ctrl + 19;
 const int c_midi_controls_extended    = c_midi_track_ctrl + 20; /* new = 84 */
 
+/**
+ *  The number of values of a status or data byte, which sizes the lookup
+ *  table that perform builds from the MIDI controls.
+ */
+
+const int c_midi_control_statuses     = 256;
+
 extern int g_midi_control_limit;
 
 /**
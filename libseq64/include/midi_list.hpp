@@ -61,8 +61,8 @@ class midi_list : public midi_container
 private:
 
     /**
-     *  Provides the type of this container.  This type is basically the same
-     *  as the midifile::m_char_list container in the midifile module.
+     *  Provides the type of this container.  Unlike midi_vector, it is not
+     *  contiguous, so midifile::write_track() must copy it with get().
      */
 
     typedef std::list<midibyte> CharList;
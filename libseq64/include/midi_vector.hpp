@@ -120,6 +120,32 @@ public:
         m_char_vector.push_back(b);
     }
 
+    /**
+     *  Appends a run of MIDI bytes to the character vector in one operation.
+     *
+     * \param b
+     *      Points to the first byte to add.
+     *
+     * \param count
+     *      The number of bytes to add.
+     */
+
+    virtual void put_bytes (const midibyte * b, std::size_t count)
+    {
+        m_char_vector.insert(m_char_vector.end(), b, b + count);
+    }
+
+    /**
+     * \return
+     *      Returns a pointer to the contiguous bytes of the vector, or a null
+     *      pointer if the vector is empty.
+     */
+
+    virtual const midibyte * bytes () const
+    {
+        return m_char_vector.empty() ? nullptr : &m_char_vector[0];
+    }
+
     /**
      *  Provide a way to get the next byte from the container.  In this
      *  implementation, m_position_for_get is used.  As a side-effect, the
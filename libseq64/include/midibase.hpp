@@ -35,6 +35,10 @@
  *  base class for all such classes.
  */
 
+#include <deque>                        /* std::deque<>, the SysEx queue */
+#include <stdint.h>                     /* int64_t for microsecond times */
+#include <vector>                       /* std::vector<>                */
+
 #include "app_limits.h"                 /* SEQ64_USE_DEFAULT_PPQN       */
 #include "easy_macros.h"                /* for autoconf header files    */
 #include "mutex.hpp"
@@ -183,6 +187,39 @@ private:
 
     mutex m_mutex;
 
+    /**
+     *  Holds the SysEx messages waiting to be sent on this bus.  The sysex()
+     *  function only adds a copy of the message here; the messages are sent
+     *  in pieces by send_sysex(), called from the SysEx thread of the
+     *  master bus, so that a long dump never holds up the caller or the
+     *  channel events played on this bus.
+     */
+
+    std::deque< std::vector<midibyte> > m_sysex_queue;
+
+    /**
+     *  The number of bytes of the front message of m_sysex_queue that have
+     *  already been sent.
+     */
+
+    std::size_t m_sysex_sent;
+
+    /**
+     *  The monotonic time, in microseconds, before which the next piece of
+     *  SysEx data must not be sent, so that the configured byte rate is
+     *  respected.
+     */
+
+    int64_t m_sysex_due_us;
+
+    /**
+     *  Protects m_sysex_queue and its bookkeeping.  It is separate from
+     *  m_mutex so that queueing a message never waits for a port operation.
+     *  When both are needed, this one is locked first.
+     */
+
+    mutex m_sysex_mutex;
+
 public:
 
     midibase
@@ -479,7 +516,9 @@ public:
     bool init_out_sub ();
     bool init_in_sub ();
     void play (event * e24, midibyte channel);
+    void play_at (event * e24, midibyte channel, int64_t when_us);
     void sysex (event * e24);
+    long send_sysex (int64_t now_us, int bytespersec);
     void flush ();
     void start ();
     void stop ();
@@ -579,14 +618,43 @@ protected:
     virtual void api_play (event * e24, midibyte channel) = 0;
 
     /**
-     *  Handles implementation details for SysEx messages.
+     *  Schedules an event on the output queue.  Only the ALSA
+     *  implementations have such a queue; the others play the event
+     *  immediately.
+     */
+
+    virtual void api_play_at (event * e24, midibyte channel, int64_t /*when*/)
+    {
+        api_play(e24, channel);
+    }
+
+    /**
+     *  Handles implementation details for SysEx messages.  Sends one piece of
+     *  a SysEx message immediately, without waiting.  The pieces are at most
+     *  api_sysex_chunk() bytes long.
+     *
+     *  The \a data and \a len parameters are unused here.
      *
-     *  The \a e24 parameter, the SysEx event pointer, is unused here.
+     * \return
+     *      Returns true if the piece was taken (or dropped for good).  False
+     *      means the port has no room for it now, and it should be offered
+     *      again later.
      */
 
-    virtual void api_sysex (event * /* e24 */)
+    virtual bool api_sysex (const midibyte * /* data */, int /* len */)
     {
-        // no code for portmidi
+        return true;                    /* no code for portmidi */
+    }
+
+    /**
+     *  The largest piece of a SysEx message that api_sysex() is given.  APIs
+     *  that must send each message as a single event return 0, meaning the
+     *  whole message at once.
+     */
+
+    virtual int api_sysex_chunk () const
+    {
+        return c_midibus_sysex_chunk;
     }
 
     /**
@@ -614,6 +682,8 @@ protected:
  */
 
 extern void millisleep (unsigned long ms);
+extern int64_t monotonic_us ();
+extern int64_t arrival_us_from_stamp (midipulse stamp, int64_t now_us);
 
 }           // namespace seq64
 
@@ -69,6 +69,14 @@ const int c_midibus_input_size  = 0x100000;     // 1048576
 
 const int c_midibus_sysex_chunk = 0x100;        //     256
 
+/**
+ *  The ALSA event tag given to pattern events that are scheduled ahead on
+ *  the sequencer queue, so that they can be removed on stop, reposition, or
+ *  tempo change without touching the clock events, which use tag 127.
+ */
+
+const int c_midibus_schedule_tag = 1;
+
 /**
  *  A clock enumeration, as used in the File / Options / MIDI Clock dialog.
  *  This enumeration was also defined in midibus_portmidi.h, but we put it
@@ -138,9 +138,9 @@ private:
     const std::string m_name;
 
     /**
-     *  This vector of characters holds our MIDI data.  We could also use
-     *  a string of characters, unsigned.  This member is resized to the
-     *  putative size of the MIDI file, in the parse() function.  Then the
+     *  This vector of characters holds our MIDI data if the file cannot be
+     *  memory-mapped (see map_file()).  This member is then resized to the
+     *  putative size of the MIDI file, in the parse() function, and the
      *  whole file is read into it, as if it were an array.  This member is an
      *  input buffer.
      */
@@ -148,14 +148,35 @@ private:
     std::vector<midibyte> m_data;
 
     /**
-     *  Provides a list of characters.  The class pushes each MIDI byte into
-     *  this list using the write_byte() function.  Also note that the write()
-     *  function calls sequence::fill_list() to fill a temporary
-     *  std::list<char> (!) buffer, then writes that data <i> backwards </i> to
-     *  this member.  This member is an output buffer.
+     *  Points to the MIDI data being parsed:  either the memory-mapped file,
+     *  or the contents of m_data.  Only read_byte() and peek_byte() access
+     *  it, and they check m_pos against m_file_size.
      */
 
-    std::list<midibyte> m_char_list;
+    const midibyte * m_bytes;
+
+    /**
+     *  The address of the memory-mapped file, or null if the file is not
+     *  mapped.  It stays mapped until the next parse() or the destructor.
+     */
+
+    void * m_map;
+
+    /**
+     *  The size of the mapping at m_map.
+     */
+
+    size_t m_map_size;
+
+    /**
+     *  Provides the output buffer.  The class appends each MIDI byte to
+     *  this contiguous buffer using the write_byte() function, and whole
+     *  tracks using write_bytes().  When the file is complete, the buffer is
+     *  written out in one operation by flush_file(), and cleared, though its
+     *  capacity is kept for the next save.
+     */
+
+    std::vector<midibyte> m_write_buffer;
 
     /**
      *  Use the new format for the proprietary footer section of the Seq24
@@ -261,6 +282,9 @@ private:
     midilong read_long ();
     midishort read_short ();
     midibyte read_byte ();
+    midibyte peek_byte (int offset = 0) const;
+    bool map_file ();
+    void unmap_file ();
     midilong read_varinum ();
     void write_long (midilong value);
     void write_triple (midilong value);
@@ -284,8 +308,8 @@ private:
     }
 
     /**
-     *  Writes 1 byte.  The byte is written to the m_char_list member, using a
-     *  call to push_back().
+     *  Writes 1 byte.  The byte is appended to the m_write_buffer member,
+     *  using a call to push_back().
      *
      * \param c
      *      The MIDI byte to be "written".
@@ -293,9 +317,27 @@ private:
 
     void write_byte (midibyte c)
     {
-        m_char_list.push_back(c);
+        m_write_buffer.push_back(c);
     }
 
+    /**
+     *  Writes a run of bytes, appending them to the m_write_buffer member in
+     *  one operation.
+     *
+     * \param b
+     *      Points to the first byte to be "written".
+     *
+     * \param count
+     *      The number of bytes to append.
+     */
+
+    void write_bytes (const midibyte * b, size_t count)
+    {
+        m_write_buffer.insert(m_write_buffer.end(), b, b + count);
+    }
+
+    bool flush_file (const std::string & errmsg);
+
     void write_varinum (midilong);
     void write_track_name (const std::string & trackname);
     std::string read_track_name();
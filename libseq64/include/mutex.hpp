@@ -79,6 +79,7 @@ public:
 
     mutex ();
     void lock () const;
+    bool try_lock () const;
     void unlock () const;
 
 };
@@ -101,6 +102,13 @@ private:
 
     mutex & m_safety_mutex;
 
+    /**
+     *  Indicates if the mutex is held, and so must be unlocked by the
+     *  destructor.  It is false only if a try-lock failed.
+     */
+
+    bool m_locked;
+
 private:        // do not allow these functions to be used
 
     automutex ();
@@ -117,18 +125,52 @@ public:
      *      The caller's mutex to be used for locking.
      */
 
-    automutex (mutex & my_mutex) : m_safety_mutex (my_mutex)
+    automutex (mutex & my_mutex) :
+        m_safety_mutex  (my_mutex),
+        m_locked        (true)
     {
         m_safety_mutex.lock();
     }
 
     /**
-     *  The destructor unlocks the mutex.
+     *  Try-lock constructor.  If trylock is true, the mutex is locked only
+     *  if it is free, and the caller checks locked() to see if it got it.
+     *  Otherwise, this constructor locks the mutex like the one above.
+     *
+     * \param my_mutex
+     *      The caller's mutex to be used for locking.
+     *
+     * \param trylock
+     *      If true, do not wait for the mutex.
+     */
+
+    automutex (mutex & my_mutex, bool trylock) :
+        m_safety_mutex  (my_mutex),
+        m_locked        (true)
+    {
+        if (trylock)
+            m_locked = m_safety_mutex.try_lock();
+        else
+            m_safety_mutex.lock();
+    }
+
+    /**
+     *  The destructor unlocks the mutex, if it was locked.
      */
 
     ~automutex ()
     {
-        m_safety_mutex.unlock();
+        if (m_locked)
+            m_safety_mutex.unlock();
+    }
+
+    /**
+     * \getter m_locked
+     */
+
+    bool locked () const
+    {
+        return m_locked;
     }
 
 };
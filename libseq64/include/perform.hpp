@@ -60,12 +60,15 @@
 #include "mastermidibus.hpp"            /* seq64::mastermidibus for ALSA    */
 #include "midi_control.hpp"             /* seq64::midi_control "struct"     */
 #include "sequence.hpp"                 /* seq64::sequence                  */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
 
 #ifdef SEQ64_SONG_BOX_SELECT
 #include <functional>                   /* std::function, function objects  */
 #include <set>                          /* std::set, arbitary selection     */
 #endif
 
+#include <atomic>                       /* std::atomic<bool>, <int>         */
+#include <memory>                       /* std::shared_ptr<>                */
 #include <vector>                       /* std::vector                      */
 #include <pthread.h>                    /* pthread_t C structure            */
 
@@ -90,6 +93,13 @@
 
 #define SEQ64_ALL_TRACKS                (-1)
 
+/**
+ *  The maximum number of views that can subscribe to the change records of
+ *  a perform object at one time.  See perform::subscribe_changes().
+ */
+
+#define SEQ64_CHANGE_SUBSCRIBERS_MAX    16
+
 /*
  *  All Sequencer64 library code is in the seq64 namespace.
  */
@@ -247,6 +257,174 @@ struct performcallback
 
 };
 
+/**
+ *  The kinds of change that perform reports to the views that subscribe to
+ *  them.  These are bit flags, so that all of the changes made to a pattern
+ *  between two drains can be coalesced into a single change_record_t.
+ */
+
+enum change_t
+{
+    CHANGE_NONE         = 0x00,     /* nothing changed                      */
+    CHANGE_SEQUENCE     = 0x01,     /* pattern edited, added, or removed    */
+    CHANGE_MUTE         = 0x02,     /* pattern armed, muted, or queued      */
+    CHANGE_TEMPO        = 0x04,     /* beats/minute of the performance      */
+    CHANGE_SCREENSET    = 0x08,     /* the active screen-set                */
+    CHANGE_ALL          = 0x0f      /* everything, to prime a subscription  */
+};
+
+/**
+ *  One coalesced change, as handed out by perform::poll_changes().
+ */
+
+typedef struct
+{
+    /**
+     *  The number of the pattern that changed, or SEQ64_NULL_SEQUENCE for a
+     *  change to the whole performance, such as the tempo or the screen-set.
+     */
+
+    int cr_seq;
+
+    /**
+     *  The OR of the change_t values posted for cr_seq since the previous
+     *  drain.
+     */
+
+    unsigned cr_changes;
+
+} change_record_t;
+
+/**
+ *  The change records handed out by one drain of a change_queue.
+ */
+
+typedef std::vector<change_record_t> ChangeList;
+
+/**
+ *  The tempo map handed out by perform.  A published map is never changed,
+ *  only replaced, so a holder can keep using it while a new one is built.
+ */
+
+typedef std::shared_ptr<const tempo_map> TempoMap;
+
+/**
+ *  A bounded, lock-free queue of change records for one subscriber.  Any
+ *  thread (GUI, MIDI input, or output) can post() to it, and only the
+ *  subscriber drains it.  Changes are coalesced per pattern:  a pattern's
+ *  slot goes into the ring only when its pending flags go from none to some,
+ *  and the drain clears the flags.  Each slot is therefore in the ring at
+ *  most once, so a ring with room for every slot can never overflow.
+ *
+ *  The ring is Dmitry Vyukov's bounded queue:  each cell carries a turn
+ *  number, which tells the producers and the consumer whether the cell is
+ *  theirs to fill or to empty.
+ */
+
+class change_queue
+{
+
+private:
+
+    /**
+     *  One cell of the ring.
+     */
+
+    typedef struct
+    {
+        std::atomic<std::size_t> cc_turn;   /* position that may use cell   */
+        int cc_slot;                        /* slot number, set by push()   */
+
+    } cell_t;
+
+    /**
+     *  The number of patterns.  Slot m_sequences holds the changes made to
+     *  the performance as a whole.
+     */
+
+    int m_sequences;
+
+    /**
+     *  The change flags not yet drained, one set per slot.
+     */
+
+    std::vector< std::atomic<unsigned> > m_pending;
+
+    /**
+     *  The ring of slot numbers whose flags are pending.  Its size is a
+     *  power of two, so that m_mask can wrap a position into an index.
+     */
+
+    std::vector<cell_t> m_cells;
+
+    /**
+     *  The size of m_cells less one.
+     */
+
+    std::size_t m_mask;
+
+    /**
+     *  The next position to be filled, shared by all producers.
+     */
+
+    std::atomic<std::size_t> m_enqueue_pos;
+
+    /**
+     *  The next position to be emptied, used only by the subscriber.
+     */
+
+    std::size_t m_dequeue_pos;
+
+    /**
+     *  True while the queue belongs to a subscriber, from the start of
+     *  claim() to release().  Claiming takes this flag, so that two
+     *  subscribers cannot get the same queue.
+     */
+
+    std::atomic<bool> m_claimed;
+
+    /**
+     *  True while the queue is ready for changes.  Changes are posted only
+     *  to active queues.  It is set at the end of claim(), after
+     *  m_interests, so that a producer that sees it set also sees the new
+     *  subscriber's interests.
+     */
+
+    std::atomic<bool> m_active;
+
+    /**
+     *  The change_t flags the subscriber wants.  Other changes are not
+     *  posted to this queue at all.
+     */
+
+    std::atomic<unsigned> m_interests;
+
+public:
+
+    change_queue (int sequences);
+
+    /**
+     * \getter m_active
+     * \threadsafe
+     */
+
+    bool active () const
+    {
+        return m_active;
+    }
+
+    bool claim (unsigned interests);
+    void release ();
+    void post (int seq, unsigned changes);
+    int drain (ChangeList & changes);
+
+private:
+
+    bool push (int slot);
+    bool pop (int & slot);
+
+};          // class change_queue
+
 /**
  *  This class supports the performance mode.  It has way too many data
  *  members.  Might be ripe for refactoring.  That has its own dangers, of
@@ -400,6 +578,14 @@ private:
 
     bool m_reposition;
 
+    /**
+     *  Set when the tempo changes during playback, so that the output thread
+     *  cancels the events already scheduled ahead at the old tempo and
+     *  renders them again.  Used only with the [alsa-lookahead] option.
+     */
+
+    bool m_lookahead_reset;
+
     /**
      *  Provides an "acceleration" factor for the fast-forward and rewind
      *  functionality.  It starts out at 1.0, and can range up to 60.0, being
@@ -791,6 +977,46 @@ private:
 
     long m_us_per_quarter_note;
 
+    /**
+     *  The tempo map built from the Set Tempo events of the tempo track.  It
+     *  is accessed only with std::atomic_load() and std::atomic_store(), so
+     *  that the output thread and the JACK callbacks can read it while the
+     *  GUI replaces it.
+     */
+
+    TempoMap m_tempo_map;
+
+    /**
+     *  Set when the tempo track, or the base tempo, has changed since the
+     *  tempo map was built.  The next get_tempo_map() rebuilds it.
+     */
+
+    std::atomic<bool> m_tempo_map_stale;
+
+    /**
+     *  The events, triggers, length, and song-mute status of the tempo track
+     *  when get_tempo_map() last checked them.  Trigger edits and song-mute
+     *  changes are not reported as edits of the pattern, so this is how the
+     *  map finds out that they have changed.  Used only on the user-interface
+     *  side, by get_tempo_map().
+     */
+
+    tempo_layout_t m_tempo_layout;
+
+    /**
+     *  The tempo set by the user (or read from the MIDI file), which is in
+     *  force until the first Set Tempo event of the tempo track.
+     */
+
+    midibpm m_tempo_base_bpm;
+
+    /**
+     *  The tempo-map segment whose tempo follow_tempo_map() applied last, or
+     *  -1 if the tempo is to be applied at the next position.
+     */
+
+    std::atomic<int> m_tempo_segment;
+
     /**
      *  Provides our MIDI buss.  We changed this item to a pointer so that we
      *  can delay the creation of this object until after all settings have
@@ -862,6 +1088,22 @@ private:
 
     mutable midipulse m_tick;
 
+    /**
+     *  The monotonic time, in microseconds, at which m_tick was last set by
+     *  set_tick().  Together with m_tick, it lets arrival_tick() convert the
+     *  arrival time of an incoming MIDI event into a pulse.  Zero until the
+     *  first set_tick().
+     */
+
+    int64_t m_tick_time_us;
+
+    /**
+     *  Protects the m_tick/m_tick_time_us pair, which is written by the
+     *  output thread and read by the input thread.
+     */
+
+    mutex m_tick_mutex;
+
     /**
      *  Let's try to save the last JACK pad structure tick for re-use with
      *  resume after pausing.
@@ -927,6 +1169,38 @@ private:
 
     midi_control m_midi_cc_off[c_midi_controls_extended];
 
+    /**
+     *  Provides the lookup table used by midi_control_event() to find the
+     *  controls bound to an incoming event without checking every control.
+     *  For each status byte, this array holds the number of its block in
+     *  m_midi_control_starts, or -1 if no active control uses that status.
+     */
+
+    short m_midi_control_block[c_midi_control_statuses];
+
+    /**
+     *  Holds, for each block, c_midi_control_statuses + 1 offsets into
+     *  m_midi_control_list.  The controls matching data byte d0 are the
+     *  entries from start[d0] up to (not including) start[d0 + 1].
+     */
+
+    std::vector<unsigned short> m_midi_control_starts;
+
+    /**
+     *  Holds the control numbers found through m_midi_control_starts, in
+     *  ascending order for each (status, d0) pair, so that the controls are
+     *  tried in the same order as the old loop over all of them.
+     */
+
+    std::vector<short> m_midi_control_list;
+
+    /**
+     *  Raised when the MIDI control settings may have changed, so that the
+     *  input thread rebuilds the lookup table before using it again.
+     */
+
+    std::atomic<bool> m_midi_control_dirty;
+
     /**
      *  Holds the OR'ed control status values.  Need to learn more about this
      *  one.  It is used in the replace, snapshot, and queue functionality.
@@ -1022,6 +1296,64 @@ private:
 
     int m_sequence_high;
 
+    /**
+     *  The "play set", the slot numbers of the sequences that play() visits,
+     *  in slot order.  A sequence is dropped from it ("parked") once it
+     *  cannot produce output in the current playback mode, and is put back
+     *  when it is armed, queued, recorded into, or given triggers.  Only the
+     *  output thread changes the list, and it reads it without locking; the
+     *  other threads read it under m_play_set_mutex.
+     */
+
+    int m_play_set[c_max_sequence];
+
+    /**
+     *  The number of slot numbers in m_play_set.
+     */
+
+    int m_play_set_count;
+
+    /**
+     *  The playback mode for which m_play_set was last built, since a
+     *  sequence with triggers is idle only in Live mode.
+     */
+
+    bool m_play_set_mode;
+
+    /**
+     *  Raised by play_set_changed() when a sequence is added, removed, or
+     *  woken, so that the output thread rebuilds m_play_set before the next
+     *  frame.  While raised, the other threads scan all the slots.
+     */
+
+    std::atomic<bool> m_play_set_dirty;
+
+    /**
+     *  Counts the changes that a view of the performance might have to
+     *  redraw:  sequences added or removed, edits and status changes in any
+     *  sequence (see sequence::set_dirty_mp()), screen-set changes, and the
+     *  L/R markers.  Views compare it with the count they last drew, and
+     *  otherwise leave their contents alone.  Unlike the dirty flags, it is
+     *  not reset by reading it, so any number of views can watch it.
+     */
+
+    std::atomic<unsigned long> m_change_count;
+
+    /**
+     *  Serializes the changes made to m_play_set by the output thread with
+     *  the readers in other threads.
+     */
+
+    mutex m_play_set_mutex;
+
+    /**
+     *  The tick at which the next output frame starts.  This is the "last
+     *  tick" of every sequence that is played, and so stands in for the last
+     *  tick of a parked sequence.
+     */
+
+    midipulse m_frame_tick;
+
 #ifdef SEQ64_EDIT_SEQUENCE_HIGHLIGHT
 
     /**
@@ -1111,6 +1443,22 @@ private:
 
     std::vector<performcallback *> m_notify;
 
+    /**
+     *  The change queues of the views that have called subscribe_changes().
+     *  A queue is created the first time its entry is needed, and is reused
+     *  after unsubscribe_changes(), so that posting a change never has to
+     *  lock anything or wait for a queue to be deleted.
+     */
+
+    std::atomic<change_queue *> m_change_queues[SEQ64_CHANGE_SUBSCRIBERS_MAX];
+
+    /**
+     *  The number of entries of m_change_queues that have ever been used,
+     *  so that post_change() looks no further.
+     */
+
+    std::atomic<int> m_change_queue_count;
+
     /**
      *  Support for a wide range of GUI-related operations.
      */
@@ -1141,8 +1489,35 @@ public:
     void modify ()
     {
         m_is_modified = true;
+        notify_change();
+    }
+
+    /**
+     *  Bumps m_change_count, so that the views redraw.
+     *
+     * \threadsafe
+     */
+
+    void notify_change ()
+    {
+        ++m_change_count;
+    }
+
+    /**
+     * \getter m_change_count
+     * \threadsafe
+     */
+
+    unsigned long change_count () const
+    {
+        return m_change_count;
     }
 
+    int subscribe_changes (unsigned interests = CHANGE_ALL);
+    void unsubscribe_changes (int subscriber);
+    int poll_changes (int subscriber, ChangeList & changes);
+    void post_change (int seq, unsigned changes);
+
     /**
      * \getter m_ppqn
      */
@@ -1340,7 +1715,30 @@ public:
     void set_tempo_track_number (int tempotrack)
     {
         if (tempotrack >= 0 && tempotrack < SEQ64_SEQUENCE_MAXIMUM)
+        {
             m_tempo_track_number = tempotrack;
+            m_tempo_map_stale = true;
+        }
+    }
+
+    TempoMap get_tempo_map ();
+    void publish_patterns ();
+
+    /**
+     *  Gets the tempo map as last built, without rebuilding it, for the
+     *  output thread and the JACK callbacks.
+     *
+     * \threadsafe
+     *      std::atomic_load() of a shared_ptr takes a short internal lock in
+     *      libstdc++, but never the tempo track's lock, and never allocates.
+     *
+     * \return
+     *      Returns the current tempo map.
+     */
+
+    TempoMap current_tempo_map () const
+    {
+        return std::atomic_load(&m_tempo_map);
     }
 
     /**
@@ -1799,6 +2197,7 @@ public:
     }
 
     void set_tick (midipulse tick);
+    midipulse arrival_tick (int64_t arrival_us);
 
     /**
      * \getter m_jack_tick
@@ -2657,6 +3056,7 @@ public:         // GUI-support functions
     void playback_mode (bool playbackmode)
     {
         m_playback_mode = playbackmode;
+        play_set_changed();
     }
 
     void set_beats_per_minute (midibpm bpm);    /* more than just a setter  */
@@ -2699,11 +3099,28 @@ private:
     midi_control & midi_control_toggle (int ctl);
     midi_control & midi_control_on (int ctl);
     midi_control & midi_control_off (int ctl);
+    const midi_control & midi_control_toggle (int ctl) const;
+    const midi_control & midi_control_on (int ctl) const;
+    const midi_control & midi_control_off (int ctl) const;
+
+    /**
+     *  Tells midi_control_event() to rebuild its lookup table.  Must be
+     *  called after a batch of MIDI control settings has been changed
+     *  through the non-const accessors above, which do not flag the table
+     *  themselves, so that merely reading a control costs no rebuild.
+     */
+
+    void midi_controls_changed ()
+    {
+        m_midi_control_dirty = true;
+    }
+
     bool midi_control_event (const event & ev);
     bool midi_control_record (const event & ev);
     bool handle_midi_control (int control, bool state);
     bool handle_midi_control_ex (int control, midi_control::action a, int v);
     bool handle_midi_control_event (const event & ev, int ctrl, int offset = 0);
+    void build_midi_control_index ();
     const std::string & get_screenset_notepad (int screenset) const;
     bool any_group_unmutes () const;
     void print_group_unmutes () const;
@@ -2757,11 +3174,33 @@ private:
     void reset_sequences (bool pause = false);
 
     /**
-     *  Plays all notes to the current tick.
+     *  Plays all notes to the current tick, or beyond it by the lookahead.
      */
 
-    void play (midipulse tick);
+    void play (midipulse tick, midipulse lookahead = 0);
     void set_orig_ticks (midipulse tick);
+
+    /**
+     *  Tells the output thread to rebuild the play set before the next
+     *  frame.  Called when sequences are added or removed, and by a parked
+     *  sequence that might now produce output.
+     */
+
+    void play_set_changed ()
+    {
+        m_play_set_dirty = true;
+    }
+
+    /**
+     * \getter m_frame_tick
+     *      The last tick of a parked sequence.
+     */
+
+    midipulse parked_tick () const
+    {
+        return m_frame_tick;
+    }
+
     int max_active_set () const;
 
     /*
@@ -2870,6 +3309,9 @@ private:
     bool is_seq_valid (int seq) const;
     bool is_mseq_valid (int seq) const;
     bool install_sequence (sequence * seq, int seqnum);
+    void rebuild_play_set ();
+    void park_idle_sequences ();
+    int play_set_slots (int * slots);
     void inner_start (bool state);
     void inner_stop (bool midiclock = false);
     int clamp_track (int track) const;
@@ -2920,6 +3362,9 @@ private:
 private:
 
     bool log_current_tempo ();
+    void apply_tempo (midibpm bpm);
+    void rebuild_tempo_map ();
+    void follow_tempo_map (midipulse tick);
     bool create_master_bus ();
 #ifdef USE_STAZED_PARSE_SYSEX               // more code to incorporate!!!
     void parse_sysex (event a_e);           // copy, or reference???
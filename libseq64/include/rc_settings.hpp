@@ -49,6 +49,32 @@
 
 #include "seq64_features.h"             /* SEQ64_USE_ZOOM_POWER_OF_2    */
 
+/**
+ *  Bounds for the [alsa-lookahead] setting, in milliseconds.  A value of 0
+ *  disables lookahead scheduling, so that events are sent directly, as in
+ *  seq24.  Any other value is clamped to this range.
+ */
+
+#define SEQ64_ALSA_LOOKAHEAD_MIN        10
+#define SEQ64_ALSA_LOOKAHEAD_MAX        50
+
+/**
+ *  The default for the [undo-budget] setting, in kilobytes.  This is the
+ *  memory each sequence may spend on its undo and redo records before the
+ *  oldest records are dropped.  A value of 0 means no limit.
+ */
+
+#define SEQ64_UNDO_BUDGET_DEFAULT       1024
+
+/**
+ *  The default for the [sysex-rate] setting, in bytes per second.  This is
+ *  the speed of a MIDI DIN cable, 31250 baud at 10 bits per byte, the rate
+ *  that hardware receiving a SysEx dump can be expected to keep up with.
+ *  A value of 0 sends queued SysEx as fast as the port accepts it.
+ */
+
+#define SEQ64_SYSEX_RATE_DEFAULT        3125
+
 /*
  *  Do not document a namespace; it breaks Doxygen.
  */
@@ -146,6 +172,9 @@ private:
     bool m_filter_by_channel;       /**< Record only sequence channel data. */
     bool m_manual_alsa_ports;       /**< [manual-alsa-ports] setting.       */
     bool m_reveal_alsa_ports;       /**< [reveal-alsa-ports] setting.       */
+    int m_alsa_lookahead_ms;        /**< [alsa-lookahead] setting.          */
+    int m_undo_budget_kb;           /**< [undo-budget] setting.             */
+    int m_sysex_rate;               /**< [sysex-rate] setting.              */
     bool m_print_keys;              /**< Show hot-key in main window slot.  */
     bool m_device_ignore;           /**< From seq24 module, unused!         */
     int m_device_ignore_num;        /**< From seq24 module, unused!         */
@@ -454,6 +483,39 @@ public:
         return m_reveal_alsa_ports;
     }
 
+    /**
+     * \getter m_alsa_lookahead_ms
+     *      If non-zero, ALSA output is scheduled this far ahead on the
+     *      sequencer queue, rather than sent directly.
+     */
+
+    int alsa_lookahead_ms () const
+    {
+        return m_alsa_lookahead_ms;
+    }
+
+    /**
+     * \getter m_undo_budget_kb
+     *      The memory, in kilobytes, that each sequence may spend on undo
+     *      and redo records.  Zero means no limit.
+     */
+
+    int undo_budget_kb () const
+    {
+        return m_undo_budget_kb;
+    }
+
+    /**
+     * \getter m_sysex_rate
+     *      The rate, in bytes per second, at which queued SysEx data is sent
+     *      to each output port.  Zero means no pacing.
+     */
+
+    int sysex_rate () const
+    {
+        return m_sysex_rate;
+    }
+
     /**
      * \getter m_print_keys
      */
@@ -754,6 +816,45 @@ protected:
         m_reveal_alsa_ports = flag;
     }
 
+    /**
+     * \setter m_alsa_lookahead_ms
+     *      Zero (or a negative value) disables the lookahead; other values
+     *      are clamped to the range SEQ64_ALSA_LOOKAHEAD_MIN to
+     *      SEQ64_ALSA_LOOKAHEAD_MAX.
+     */
+
+    void alsa_lookahead_ms (int ms)
+    {
+        if (ms <= 0)
+            m_alsa_lookahead_ms = 0;
+        else if (ms < SEQ64_ALSA_LOOKAHEAD_MIN)
+            m_alsa_lookahead_ms = SEQ64_ALSA_LOOKAHEAD_MIN;
+        else if (ms > SEQ64_ALSA_LOOKAHEAD_MAX)
+            m_alsa_lookahead_ms = SEQ64_ALSA_LOOKAHEAD_MAX;
+        else
+            m_alsa_lookahead_ms = ms;
+    }
+
+    /**
+     * \setter m_undo_budget_kb
+     *      A negative value is treated as 0, no limit.
+     */
+
+    void undo_budget_kb (int kb)
+    {
+        m_undo_budget_kb = kb > 0 ? kb : 0 ;
+    }
+
+    /**
+     * \setter m_sysex_rate
+     *      A negative value is treated as 0, no pacing.
+     */
+
+    void sysex_rate (int bytespersec)
+    {
+        m_sysex_rate = bytespersec > 0 ? bytespersec : 0 ;
+    }
+
     /**
      * \setter m_print_keys
      */
@@ -38,8 +38,11 @@
  *  module, and now just call its member functions to do the actual work.
  */
 
+#include <atomic>                       /* std::atomic<>                */
 #include <string>
-#include <stack>
+#include <deque>                        /* std::deque                   */
+#include <memory>                       /* std::shared_ptr<>            */
+#include <vector>                       /* std::vector                  */
 
 #include "seq64_features.h"             /* various feature #defines     */
 #include "calculations.hpp"             /* measures_to_ticks()          */
@@ -87,6 +90,7 @@ namespace seq64
 {
     class mastermidibus;
     class perform;
+    class tempo_map;
 
 /**
  *  Provides a set of methods for drawing certain items.  These values are
@@ -102,6 +106,85 @@ enum draw_type_t
     DRAW_TEMPO              /**< For drawing tempo meta events.             */
 };
 
+/**
+ *  Describes one note (or tempo event) found by sequence::visit_notes().  The
+ *  values are copied out while the sequence is locked, so that a view can
+ *  draw them at its leisure.
+ */
+
+typedef struct
+{
+    draw_type_t ni_type;        /**< Linked, lone Note On/Off, or tempo.    */
+    midipulse ni_tick_start;    /**< The time-stamp of the event.           */
+    midipulse ni_tick_finish;   /**< End of a linked note or tempo, else 0. */
+    int ni_note;                /**< Note value, or tempo scaled to 0-127.  */
+    int ni_velocity;            /**< Velocity of the note.                  */
+    bool ni_selected;           /**< Selection status of the event.         */
+
+} note_info_t;
+
+/**
+ *  The list filled by sequence::visit_notes().  Each view keeps its own, so
+ *  that views no longer share a draw iterator, and the storage is reused
+ *  from one redraw to the next.
+ */
+
+typedef std::vector<note_info_t> NoteInfoList;
+
+/**
+ *  One horizontal line of a pattern thumbnail, in pixels from the top-left
+ *  corner of the thumbnail.  See sequence::thumbnail().
+ */
+
+typedef struct
+{
+    int tl_x0;                  /**< Start of the line.                     */
+    int tl_x1;                  /**< End of the line, always past tl_x0.    */
+    int tl_y;                   /**< Height of the line.                    */
+    bool tl_tempo;              /**< The line is a tempo, not a note.       */
+
+} thumb_line_t;
+
+/**
+ *  The mini piano roll of a pattern, scaled to a given size, as drawn in the
+ *  pattern slots of the main window.  It is built from a playback snapshot
+ *  and is never modified afterward, so a view can keep it, and draw from
+ *  it, without locking the sequence.
+ */
+
+typedef struct
+{
+    std::vector<thumb_line_t> tn_lines; /**< The notes and tempo lines.     */
+    unsigned long tn_edit_count;        /**< Snapshot edit count used.      */
+    midipulse tn_length;                /**< Snapshot pattern length used.  */
+    int tn_width;                       /**< Width the lines are scaled to. */
+    int tn_height;                      /**< Height the lines are scaled to.*/
+
+} thumbnail_t;
+
+/**
+ *  The reference-counted handle to a thumbnail.  A view can hold on to one
+ *  to tell whether the thumbnail it last drew is still current.
+ */
+
+typedef std::shared_ptr<const thumbnail_t> Thumbnail;
+
+/**
+ *  The state of a pattern that a tempo map built from it depends on:  its
+ *  events, its triggers, its length, and its song-mute status.  The perform
+ *  object saves it when it builds the map from the tempo track, and checks it
+ *  to tell whether the map is stale; see sequence::tempo_layout_changed().
+ */
+
+typedef struct
+{
+    unsigned long tl_edit_count;        /**< Edit count of the events.      */
+    unsigned long tl_trigger_count;     /**< Edit count of the triggers.    */
+    midipulse tl_length;                /**< Length of the pattern.         */
+    bool tl_song_mute;                  /**< Song-mute status.              */
+
+} tempo_layout_t;
+
 /**
  *  Provides two editing modes for a sequence.  A feature adapted from
  *  Kepler34.  Not yet ready for prime time.
@@ -169,11 +252,13 @@ public:
 private:
 
     /**
-     *  Provides a stack of event-lists for use with the undo and redo
-     *  facility.
+     *  Provides a log of edit records for use with the undo and redo
+     *  facility.  Each record holds only the events an edit removed and
+     *  added, not a copy of the whole event list.  A deque lets the oldest
+     *  records be dropped when the undo budget is exceeded.
      */
 
-    typedef std::stack<event_list> EventStack;
+    typedef std::deque<event_list::edit_delta_t> UndoLog;
 
 private:
 
@@ -222,14 +307,14 @@ private:
      */
 
     /**
-     *  Provides a list of event actions to undo for the Stazed LFO and
-     *  seqdata support.  Changed, of course, from std::list<event> to
-     *  the sequence::Events typedef.
-     *
-     *      Events m_events_undo_hold;
+     *  Indicates that an LFO or seqdata drag is under way, and that its
+     *  changes are being recorded as one undo record, from the first change
+     *  to the push_undo(true) at the end of the drag.  This used to be a
+     *  copy of the whole event list, m_events_undo_hold, taken for the
+     *  stazed LFO and seqdata support.
      */
 
-    event_list m_events_undo_hold;
+    bool m_hold_undo;
 
     /**
      *  A stazed flag indicating that we have some undo information.
@@ -246,16 +331,41 @@ private:
     bool m_have_redo;
 
     /**
-     *  Provides a list of event actions to undo.
+     *  Provides a list of event actions to undo, oldest first.
      */
 
-    EventStack m_events_undo;
+    UndoLog m_events_undo;
 
     /**
-     *  Provides a list of event actions to redo.
+     *  Provides a list of event actions to redo, oldest first.
      */
 
-    EventStack m_events_redo;
+    UndoLog m_events_redo;
+
+    /**
+     *  Holds the undo record of the edit in progress.  Once push_undo() has
+     *  set a checkpoint, m_events copies every event it adds or removes,
+     *  and every event changed in place, into this record (see
+     *  event_list::journal()).  The record goes onto the undo log at the
+     *  next checkpoint, or at pop_undo(), because the edit happens after
+     *  the push.
+     */
+
+    event_list::edit_delta_t m_undo_journal;
+
+    /**
+     *  Indicates that push_undo() has set a checkpoint, and that m_events is
+     *  recording into m_undo_journal.
+     */
+
+    bool m_undo_pending;
+
+    /**
+     *  The approximate memory, in bytes, held by the undo and redo records.
+     *  No other undo state is kept.  See rc_settings::undo_budget_kb().
+     */
+
+    size_t m_undo_bytes;
 
     /**
      *  An iterator for drawing events.
@@ -263,6 +373,38 @@ private:
 
     event_list::iterator m_iterator_draw;
 
+    /**
+     *  A time index of the notes, for visit_notes().  It holds the Note Ons,
+     *  plus any unlinked Note Offs, sorted by time-stamp.  Notes that wrap
+     *  around the end of the pattern, and tempo events, go into
+     *  m_note_extras instead, as they do not fit a simple time window.
+     *  Rebuilt by index_notes() when the event list has been edited.
+     */
+
+    std::vector<event *> m_note_index;
+
+    /**
+     *  Wrapped notes and tempo events, checked one by one by visit_notes().
+     */
+
+    std::vector<event *> m_note_extras;
+
+    /**
+     *  The longest linked note in m_note_index.  A note that overlaps the
+     *  start of a time window can start no earlier than this many ticks
+     *  before the window.
+     */
+
+    midipulse m_note_span;
+
+    /**
+     *  The event-list edit count when m_note_index was built.  The index is
+     *  also marked stale by set_dirty(), as some edits move events in place.
+     */
+
+    unsigned long m_note_index_edit_count;
+    bool m_note_index_stale;
+
     /**
      *  A new feature for recording, based on a "stazed" feature.  If true
      *  (not yet the default), then the seqedit window will record only MIDI
@@ -288,10 +430,12 @@ private:
     midibyte m_bus;
 
     /**
-     *  Provides a flag for the song playback mode muting.
+     *  Provides a flag for the song playback mode muting.  It is atomic
+     *  because play() reads it, before deciding whether to lock m_mutex,
+     *  while the user interface sets it.
      */
 
-    bool m_song_mute;
+    std::atomic<bool> m_song_mute;
 
 #ifdef SEQ64_STAZED_TRANSPOSE
 
@@ -335,9 +479,12 @@ private:
 
     /**
      *  True if sequence playback currently is in progress for this sequence.
+     *  It is atomic because play() and play_snapshot() read it without
+     *  m_mutex, while the user interface sets it (under m_mutex) by arming
+     *  or muting the pattern.
      */
 
-    bool m_playing;
+    std::atomic<bool> m_playing;
 
     /**
      *  True if sequence recording currently is in progress for this sequence.
@@ -403,10 +550,11 @@ private:
     /**
      *  Used to keep on blocking Song Mode events while recording new ones.
      *  Allows recording a live performance, by storing the sequence triggers.
-     *  Adapted from Kepler34.
+     *  Adapted from Kepler34.  Atomic, like m_playing, because play() reads
+     *  it before deciding whether to lock m_mutex.
      */
 
-    bool m_song_recording;
+    std::atomic<bool> m_song_recording;
 
     /**
      *  This value indicates that the following feature is active: the number
@@ -458,6 +606,15 @@ private:
     bool m_dirty_perf;          /**< Provides performance dirty flagflag.   */
     bool m_dirty_names;         /**< Provides the names dirtiness flag.     */
 
+    /**
+     *  Counts the calls to set_dirty_mp(), that is, every change that a view
+     *  of the sequence might have to redraw.  Unlike the dirty flags, it is
+     *  not reset when read, so the piano roll, data pane, and time line of an
+     *  editor can all compare it to the count they last drew.
+     */
+
+    std::atomic<unsigned long> m_change_count;
+
     /**
      *  Indicates that the sequence is currently being edited.
      */
@@ -486,6 +643,66 @@ private:
     midipulse m_queued_tick;        /**< Provides the tick for queuing.     */
     midipulse m_trigger_offset;     /**< Provides the trigger offset.       */
 
+    /**
+     *  Set while the output thread has dropped this sequence from the
+     *  perform's play set because it cannot produce output (see
+     *  can_park()).  While parked, play() is not called, so m_last_tick is
+     *  not advanced; last_tick() then gets the value from the parent
+     *  instead.  Any change that could make the sequence play again clears
+     *  this flag or asks the parent to re-check it (see wake()).
+     */
+
+    bool m_parked;
+
+    /**
+     *  Provides a persistent playback cursor for play(), so that each output
+     *  frame resumes at the first event not yet played, instead of scanning
+     *  the event list's playback array from the beginning.  The cursor is
+     *  trusted only if the event list has not been edited (see
+     *  event_list::edit_count()) and the new frame starts exactly where the
+     *  previous frame ended, with the same length and trigger offset.
+     *  Otherwise play() rescans, as in seq24.
+     */
+
+    int m_play_cursor;              /**< Index into playback array.         */
+    midipulse m_play_offset_base;   /**< Loop-wrap offset of the cursor.    */
+    midipulse m_play_next_tick;     /**< Expected start of the next frame.  */
+    midipulse m_play_offset;        /**< Length minus trigger offset used.  */
+    unsigned long m_play_edit_count; /**< Event-list edit count at save.    */
+    bool m_play_cursor_valid;       /**< The cursor can be used next frame. */
+
+    /**
+     *  The playback snapshot of the events (see event_list::compact()) last
+     *  published by publish(), read and written only through
+     *  std::atomic_load() and std::atomic_store().  It is published only on
+     *  the user-interface side (see publish_edits()), never by the output
+     *  or MIDI input threads, and play() always plays from it.  When an
+     *  editor holds m_mutex, play() uses it without taking that lock.  These
+     *  calls are not lock-free (libstdc++ holds an internal mutex just for
+     *  the pointer copy), but they never wait for an edit.  An edit made in
+     *  place must call event_list::touch(), or no new snapshot is published.
+     */
+
+    event_list::PlaybackSnapshot m_snapshot;
+
+    /**
+     *  The thumbnail last built by build_thumbnail(), read and written only
+     *  through std::atomic_load() and std::atomic_store().  It goes stale
+     *  only when a new snapshot is published, which happens for edits, and
+     *  not for changes in the playing, muting, or queuing status.
+     */
+
+    Thumbnail m_thumbnail;
+
+    /**
+     *  The thumbnail size last asked for by thumbnail().  Once known,
+     *  publish_edits() rebuilds the thumbnail, on the GUI timer thread,
+     *  right after publishing an edit.
+     */
+
+    int m_thumb_width;
+    int m_thumb_height;
+
     /**
      *  This constant provides the scaling used to calculate the time position
      *  in ticks (pulses), based also on the PPQN value.  Hardwired to
@@ -643,6 +860,17 @@ private:
 
     mutable mutex m_mutex;
 
+    /**
+     *  Protects the state that play() changes in every frame:  m_last_tick,
+     *  m_playing_notes, and the playback cursor.  It also guards
+     *  m_trigger_offset, which play() reads, so that a frame played without
+     *  m_mutex reads both consistently.  It is held only briefly, so that
+     *  play() can take it even while an editor holds m_mutex.  When
+     *  both are needed, m_mutex must be locked first.
+     */
+
+    mutable mutex m_play_mutex;
+
     /**
      *  Provides the number of ticks to shave off of the end of painted notes.
      *  Also used when the user attempts to shrink a note to zero (or less
@@ -845,12 +1073,12 @@ public:
     void set_hold_undo (bool hold);
 
     /**
-     * \getter m_events_undo_hold.count()
+     * \getter m_hold_undo
      */
 
-    int get_hold_undo () const
+    bool get_hold_undo () const
     {
-        return m_events_undo_hold.count();
+        return m_hold_undo;
     }
 
     /**
@@ -859,7 +1087,7 @@ public:
 
     void set_have_undo ()
     {
-        m_have_undo = m_events_undo.size() > 0;
+        m_have_undo = m_undo_pending || ! m_events_undo.empty();
         if (m_have_undo)                            /* ca 2016-08-16        */
             modify();                               /* have pending changes */
     }
@@ -880,7 +1108,7 @@ public:
 
     void set_have_redo ()
     {
-        m_have_redo = m_events_redo.size() > 0;
+        m_have_redo = ! m_events_redo.empty();
     }
 
     /**
@@ -1016,7 +1244,7 @@ public:
 
     /**
      * \setter m_song_mute
-     *      This function also calls set_dirty_mp() to make sure that the
+     *      This function also calls set_dirty_mute() to make sure that the
      *      perfnames panel is updated to show the new mute status of the
      *      sequence.
      */
@@ -1024,7 +1252,7 @@ public:
     void set_song_mute (bool mute)
     {
         m_song_mute = mute;
-        set_dirty_mp();
+        set_dirty_mute();
     }
 
     /**
@@ -1035,7 +1263,7 @@ public:
     void toggle_song_mute ()
     {
         m_song_mute = ! m_song_mute;
-        set_dirty_mp();
+        set_dirty_mute();
     }
 
     /**
@@ -1175,9 +1403,23 @@ public:
 
     midipulse mod_last_tick ()
     {
-        return (m_length > 1) ? (m_last_tick % m_length) : m_last_tick ;
+        midipulse lt = last_tick();
+        return (m_length > 1) ? (lt % m_length) : lt ;
+    }
+
+    /**
+     * \getter m_parked
+     */
+
+    bool parked () const
+    {
+        return m_parked;
     }
 
+    bool can_park (bool songmode) const;
+    bool park (bool songmode);
+    void unpark (midipulse tick);
+
     /*
      * Documented at the definition point in the cpp module.
      */
@@ -1369,12 +1611,23 @@ public:
 
 #endif  // SEQ64_SONG_RECORDING
 
+    /**
+     * \getter m_change_count
+     * \threadsafe
+     */
+
+    unsigned long change_count () const
+    {
+        return m_change_count;
+    }
+
     bool is_dirty_main ();
     bool is_dirty_edit ();
     bool is_dirty_perf ();
     bool is_dirty_names ();
     void set_dirty_mp ();
     void set_dirty ();
+    void publish_edits ();
 
     /**
      * \getter m_midi_channel
@@ -1631,6 +1884,9 @@ public:
         m_events.link_tempos();
     }
 
+    void fill_tempo_map (tempo_map & tmap) const;
+    bool tempo_layout_changed (tempo_layout_t & layout) const;
+
     /**
      *  Resets everything to zero.  This function is used when the sequencer
      *  stops.  This function currently sets m_last_tick = 0, but we would
@@ -1642,6 +1898,17 @@ public:
         set_last_tick(0);
     }
 
+    /**
+     *  Forces the next call to play() to locate its starting event by
+     *  scanning the event list.
+     */
+
+    void invalidate_play_cursor ()
+    {
+        automutex locker(m_play_mutex);
+        m_play_cursor_valid = false;
+    }
+
     void play_note_on (int note);
     void play_note_off (int note);
     void off_playing_notes ();
@@ -1656,6 +1923,12 @@ public:
         midipulse & tick_s, midipulse & tick_f, int & note,
         bool & selected, int & velocity
     );
+    int visit_notes
+    (
+        midipulse tick_start, midipulse tick_end,
+        int note_lo, int note_hi, NoteInfoList & notes
+    );
+    Thumbnail thumbnail (int width, int height);
     bool get_minmax_note_events (int & lowest, int & highest);
     bool get_next_event (midibyte & status, midibyte & cc);
     bool get_next_event_ex
@@ -1829,7 +2102,20 @@ private:
     ) const;
 
     void set_parent (perform * p);
-    void put_event_on_bus (event & ev);
+    void set_dirty_mute ();
+    void notify_parent (unsigned changes);
+    void publish ();
+    void index_notes ();
+    void build_thumbnail ();
+    void play_snapshot (midipulse tick);
+    void play_events
+    (
+        const event_list::playback_snapshot_t & ps,
+        midipulse start_tick, midipulse end_tick
+    );
+    midipulse last_tick () const;
+    void wake ();
+    void put_event_on_bus (event & ev, midipulse tick = SEQ64_NULL_MIDIPULSE);
 #ifdef SEQ64_STAZED_EXPAND_RECORD
     void reset_loop ();
 #endif
@@ -1839,6 +2125,10 @@ private:
     void remove (event_list::iterator i);
     void remove (event & e);
     void remove_all ();
+    void checkpoint_undo ();
+    void seal_undo ();
+    void clear_redo ();
+    void trim_undo ();
 
     /**
      *  Checks to see if the event's channel matches the sequence's nominal
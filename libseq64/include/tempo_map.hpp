@@ -0,0 +1,208 @@
+#ifndef SEQ64_TEMPO_MAP_HPP
+#define SEQ64_TEMPO_MAP_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempo_map.hpp
+ *
+ *  This module declares/defines the class for converting between pulses and
+ *  time in a song with tempo changes.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-03-17
+ * \updates       2018-03-17
+ * \license       GNU GPLv2 or above
+ *
+ *  The tempo map is built from the Set Tempo events of the tempo track, and
+ *  holds, for each tempo segment, the time at which it starts.  Converting
+ *  a pulse to a time, or a time to a pulse, is then a binary search for the
+ *  segment plus a linear interpolation inside it, no matter how far into
+ *  the song the position is.
+ */
+
+#include <vector>
+
+#include "midibyte.hpp"                 /* seq64::midipulse, midibpm    */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds the tempo segments of a song, in pulse order.  There is always a
+ *  segment starting at pulse 0, which has the base tempo of the song until a
+ *  Set Tempo event at pulse 0 replaces it.  Tempos are in quarter notes per
+ *  minute, as in the Set Tempo event and in the playback of the perform
+ *  object.
+ */
+
+class tempo_map
+{
+
+public:
+
+    /**
+     *  Provides one tempo segment.  The time is kept as a double, so that
+     *  long songs can be converted to and from audio frames without a
+     *  rounding error building up from segment to segment.
+     */
+
+    typedef struct
+    {
+        midipulse te_tick;              /**< The pulse starting the segment.  */
+        midibpm te_bpm;                 /**< The tempo of the segment.        */
+        double te_us;                   /**< Microseconds at te_tick.         */
+        double te_us_per_pulse;         /**< The length of one pulse.         */
+
+    } tempo_entry_t;
+
+private:
+
+    /**
+     *  The segments, sorted by te_tick, the first one at pulse 0.
+     */
+
+    std::vector<tempo_entry_t> m_entries;
+
+    /**
+     *  The PPQN of the song, needed to get the length of a pulse.
+     */
+
+    int m_ppqn;
+
+    /**
+     *  Set once a tempo change at pulse 0 has replaced the base tempo.
+     */
+
+    bool m_start_changed;
+
+public:
+
+    tempo_map (int ppqn, midibpm basebpm);
+
+    void add (midipulse tick, midibpm bpm);
+
+    /**
+     * \getter m_entries.size()
+     *      A count of 1 means that the song has a single tempo.
+     */
+
+    int count () const
+    {
+        return int(m_entries.size());
+    }
+
+    /**
+     * \getter m_ppqn
+     */
+
+    int ppqn () const
+    {
+        return m_ppqn;
+    }
+
+    /**
+     * \getter m_start_changed
+     *      If false, the song starts at the base tempo, which no Set Tempo
+     *      event of the tempo track provides.
+     */
+
+    bool start_changed () const
+    {
+        return m_start_changed;
+    }
+
+    int segment (midipulse tick) const;
+    midibpm segment_bpm (int seg) const;
+
+    /**
+     *  Looks up the tempo in force at the given pulse.
+     *
+     * \param tick
+     *      The pulse to look up.
+     *
+     * \return
+     *      Returns the tempo in quarter notes per minute.
+     */
+
+    midibpm bpm_at (midipulse tick) const
+    {
+        return segment_bpm(segment(tick));
+    }
+
+    double pulses_to_us (double pulses) const;
+    double us_to_pulses (double us) const;
+
+    /**
+     *  Converts a pulse position into audio frames, for JACK.
+     *
+     * \param pulses
+     *      The position, in pulses, which can have a fractional part.
+     *
+     * \param rate
+     *      The frame rate, in frames per second.
+     *
+     * \return
+     *      Returns the number of frames from the start of the song.
+     */
+
+    double pulses_to_frames (double pulses, double rate) const
+    {
+        return pulses_to_us(pulses) * rate / 1000000.0;
+    }
+
+    /**
+     *  Converts an audio frame position into pulses, for JACK.
+     *
+     * \param frames
+     *      The number of frames from the start of the song.
+     *
+     * \param rate
+     *      The frame rate, in frames per second.  Must not be 0.
+     *
+     * \return
+     *      Returns the position in pulses, with the fractional part.
+     */
+
+    double frames_to_pulses (double frames, double rate) const
+    {
+        return us_to_pulses(frames * 1000000.0 / rate);
+    }
+
+private:
+
+    double us_per_pulse (midibpm bpm) const;
+
+};          // class tempo_map
+
+}           // namespace seq64
+
+#endif      // SEQ64_TEMPO_MAP_HPP
+
+/*
+ * tempo_map.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -38,6 +38,7 @@
 #include <string>
 #include <list>
 #include <stack>
+#include <vector>
 
 /**
  *  Indicates that there is no paste-trigger.  This is a new feature from the
@@ -113,7 +114,7 @@ public:
      *      Returns true if m_tick_start is less than rhs's.
      */
 
-    bool operator < (const trigger & rhs)
+    bool operator < (const trigger & rhs) const
     {
         return m_tick_start < rhs.m_tick_start;
     }
@@ -177,7 +178,7 @@ public:
      *      The ending tick.
      */
 
-    bool at_trigger_transition (midipulse s, midipulse e)
+    bool at_trigger_transition (midipulse s, midipulse e) const
     {
         return
         (
@@ -313,12 +314,20 @@ private:
 
     typedef std::list<trigger> List;
 
+    /**
+     *  Provides a contiguous array of triggers, used both for the playback
+     *  index and for the undo/redo snapshots.  Copying one is a single
+     *  allocation, rather than one per trigger as with a List.
+     */
+
+    typedef std::vector<trigger> Vector;
+
     /**
      *  Provides a stack for use with the undo/redo features of the
      *  trigger support.
      */
 
-    typedef std::stack<List> Stack;
+    typedef std::stack<Vector> Stack;
 
 private:
 
@@ -361,10 +370,37 @@ private:
     Stack m_redo_stack;
 
     /**
-     *  An iterator for cycling through the triggers during playback.
+     *  Counts the changes made to the trigger list, so that the playback
+     *  index can tell cheaply whether it is stale.  Every function that can
+     *  change the start, end, or offset of a trigger, or add or remove one,
+     *  bumps this value.
+     */
+
+    unsigned long m_edit_count;
+
+    /**
+     *  Holds a copy of the triggers, sorted by start tick, in a contiguous
+     *  array.  It is rebuilt from m_triggers by compact() when m_edit_count
+     *  has moved on.  Playback and the tick lookups use it instead of
+     *  walking the list.  It is mutable so that the const lookups can
+     *  refresh it.
+     */
+
+    mutable Vector m_index;
+
+    /**
+     *  Holds the value of m_edit_count at the last compaction.
+     */
+
+    mutable unsigned long m_index_edit_count;
+
+    /**
+     *  Remembers where play() left off in m_index:  the first trigger that
+     *  had not yet ended at the last end tick.  As playback moves forward,
+     *  play() only has to step past the triggers that have ended since.
      */
 
-    List::iterator m_iterator_play_trigger;
+    size_t m_play_cursor;
 
     /**
      *  An iterator for cycling through the triggers during drawing.
@@ -445,10 +481,14 @@ public:
 
     /**
      * \getter m_triggers
+     *      This is the non-const version, which counts as an edit, since the
+     *      caller might change the list.  Callers that only read the list
+     *      should use the const version.
      */
 
     List & triggerlist ()
     {
+        ++m_edit_count;                 /* the caller might change it   */
         return m_triggers;
     }
 
@@ -461,6 +501,15 @@ public:
         return int(m_triggers.size());
     }
 
+    /**
+     * \getter m_edit_count
+     */
+
+    unsigned long edit_count () const
+    {
+        return m_edit_count;
+    }
+
     /**
      * \getter m_number_selected
      */
@@ -520,6 +569,7 @@ public:
     {
         m_triggers.clear();
         m_number_selected = 0;
+        ++m_edit_count;
     }
 
     bool next
@@ -554,6 +604,18 @@ private:
     void offset_selected (midipulse tick, grow_edit_t editmode);
 #endif
 
+    /**
+     *  Indicates that the playback index no longer matches the list.
+     */
+
+    bool index_stale () const
+    {
+        return m_index_edit_count != m_edit_count;
+    }
+
+    void compact () const;
+    size_t find_unended (midipulse tick) const;
+    size_t find_started (midipulse tick) const;
     midipulse adjust_offset (midipulse offset);
     void split (trigger & t, midipulse splittick);
     void select (trigger & t, bool count = true);
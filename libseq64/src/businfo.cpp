@@ -233,7 +233,9 @@ businfo::print () const
 
 busarray::busarray ()
  :
-    m_container     ()
+    m_container     (),
+    m_ready_bus     (-1),
+    m_next_bus      (0)
 {
     // Empty body
 }
@@ -442,6 +444,28 @@ busarray::sysex (event * ev)
         bi->sysex(ev);
 }
 
+/**
+ *  Copies the bus pointers of the array, so that the caller can work on the
+ *  busses without holding the lock that protects the array.  The busses
+ *  themselves are deleted only when the array is destroyed.
+ *
+ * \param [out] busses
+ *      Cleared, then filled with the non-null bus pointers.  Its capacity
+ *      is kept, so that a caller reusing it does not allocate each time.
+ */
+
+void
+busarray::get_busses (std::vector<midibus *> & busses)
+{
+    busses.clear();
+    std::vector<businfo>::iterator bi;
+    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    {
+        if (not_nullptr(bi->bus()))
+            busses.push_back(bi->bus());
+    }
+}
+
 /**
  *  Plays an event, if the bus is proper.
  *
@@ -464,6 +488,32 @@ busarray::play (bussbyte bus, event * e24, midibyte channel)
         m_container[bus].bus()->play(e24, channel);
 }
 
+/**
+ *  Schedules an event for the given time, if the bus is proper.
+ *
+ * \param bus
+ *      The MIDI buss on which to play the event.
+ *
+ * \param e24
+ *      A pointer to the event to be played.
+ *
+ * \param channel
+ *      The MIDI channel on which to play the event.
+ *
+ * \param when_us
+ *      The output-queue time, in microseconds, at which the event is due.
+ */
+
+void
+busarray::play_at
+(
+    bussbyte bus, event * e24, midibyte channel, int64_t when_us
+)
+{
+    if (bus < count() && m_container[bus].active())
+        m_container[bus].bus()->play_at(e24, channel, when_us);
+}
+
 /**
  *  Sets the clock type for the given bus, usually the output buss.
  *  This code is a bit more restrictive than the original code in
@@ -745,6 +795,12 @@ busarray::is_system_port (bussbyte bus)
  *  poll, which exits when some data is obtained.  It also applies only to the
  *  input busses.
  *
+ *  The busses are checked round-robin, starting after the bus that supplied
+ *  the last event, and the first bus found with data is remembered for
+ *  get_midi_event().  Polling the busses does not block; waiting for input
+ *  on all of them at once is up to the caller (see
+ *  midi_jack_info::api_poll_for_midi()).
+ *
  * \return
  *      Returns true if a MIDI event was detected on one of the busses.  Note
  *      that this is a boolean value, while the midibase::poll_for_midi()
@@ -754,20 +810,29 @@ busarray::is_system_port (bussbyte bus)
 bool
 busarray::poll_for_midi ()
 {
-    std::vector<businfo>::iterator bi;
-    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    int busses = count();
+    if (m_next_bus >= busses)
+        m_next_bus = 0;
+
+    for (int i = 0; i < busses; ++i)
     {
-        if (bi->bus()->poll_for_midi() > 0)
+        int b = (m_next_bus + i) % busses;
+        if (m_container[b].bus()->poll_for_midi() > 0)
+        {
+            m_ready_bus = b;
             return true;
+        }
     }
+    m_ready_bus = -1;
     return false;
 }
 
 /**
- *  Gets the first MIDI event in finds on an input bus.
- *
- *  Note that this function risks starving the second input device if more
- *  than one is enabled in Sequencer64.  We will figure that one out later.
+ *  Gets the next MIDI event from the input busses.  It starts with the bus
+ *  that poll_for_midi() found to be ready, if any, and otherwise goes
+ *  round-robin from the bus after the one that supplied the last event.
+ *  This spreads the input handling fairly over the busses, so that a busy
+ *  device no longer starves a second input device.
  *
  * \param inev
  *      A pointer to the event to be modified by incoming data, if any.
@@ -779,11 +844,22 @@ busarray::poll_for_midi ()
 bool
 busarray::get_midi_event (event * inev)
 {
-    std::vector<businfo>::iterator bi;
-    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    int busses = count();
+    int start = m_ready_bus >= 0 && m_ready_bus < busses ?
+        m_ready_bus : m_next_bus ;
+
+    m_ready_bus = -1;
+    if (start >= busses)
+        start = 0;
+
+    for (int i = 0; i < busses; ++i)
     {
-        if (bi->bus()->get_midi_event(inev))
+        int b = (start + i) % busses;
+        if (m_container[b].bus()->get_midi_event(inev))
+        {
+            m_next_bus = (b + 1) % busses;
             return true;
+        }
     }
     return false;
 }
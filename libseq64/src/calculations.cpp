@@ -78,6 +78,7 @@
 #include "app_limits.h"
 #include "calculations.hpp"
 #include "settings.hpp"
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
 
 #if ! defined PI
 #define PI     3.14159265359
@@ -396,6 +397,57 @@ std::string
 pulses_to_timestring (midipulse p, midibpm bpm, int ppqn, bool showus)
 {
     unsigned long microseconds = ticks_to_delta_time_us(p, bpm, ppqn);
+    return microseconds_to_timestring(microseconds, showus);
+}
+
+/**
+ *  Converts a MIDI pulse/ticks/clock value into a string that represents
+ *  "hours:minutes:seconds.fraction", following the tempo changes of the
+ *  song.  See the other pulses_to_timestring() overloads.
+ *
+ * \param p
+ *      Provides the number of ticks, pulses, or divisions in the MIDI
+ *      event time.
+ *
+ * \param tmap
+ *      Provides the tempo map of the song.
+ *
+ * \param showus
+ *      If true (the default), shows the microseconds as well.
+ *
+ * \return
+ *      Returns the time-string representation of the pulse (ticks) value.
+ */
+
+std::string
+pulses_to_timestring (midipulse p, const tempo_map & tmap, bool showus)
+{
+    double us = tmap.pulses_to_us(double(p));
+    return microseconds_to_timestring
+    (
+        us > 0.0 ? (unsigned long)(us) : 0UL, showus
+    );
+}
+
+/**
+ *  Converts a time in microseconds into a string that represents
+ *  "hours:minutes:seconds.fraction".  If the fraction part is 0, or is not
+ *  wanted, then it is not shown.  This is the formatting common to the
+ *  pulses_to_timestring() overloads.
+ *
+ * \param microseconds
+ *      Provides the time to show.
+ *
+ * \param showus
+ *      If true, shows the microseconds as well.
+ *
+ * \return
+ *      Returns the time-string representation of the time.
+ */
+
+std::string
+microseconds_to_timestring (unsigned long microseconds, bool showus)
+{
     int seconds = int(microseconds / 1000000UL);
     int minutes = seconds / 60;
     int hours = seconds / (60 * 60);
@@ -32,7 +32,8 @@
  */
 
 #include <iostream>
-#include <string.h>                     /* strncmp() function needed!   */
+#include <sstream>                      /* std::ostringstream           */
+#include <sys/stat.h>                   /* stat()                       */
 
 #include "easy_macros.h"
 #include "configfile.hpp"
@@ -54,6 +55,13 @@ namespace seq64
 configfile::configfile (const std::string & name)
  :
     m_error_message (),
+    m_lines         (),
+    m_sections      (),
+    m_line_index    (0),
+    m_at_eof        (true),
+    m_final_newline (true),
+    m_file_mtime    (0),
+    m_file_size     (-1),
     m_name          (name),
     m_d             (nullptr),
     m_line          ()          /* array of characters              */
@@ -62,17 +70,115 @@ configfile::configfile (const std::string & name)
 }
 
 /**
- *  Gets the next line of data from an input stream.  If the line starts with
+ *  Reads the whole configuration file in one pass, splits it into lines,
+ *  and indexes the line of every section marker (a line starting with
+ *  "["), keyed by the text up to and including the closing bracket.
+ *  After this call, line_after() and next_data_line() work from memory.
+ *
+ *  If the file was already loaded, and its modification time and size are
+ *  unchanged, the existing lines and index are reused.
+ *
+ * \return
+ *      Returns true if the file could be opened and read.
+ */
+
+bool
+configfile::load_file ()
+{
+    struct stat st;
+    bool result = stat(m_name.c_str(), &st) == 0;
+    if (result)
+    {
+        bool unchanged =
+            long(st.st_mtime) == m_file_mtime && long(st.st_size) == m_file_size;
+
+        if (! unchanged)
+        {
+            std::ifstream file(m_name.c_str(), std::ios::in | std::ios::binary);
+            result = file.is_open();
+            if (result)
+            {
+                std::ostringstream text;
+                text << file.rdbuf();
+
+                const std::string & data = text.str();
+                m_lines.clear();
+                m_sections.clear();
+                std::string::size_type start = 0;
+                while (start < data.length())
+                {
+                    std::string::size_type nl = data.find('\n', start);
+                    if (nl == std::string::npos)
+                        nl = data.length();
+
+                    m_lines.push_back(data.substr(start, nl - start));
+                    start = nl + 1;
+                }
+                m_final_newline = data.empty() || data[data.length()-1] == '\n';
+                for (int i = 0; i < int(m_lines.size()); ++i)
+                {
+                    const std::string & line = m_lines[i];
+                    if (! line.empty() && line[0] == '[')
+                    {
+                        std::string::size_type rb = line.find(']');
+                        std::string tag = rb == std::string::npos ?
+                            line : line.substr(0, rb + 1);
+
+                        if (m_sections.find(tag) == m_sections.end())
+                            m_sections[tag] = i;
+                    }
+                }
+                m_file_mtime = long(st.st_mtime);
+                m_file_size = long(st.st_size);
+            }
+        }
+    }
+    m_line_index = 0;
+    m_at_eof = m_lines.empty();
+    m_line[0] = 0;
+    return result;
+}
+
+/**
+ *  Copies the next line of the loaded file into m_line, truncating it to
+ *  fit, and advances the line index.  This is the in-memory equivalent of
+ *  std::getline() on the file.
+ *
+ * \return
+ *      Returns true if a line was available.  If not, m_line is empty and
+ *      m_at_eof is set.
+ */
+
+bool
+configfile::get_line ()
+{
+    bool result = m_line_index < int(m_lines.size());
+    if (result)
+    {
+        const std::string & line = m_lines[m_line_index++];
+        size_t len = line.length();
+        if (len >= sizeof m_line)
+            len = sizeof m_line - 1;
+
+        line.copy(m_line, len);
+        m_line[len] = 0;
+        m_at_eof = m_line_index == int(m_lines.size()) && ! m_final_newline;
+    }
+    else
+    {
+        m_line[0] = 0;
+        m_at_eof = true;
+    }
+    return result;
+}
+
+/**
+ *  Gets the next line of data from the loaded file.  If the line starts with
  *  a number-sign, a space (!), or a null, it is skipped, to try the next
  *  line.  This occurs until an EOF is encountered.
  *
  *  Member m_line is a "global" return value.
  *
- * \param file
- *      Points to an input stream.  We converted this item to a reference;
- *      pointers can be subject to problems.  For example, what if someone
- *      passes a null pointer?
- *
  * \return
  *      Returns true if a presumed data line was found.  False is returned if
  *      not found before an EOF or a section marker ("[") is found.  This is a
@@ -81,23 +187,23 @@ configfile::configfile (const std::string & name)
  */
 
 bool
-configfile::next_data_line (std::ifstream & file)
+configfile::next_data_line ()
 {
     bool result = true;
     char ch;
-    file.getline(m_line, sizeof m_line);
+    (void) get_line();
     ch = m_line[0];
-    while ((ch == '#' || /*ch == ' ' ||*/ ch == '[' || ch == 0) && ! file.eof())
+    while ((ch == '#' || /*ch == ' ' ||*/ ch == '[' || ch == 0) && ! m_at_eof)
     {
         if (m_line[0] == '[')
         {
             result = false;
             break;
         }
-        file.getline(m_line, sizeof m_line);
+        (void) get_line();
         ch = m_line[0];
     }
-    if (file.eof())
+    if (m_at_eof)
         result = false;
 
     return result;
@@ -107,13 +213,12 @@ configfile::next_data_line (std::ifstream & file)
  *  This function gets a specific line of text, specified as a tag.
  *  Then it gets the next non-blank line (i.e. data line) after that.
  *
- *  This function always starts from the beginning of the file.  Therefore,
- *  it can handle reading Sequencer64 configuration files that have had
- *  their tagged sections arranged in a different order.  This feature makes
- *  the configuration file a little more robust against errors.
- *
- * \param file
- *      Points to the input file stream.
+ *  Section tags are looked up in the index built by load_file(), so the
+ *  sections can appear in any order without the file being rescanned for
+ *  each one.  Therefore, it can handle reading Sequencer64 configuration
+ *  files that have had their tagged sections arranged in a different
+ *  order.  A tag that is not a complete "[section]" marker falls back to a
+ *  scan from the first line, matching the start of each line as before.
  *
  * \param tag
  *      Provides a tag to be found.  Lines are read until a match occurs
@@ -125,29 +230,36 @@ configfile::next_data_line (std::ifstream & file)
  */
 
 bool
-configfile::line_after (std::ifstream & file, const std::string & tag)
+configfile::line_after (const std::string & tag)
 {
     bool result = false;
-    file.clear();
-    file.seekg(0, std::ios::beg);
-    file.getline(m_line, sizeof m_line);
-    while (file.good())                 /* includes the EOF check           */
+    SectionIndex::const_iterator si = m_sections.find(tag);
+    if (si != m_sections.end())
     {
-        result = strncmp(m_line, tag.c_str(), tag.length()) == 0;
-        if (result)
-            break;
-        else
+        m_line_index = si->second + 1;  /* the data follows the tag line    */
+        result = true;
+    }
+    else if (! tag.empty() && tag[tag.length()-1] != ']')
+    {
+        for (int i = 0; i < int(m_lines.size()); ++i)
         {
-            if (file.bad())
+            const std::string & line = m_lines[i];
+            result = line.compare(0, tag.length(), tag) == 0;
+            if (result)
             {
-                errprint("bad file stream reading config file");
+                m_line_index = i + 1;
+                break;
             }
-            else
-                file.getline(m_line, sizeof m_line);
         }
     }
     if (result)
-        result = next_data_line(file);
+        result = next_data_line();
+    else
+    {
+        m_line_index = int(m_lines.size());
+        m_line[0] = 0;
+        m_at_eof = true;
+    }
 
     return result;
 }
@@ -39,6 +39,7 @@
  */
 
 #include <stdio.h>                      /* C::printf()                  */
+#include <algorithm>                    /* std::sort(), lower_bound()   */
 
 #include "easy_macros.h"
 #include "event_list.hpp"
@@ -50,6 +51,20 @@
 namespace seq64
 {
 
+/**
+ *  Provides the number of keys used by the note linker:  128 notes for each
+ *  of the 16 channels, plus 128 notes for events without a channel.
+ */
+
+static const int c_link_key_count = 17 * 128;
+
+/**
+ *  The number of note events that may be appended (see append()) before the
+ *  next call to link_appended() falls back to a full link_new() pass.
+ */
+
+static const size_t c_link_appended_max = 1024;
+
 /**
  *  Principal event_key constructor.
  *
@@ -121,13 +136,21 @@ event_list::event_list ()
     m_events                (),
     m_is_modified           (false),
     m_has_tempo             (false),
-    m_has_time_signature    (false)
+    m_has_time_signature    (false),
+    m_edit_count            (0),
+    m_playback              (),
+    m_journal               (nullptr),
+    m_link_pending          (),
+    m_link_appended         (),
+    m_link_valid            (false)
 {
     // No code needed
 }
 
 /**
- *  Copy constructor.
+ *  Copy constructor.  The playback snapshot is not shared, since its edit
+ *  count belongs to \a rhs.  It is compacted on demand.  The undo journal
+ *  is not shared either.
  *
  * \param rhs
  *      Provides the event list to be copied.
@@ -138,14 +161,23 @@ event_list::event_list (const event_list & rhs)
     m_events                (rhs.m_events),
     m_is_modified           (rhs.m_is_modified),
     m_has_tempo             (rhs.m_has_tempo),
-    m_has_time_signature    (rhs.m_has_time_signature)
+    m_has_time_signature    (rhs.m_has_time_signature),
+    m_edit_count            (0),
+    m_playback              (),
+    m_journal               (nullptr),
+    m_link_pending          (),
+    m_link_appended         (),
+    m_link_valid            (false)
 {
     // No code needed
 }
 
 /**
  *  Principal assignment operator.  Follows the stock rules for such an
- *  operator, just assigning member values.
+ *  operator, just assigning member values.  The edit count is not copied;
+ *  it is bumped, since all of our iterators are now invalid.  The undo
+ *  journal is kept, and records the old events as removed and the new ones
+ *  as added.
  *
  * \param rhs
  *      Provides the event list to be assigned.
@@ -156,10 +188,14 @@ event_list::operator = (const event_list & rhs)
 {
     if (this != &rhs)
     {
+        journal_removed_all();
+        journal_added_all(rhs);
         m_events                = rhs.m_events;
         m_is_modified           = rhs.m_is_modified;
         m_has_tempo             = rhs.m_has_tempo;
         m_has_time_signature    = rhs.m_has_time_signature;
+        ++m_edit_count;
+        unlink_state();
     }
     return *this;
 }
@@ -244,15 +280,29 @@ event_list::append (const event & e)
     EventsPair p = std::make_pair<event_key, event>(key, e);
 #endif
 
-    m_events.insert(p);                 /* std::multimap operation  */
+    Events::iterator ai = m_events.insert(p);   /* std::multimap op     */
+    event * added = &ai->second;
 
 #else   // SEQ64_USE_EVENT_MAP
 
     m_events.push_front(e);             /* std::list operation      */
+    event * added = &m_events.front();
 
 #endif
 
+    if (not_nullptr(m_journal))
+        m_journal->ed_added.push_back(e);
+
+    if (m_link_valid && (added->is_note_on() || added->is_note_off()))
+    {
+        if (m_link_appended.size() < c_link_appended_max)
+            m_link_appended.push_back(added);
+        else
+            unlink_state();
+    }
+
     m_is_modified = true;
+    ++m_edit_count;
     if (e.is_tempo())
         m_has_tempo = true;
 
@@ -308,7 +358,10 @@ event_list::merge (event_list & el, bool /*presort*/ )
 {
     int initialsize = count();
     int addedsize = el.count();
+    journal_added_all(el);
     m_events.insert(el.events().begin(), el.events().end());
+    ++m_edit_count;
+    unlink_state();
     if (count() != (initialsize + addedsize))
     {
         char tmp[64];
@@ -329,70 +382,544 @@ event_list::merge (event_list & el, bool presort)
     if (presort)
         el.sort();                          // el.m_events.sort();
 
+    journal_added_all(el);
     m_events.merge(el.m_events);
+    ++m_edit_count;
+    unlink_state();
+    el.unlink_state();
+    ++el.m_edit_count;
 }
 
 #endif  // SEQ64_USE_EVENT_MAP
 
 /**
- *  Links a new event.  This function checks for a note on, then look for
- *  its note off.  This function is provided in the event_list because it
- *  does not depend on any external data.  Also note that any desired
- *  thread-safety must be provided by the caller.
+ *  Copies all the events of another list into the undo journal, if one is
+ *  set, as added events.  Used by merge() and the assignment operator.
+ *
+ * \param el
+ *      Provides the events about to be added.
  */
 
 void
-event_list::link_new ()
+event_list::journal_added_all (const event_list & el)
 {
-    bool endfound = false;
-    for (Events::iterator on = m_events.begin(); on != m_events.end(); ++on)
+    if (not_nullptr(m_journal))
     {
-        event & eon = dref(on);
-        if (eon.is_note_on() && ! eon.is_linked())  /* note on, unlinked?   */
+        const Events & events = el.m_events;
+        for (const_iterator i = events.begin(); i != events.end(); ++i)
+            m_journal->ed_added.push_back(dref(i));
+    }
+}
+
+/**
+ *  Copies all the events of this list into the undo journal, if one is
+ *  set, as removed events.  Used by clear() and the assignment operator.
+ */
+
+void
+event_list::journal_removed_all ()
+{
+    if (not_nullptr(m_journal))
+    {
+        for (const_iterator i = m_events.begin(); i != m_events.end(); ++i)
+            m_journal->ed_removed.push_back(dref(i));
+    }
+}
+
+/**
+ *  Builds a new playback snapshot from the editing container.  The editing
+ *  container acts as an overlay of pending edits; each edit bumps the edit
+ *  count, and this function folds all of them into a fresh contiguous array
+ *  in one O(n log n) pass.  It is called by sequence::publish_edits() on the
+ *  user-interface side, never by the output or MIDI input threads.
+ *
+ *  The events are copied, so that the snapshot does not depend on the
+ *  editing container, and a reader holding it can ignore later edits.  The
+ *  links of the copies are cleared, so that nothing in the snapshot points
+ *  into the container.  The previous snapshot is not touched; it is freed
+ *  when its last reader lets it go.
+ *
+ *  The link index of each record is resolved by looking up the linked
+ *  event's address (in the editing container) in a table of (address,
+ *  index) pairs sorted by address.
+ *
+ *  Each compaction copies the whole list, so it costs O(n) in the size of
+ *  the pattern, however small the edit.  The edits are not merged into the
+ *  previous snapshot incrementally; instead, several edits made between
+ *  two compactions are folded in by the one pass.
+ *
+ * \threadunsafe
+ *      The caller must hold the lock that protects the event list.
+ *
+ * \param length
+ *      The length of the pattern, saved with the snapshot.
+ */
+
+void
+event_list::compact (midipulse length)
+{
+    typedef std::pair<const event *, int> AddressIndex;
+    std::shared_ptr<playback_snapshot_t> ps =
+        std::make_shared<playback_snapshot_t>();
+
+    std::vector<const event *> sources;
+    bool haslinks = false;
+    ps->ps_events.reserve(m_events.size());
+    sources.reserve(m_events.size());
+    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
+    {
+        const event & e = dref(i);
+        ps->ps_events.push_back(e);
+        sources.push_back(&e);
+        if (e.is_linked())
+            haslinks = true;
+    }
+    ps->ps_records.reserve(ps->ps_events.size());
+    for (int i = 0; i < int(ps->ps_events.size()); ++i)
+    {
+        event & e = ps->ps_events[i];
+        playback_record_t r;
+        r.pr_timestamp = e.get_timestamp();
+        r.pr_event = &e;
+        r.pr_link = -1;
+        r.pr_status = e.get_status();
+        r.pr_channel = e.get_channel();
+        e.get_data(r.pr_d0, r.pr_d1);
+        e.clear_link();                 /* never point into m_events    */
+        ps->ps_records.push_back(r);
+    }
+    if (haslinks)
+    {
+        std::vector<AddressIndex> addresses;
+        addresses.reserve(sources.size());
+        for (int i = 0; i < int(sources.size()); ++i)
+            addresses.push_back(AddressIndex(sources[i], i));
+
+        std::sort(addresses.begin(), addresses.end());
+        for (int i = 0; i < int(sources.size()); ++i)
         {
-            Events::iterator off = on;              /* point to note on     */
-            ++off;                                  /* get next element     */
-            endfound = false;
-            while (off != m_events.end())
+            const event * linked = sources[i]->get_linked();
+            if (not_nullptr(linked))
             {
-                event & eoff = dref(off);
-                if                  /* off event, == notes, and not linked  */
+                std::vector<AddressIndex>::const_iterator ai = std::lower_bound
                 (
-                    eoff.is_note_off() &&
-                    eoff.get_note() == eoff.get_note() && ! eoff.is_linked()
-                )
-                {
-                    eon.link(&eoff);                /* link backward        */
-                    eoff.link(&eon);                /* link forward         */
-                    endfound = true;                /* note on fulfilled    */
-                    break;
-                }
-                ++off;
+                    addresses.begin(), addresses.end(), AddressIndex(linked, -1)
+                );
+                if (ai != addresses.end() && ai->first == linked)
+                    ps->ps_records[i].pr_link = ai->second;
             }
-            if (! endfound)
+        }
+    }
+    ps->ps_edit_count = m_edit_count;
+    ps->ps_length = length;
+    m_playback = ps;
+}
+
+/**
+ *  Orders two events by content:  time-stamp, rank, status, channel, data
+ *  bytes, and finally the sysex/meta payload.  Unlike event::operator <(),
+ *  this is a total ordering of the MIDI content, so that two events compare
+ *  equal only if they are the same event as far as undo is concerned.  The
+ *  editing flags (selected, marked, painted) and the links are ignored.
+ *
+ * \return
+ *      Returns true if e1 orders before e2.
+ */
+
+static bool
+event_content_less (const event & e1, const event & e2)
+{
+    if (e1.get_timestamp() != e2.get_timestamp())
+        return e1.get_timestamp() < e2.get_timestamp();
+
+    if (e1.get_rank() != e2.get_rank())
+        return e1.get_rank() < e2.get_rank();
+
+    if (e1.get_status() != e2.get_status())
+        return e1.get_status() < e2.get_status();
+
+    if (e1.get_channel() != e2.get_channel())
+        return e1.get_channel() < e2.get_channel();
+
+    midibyte a0, a1, b0, b1;
+    e1.get_data(a0, a1);
+    e2.get_data(b0, b1);
+    if (a0 != b0)
+        return a0 < b0;
+
+    if (a1 != b1)
+        return a1 < b1;
+
+    return e1.get_sysex() < e2.get_sysex();
+}
+
+/**
+ *  Compares two event pointers by content, for std::sort() and
+ *  std::lower_bound() in apply().
+ */
+
+static bool
+event_pointer_less (const event * e1, const event * e2)
+{
+    return event_content_less(*e1, *e2);
+}
+
+/**
+ *  Tidies an undo record once its edit is over.  An event that the edit
+ *  added and then removed again (or changed in place more than once) shows
+ *  up in both halves of the record; such pairs are dropped, matched by
+ *  content, one for one.  What is left are the events that were in the list
+ *  before the edit and are gone, and the events that are new, which is what
+ *  apply() needs.  Both halves are sorted by content and walked once in
+ *  step, like a merge, so the cost depends on the size of the edit, not the
+ *  size of the pattern.
+ *
+ * \param [in,out] delta
+ *      Provides the record to tidy.
+ */
+
+void
+event_list::cancel_common (edit_delta_t & delta)
+{
+    if (delta.ed_removed.empty() || delta.ed_added.empty())
+        return;
+
+    std::sort
+    (
+        delta.ed_removed.begin(), delta.ed_removed.end(), event_content_less
+    );
+    std::sort
+    (
+        delta.ed_added.begin(), delta.ed_added.end(), event_content_less
+    );
+
+    std::vector<event> removed;
+    std::vector<event> added;
+    size_t r = 0;
+    size_t a = 0;
+    while (r < delta.ed_removed.size() && a < delta.ed_added.size())
+    {
+        const event & re = delta.ed_removed[r];
+        const event & ae = delta.ed_added[a];
+        if (event_content_less(re, ae))
+        {
+            removed.push_back(re);
+            ++r;
+        }
+        else if (event_content_less(ae, re))
+        {
+            added.push_back(ae);
+            ++a;
+        }
+        else
+        {
+            ++r;                            /* added, then removed again    */
+            ++a;
+        }
+    }
+    removed.insert
+    (
+        removed.end(), delta.ed_removed.begin() + r, delta.ed_removed.end()
+    );
+    added.insert
+    (
+        added.end(), delta.ed_added.begin() + a, delta.ed_added.end()
+    );
+    delta.ed_removed.swap(removed);
+    delta.ed_added.swap(added);
+}
+
+/**
+ *  Applies an undo record to this event list.  Going forward (redo), the
+ *  record's removed events are taken out and its added events are put in;
+ *  going in reverse (undo), the roles are swapped.  The events to take out
+ *  are sorted by content, and the list is walked once, looking each event
+ *  up among them by binary search; duplicates are matched one for one.
+ *  The new events are then sorted by themselves and merged into the list
+ *  in one pass, so the cost depends on the size of the record and of the
+ *  list, and the whole list is never sorted again.  The links are not
+ *  restored; the caller must call verify_and_link() afterward, as it always
+ *  has after an undo or redo.
+ *
+ * \threadunsafe
+ *      The caller must hold the lock that protects the event list, and must
+ *      not have a journal set, or the undo would record itself.
+ *
+ * \param delta
+ *      Provides the record to apply.
+ *
+ * \param reverse
+ *      If true, the record is undone rather than redone.
+ */
+
+void
+event_list::apply (const edit_delta_t & delta, bool reverse)
+{
+    const std::vector<event> & outgoing =
+        reverse ? delta.ed_added : delta.ed_removed ;
+
+    const std::vector<event> & incoming =
+        reverse ? delta.ed_removed : delta.ed_added ;
+
+    if (! outgoing.empty())
+    {
+        std::vector<const event *> targets;
+        targets.reserve(outgoing.size());
+        for (size_t t = 0; t < outgoing.size(); ++t)
+            targets.push_back(&outgoing[t]);
+
+        std::sort(targets.begin(), targets.end(), event_pointer_less);
+
+        std::vector<bool> taken(targets.size(), false);
+        size_t remaining = targets.size();
+        Events::iterator i = m_events.begin();
+        while (i != m_events.end() && remaining > 0)
+        {
+            const event * e = &dref(i);
+            std::vector<const event *>::iterator ti = std::lower_bound
+            (
+                targets.begin(), targets.end(), e, event_pointer_less
+            );
+            size_t t = size_t(ti - targets.begin());
+            while
+            (
+                t < targets.size() && taken[t] &&
+                ! event_content_less(*e, *targets[t])
+            )
             {
-                off = m_events.begin();
-                while (off != on)
-                {
-                    event & eoff = dref(off);
-                    if              /* off event, == notes, and not linked  */
-                    (
-                        eoff.is_note_off() &&
-                        eoff.get_note() == eon.get_note() && ! eoff.is_linked()
-                    )
-                    {
-                        eon.link(&eoff);            /* link backward        */
-                        eoff.link(&eon);            /* link forward         */
-                        endfound = true;            /* note on fulfilled    */
-                        break;
-                    }
-                    ++off;
-                }
+                ++t;                        /* duplicate already matched    */
             }
+
+            Events::iterator next = i;
+            ++next;
+            if (t < targets.size() && ! event_content_less(*e, *targets[t]))
+            {
+                taken[t] = true;
+                --remaining;
+                m_events.erase(i);
+            }
+            i = next;
+        }
+        m_is_modified = true;
+        ++m_edit_count;
+        unlink_state();
+    }
+    if (! incoming.empty())
+    {
+#ifdef SEQ64_USE_EVENT_MAP
+        for (size_t n = 0; n < incoming.size(); ++n)
+            (void) append(incoming[n]);         /* insertion keeps order    */
+#else
+        Events added(incoming.begin(), incoming.end());
+        added.sort();
+        m_events.merge(added);
+        for (size_t n = 0; n < incoming.size(); ++n)
+        {
+            if (incoming[n].is_tempo())
+                m_has_tempo = true;
+
+            if (incoming[n].is_time_signature())
+                m_has_time_signature = true;
         }
+        m_is_modified = true;
+        ++m_edit_count;
+        unlink_state();
+#endif
     }
 }
 
+/**
+ *  Estimates the memory held by an undo record, for enforcing the undo
+ *  budget of a sequence.  Counts the event objects and their sysex payloads,
+ *  but not the allocator overhead.
+ *
+ * \param delta
+ *      Provides the record to measure.
+ *
+ * \return
+ *      Returns the approximate size of the record in bytes.
+ */
+
+size_t
+event_list::delta_bytes (const edit_delta_t & delta)
+{
+    size_t result = sizeof(edit_delta_t);
+    result += (delta.ed_removed.size() + delta.ed_added.size()) * sizeof(event);
+    for (size_t n = 0; n < delta.ed_removed.size(); ++n)
+        result += delta.ed_removed[n].get_sysex().size();
+
+    for (size_t n = 0; n < delta.ed_added.size(); ++n)
+        result += delta.ed_added[n].get_sysex().size();
+
+    return result;
+}
+
+/**
+ *  Calculates the key used to pair Note Ons with Note Offs:  the note number
+ *  and the channel of the event.
+ *
+ * \param e
+ *      Provides the Note On or Note Off event.
+ *
+ * \return
+ *      Returns a value from 0 to c_link_key_count - 1.
+ */
+
+int
+event_list::link_key (const event & e)
+{
+    midibyte channel = e.get_channel();
+    int c = channel == EVENT_NULL_CHANNEL ? 16 : int(channel & 0x0F) ;
+    return c * 128 + int(e.get_note() & 0x7F);
+}
+
+/**
+ *  Links the unlinked Note Ons with Note Offs of the same note and channel,
+ *  in a single pass over the list.  Each key has a first-in, first-out queue
+ *  of pending Note Ons, so that each Note On gets the first free Note Off
+ *  after it, as with the old search.  A Note Off that arrives with no pending
+ *  Note On is queued as an orphan; at the end, Note Ons still pending are
+ *  paired with the orphans, which come earlier in the list.  That covers a
+ *  note that wraps around the end of the pattern.  The queues are linked
+ *  lists threaded through one array of nodes, so the cost is O(n) plus
+ *  clearing the key tables.
+ *
+ *  The events still unlinked afterward are saved for link_appended().
+ *
+ * \threadunsafe
+ *      The caller must hold the lock that protects the event list.
+ */
+
+void
+event_list::link_new ()
+{
+    std::vector<event *> nodes;
+    std::vector<int> next;
+    std::vector<int> on_head(c_link_key_count, -1);
+    std::vector<int> on_tail(c_link_key_count, -1);
+    std::vector<int> off_head(c_link_key_count, -1);
+    std::vector<int> off_tail(c_link_key_count, -1);
+    bool linked = false;
+    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
+    {
+        event & e = dref(i);
+        if (e.is_linked())
+            continue;
+
+        bool ison = e.is_note_on();
+        if (! ison && ! e.is_note_off())
+            continue;
+
+        int key = link_key(e);
+        if (! ison && on_head[key] >= 0)        /* a Note On is waiting     */
+        {
+            event * eon = nodes[on_head[key]];
+            on_head[key] = next[on_head[key]];
+            eon->link(&e);                      /* link backward            */
+            e.link(eon);                        /* link forward             */
+            linked = true;
+            continue;
+        }
+
+        std::vector<int> & head = ison ? on_head : off_head ;
+        std::vector<int> & tail = ison ? on_tail : off_tail ;
+        int n = int(nodes.size());
+        nodes.push_back(&e);
+        next.push_back(-1);
+        if (head[key] < 0)
+            head[key] = n;
+        else
+            next[tail[key]] = n;
+
+        tail[key] = n;
+    }
+    m_link_pending.clear();
+    for (int key = 0; key < c_link_key_count; ++key)
+    {
+        int on = on_head[key];
+        int off = off_head[key];
+        while (on >= 0 && off >= 0)             /* wrap around to the start */
+        {
+            nodes[on]->link(nodes[off]);
+            nodes[off]->link(nodes[on]);
+            linked = true;
+            on = next[on];
+            off = next[off];
+        }
+        for ( ; on >= 0; on = next[on])
+            m_link_pending.push_back(nodes[on]);
+
+        for ( ; off >= 0; off = next[off])
+            m_link_pending.push_back(nodes[off]);
+    }
+    m_link_appended.clear();
+    m_link_valid = true;
+    if (linked)
+        ++m_edit_count;                         /* playback links stale     */
+}
+
+/**
+ *  Links only the Note Ons and Note Offs added by append() since the last
+ *  call to link_new() or to this function.  Each new event is paired with
+ *  the first unlinked event of the opposite kind, same note and channel,
+ *  left over from before; otherwise it is left waiting for a partner.
+ *  This is meant for recording, where a few events are added at a time to
+ *  a large pattern, and it does no pass over the list.  If the list has
+ *  been changed in any other way since the last full link (for example, an
+ *  event was removed), this function falls back to link_new().
+ *
+ * \threadunsafe
+ *      The caller must hold the lock that protects the event list.
+ */
+
+void
+event_list::link_appended ()
+{
+    if (! m_link_valid)
+    {
+        link_new();
+        return;
+    }
+
+    bool linked = false;
+    for (size_t a = 0; a < m_link_appended.size(); ++a)
+    {
+        event * e = m_link_appended[a];
+        if (e->is_linked())
+            continue;
+
+        bool ison = e->is_note_on();
+        int key = link_key(*e);
+        std::vector<event *>::iterator p = m_link_pending.begin();
+        while (p != m_link_pending.end())
+        {
+            event * partner = *p;
+            if (partner->is_linked())
+            {
+                p = m_link_pending.erase(p);    /* linked some other way    */
+                continue;
+            }
+            bool match = ison ? partner->is_note_off() : partner->is_note_on() ;
+            if (match && link_key(*partner) == key)
+                break;
+
+            ++p;
+        }
+        if (p != m_link_pending.end())
+        {
+            (*p)->link(e);
+            e->link(*p);
+            m_link_pending.erase(p);
+            linked = true;
+        }
+        else
+            m_link_pending.push_back(e);
+    }
+    m_link_appended.clear();
+    if (linked)
+        ++m_edit_count;                         /* playback links stale     */
+}
+
 /**
  *  This function verifies state: all note-ons have an off, and it links
  *  note-offs with their note-ons.
@@ -415,69 +942,7 @@ void
 event_list::verify_and_link (midipulse slength)
 {
     clear_links();
-    for (event_list::iterator on = m_events.begin(); on != m_events.end(); ++on)
-    {
-        event & eon = dref(on);
-        if (eon.is_note_on())               /* Note On, find its Note Off   */
-        {
-            event_list::iterator off = on;  /* next possible Note Off...    */
-            ++off;                          /* ...starting here             */
-            bool endfound = false;
-            while (off != m_events.end())
-            {
-                event & eoff = dref(off);
-                if                          /* Off, == notes, not marked    */
-                (
-                    eoff.is_note_off() &&
-                    eoff.get_note() == eon.get_note() && ! eoff.is_marked()
-                )
-                {
-                    /*
-                     * THINK ABOUT IT:  If we're in legacy merge mode for a
-                     * loop, the Note Off is actually earlier than the Note
-                     * On.  And in replace mode, the Note On is cleared,
-                     * leaving us with a dangling Note Off event.
-                     *
-                     * We should consider, in both modes, automatically adding
-                     * the Note Off at the end of the loop and ignoring the
-                     * next note off on the same note from the keyboard.
-                     *
-                     * Careful!
-                     */
-
-                    eon.link(&eoff);                    /* link + mark */
-                    eoff.link(&eon);
-                    eon.mark();
-                    eoff.mark();
-                    endfound = true;
-                    break;
-                }
-                ++off;
-            }
-            if (! endfound)
-            {
-                off = m_events.begin();
-                while (off != on)
-                {
-                    event & eoff = dref(off);
-                    if
-                    (
-                        eoff.is_note_off() &&
-                        eoff.get_note() == eon.get_note() && ! eoff.is_marked()
-                    )
-                    {
-                        eon.link(&eoff);                /* link + mark */
-                        eoff.link(&eon);
-                        eon.mark();
-                        eoff.mark();
-                        endfound = true;
-                        break;
-                    }
-                    ++off;
-                }
-            }
-        }
-    }
+    link_new();
     unmark_all();
     mark_out_of_range(slength);
     remove_marked();                        /* prune out-of-range events    */
@@ -491,12 +956,15 @@ event_list::verify_and_link (midipulse slength)
 }
 
 /**
- *  Clears all event links and unmarks them all.
+ *  Clears all event links and unmarks them all.  Since the link indices of
+ *  the playback array are now wrong, the edit count is bumped.
  */
 
 void
 event_list::clear_links ()
 {
+    ++m_edit_count;
+    unlink_state();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = dref(i);
@@ -547,6 +1015,7 @@ event_list::scan_meta_events ()
 void
 event_list::link_tempos ()
 {
+    ++m_edit_count;
     clear_tempo_links();
     for (event_list::iterator t = m_events.begin(); t != m_events.end(); ++t)
     {
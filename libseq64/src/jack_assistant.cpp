@@ -225,7 +225,7 @@ jack_transport_callback (jack_nframes_t nframes, void * arg)
                     {
                         s_old_bpm = pos.beats_per_minute;
                         infoprintf("BPM = %f\n", pos.beats_per_minute);
-                        j->parent().set_beats_per_minute(pos.beats_per_minute);
+                        j->parent().apply_tempo(pos.beats_per_minute);
                     }
                 }
             }
@@ -1059,17 +1059,24 @@ jack_assistant::position (bool songmode, midipulse tick)
     {
         if (is_null_midipulse(tick))
             tick = 0;
-        else
-            tick *= 10;
     }
     else
         tick = 0;
 
-    int ticks_per_beat = m_ppqn * 10;
-    int beats_per_minute = parent().get_beats_per_minute();
-    uint64_t tick_rate = (uint64_t(m_jack_frame_rate) * tick * 60.0);
-    long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
-    uint64_t jack_frame = tick_rate / tpb_bpm;
+    /*
+     * The frame comes from the tempo map, so that locating is right even
+     * after tempo changes in the song.  The map counts the tempo in quarter
+     * notes, as perform's clock does.  This replaces the old calculation at
+     * the current tempo, which scaled it by 4 / m_beat_width, and so did
+     * not agree with our own playback when the beat width is not 4.  (It
+     * also used ten JACK ticks per pulse, but that factor cancelled out.)
+     */
+
+    TempoMap tmap = parent().current_tempo_map();
+    uint64_t jack_frame = uint64_t
+    (
+        tmap->pulses_to_frames(double(tick), double(m_jack_frame_rate))
+    );
     if (m_jack_master)
     {
         /*
@@ -1221,8 +1228,9 @@ jack_assistant::sync (jack_transport_state_t state)
     else
         result = 1;
 
-    m_jack_tick = m_jack_frame_current * m_jack_pos.ticks_per_beat *
-        m_jack_pos.beats_per_minute / (rate * 60.0) ;
+    TempoMap tmap = parent().current_tempo_map();
+    m_jack_tick = tmap->frames_to_pulses(double(m_jack_frame_current), rate) /
+        tick_multiplier();
 
     m_jack_frame_last = m_jack_frame_current;
     m_jack_transport_state_last = m_jack_transport_state = state;
@@ -1447,6 +1455,8 @@ jack_assistant::output (jack_scratchpad & pad)
         m_jack_pos.beat_type = m_beat_width;
         m_jack_pos.ticks_per_beat = m_ppqn * 10;
         m_jack_pos.beats_per_minute = parent().get_beats_per_minute();
+
+        TempoMap tmap = parent().current_tempo_map();
         if
         (
             m_jack_transport_state_last == JackTransportStarting &&
@@ -1464,12 +1474,13 @@ jack_assistant::output (jack_scratchpad & pad)
             pad.js_dumping = true;
 
             /*
-             * Here, Seq32 uses the tempo map if in song mode, instead of
-             * making these calculations.
+             * Like Seq32, we use the tempo map to get the tick.
              */
 
-            m_jack_tick = m_jack_pos.frame * m_jack_pos.ticks_per_beat *
-                m_jack_pos.beats_per_minute / (m_jack_pos.frame_rate * 60.0);
+            m_jack_tick = tmap->frames_to_pulses
+            (
+                double(m_jack_pos.frame), double(m_jack_pos.frame_rate)
+            ) / tick_multiplier();
 
             jack_ticks_converted = m_jack_tick * tick_multiplier();
 
@@ -1524,14 +1535,18 @@ jack_assistant::output (jack_scratchpad & pad)
             if (m_jack_frame_current > m_jack_frame_last)   /* moving ahead? */
             {
                 /*
-                 * Seq32 uses tempo map if in song mode here, instead.
+                 * The tick is taken from the frame with the tempo map, not
+                 * accumulated at the current tempo, so that it does not
+                 * drift when the tempo changes.
                  */
 
                 if (m_jack_pos.frame_rate > 1000)           /* usually 48000 */
                 {
-                    m_jack_tick += (m_jack_frame_current - m_jack_frame_last) *
-                        m_jack_pos.ticks_per_beat * m_jack_pos.beats_per_minute /
-                        (m_jack_pos.frame_rate * 60.0);
+                    m_jack_tick = tmap->frames_to_pulses
+                    (
+                        double(m_jack_frame_current),
+                        double(m_jack_pos.frame_rate)
+                    ) / tick_multiplier();
                 }
                 else
                     info_message("jack_assistant::output() 2: zero frame rate");
@@ -1857,16 +1872,43 @@ jack_timebase_callback
     long ticks_per_minute = long(pos->beats_per_minute * pos->ticks_per_beat);
     double framerate = double(pos->frame_rate * 60.0);
 
+    /*
+     * With tempo changes, the BBT is always computed from the frame, with
+     * the tempo map, since accumulating it at the current tempo would drift
+     * at each change.  The map is not rebuilt here, in the process thread.
+     *
+     * Both branches count the tempo in quarter notes per minute, like the
+     * tempo map and the MIDI Set Tempo event, and a JACK beat is one
+     * beat_type note, so a quarter note is beat_type / 4 JACK beats.  This
+     * is the convention of tick_multiplier(), so the BBT does not jump when
+     * we switch from one branch to the other.
+     */
+
+    TempoMap tmap = jack->parent().current_tempo_map();
+
     /**
      * \todo
      *      Shouldn't we process the first clause ONLY if new_pos is true?
      */
 
-    if (new_pos || ! (pos->valid & JackPositionBBT))    // try the NEW code
+    if (new_pos || ! (pos->valid & JackPositionBBT) || tmap->count() > 1)
     {
-        double minute = pos->frame / framerate;
-        long abs_tick = long(minute * ticks_per_minute);
+        long abs_tick = 0;
         long abs_beat = 0;
+        if (pos->frame_rate > 0)
+        {
+            double pulses = tmap->frames_to_pulses
+            (
+                double(pos->frame), double(pos->frame_rate)
+            );
+            abs_tick = long
+            (
+                pulses * pos->ticks_per_beat * pos->beat_type /
+                    (4.0 * jack->get_ppqn())
+            );
+            if (tmap->count() > 1)
+                pos->beats_per_minute = tmap->bpm_at(midipulse(pulses));
+        }
 
         /*
          *  Handle 0 values of pos->ticks_per_beat and pos->beats_per_bar that
@@ -1894,7 +1936,10 @@ jack_timebase_callback
          * when the latter is JACK Master!  Note that the tick is delta'ed.
          */
 
-        int delta_tick = int(nframes * ticks_per_minute / framerate);
+        int delta_tick = int
+        (
+            nframes * ticks_per_minute * pos->beat_type / (4.0 * framerate)
+        );
         pos->tick += delta_tick;
         while (pos->tick >= pos->ticks_per_beat)
         {
@@ -1946,8 +1991,9 @@ jack_shutdown_callback (void * arg)
 }
 
 /**
- *  This function gets the current JACK position.  The Seq32 version also uses
- *  its tempo map to adjust this, but Sequencer64 currently does not.
+ *  This function gets the current JACK position.  Like the Seq32 version, it
+ *  uses the tempo map to convert the frame to a tick.  It is called in the
+ *  process thread, so the map is not rebuilt here.
  *
  * \warning
  *      Currently valgrind flags j->client() as uninitialized.
@@ -1964,17 +2010,14 @@ long
 get_current_jack_position (void * arg)
 {
     jack_assistant * j = (jack_assistant *)(arg);
-    double ppqn = double(j->get_ppqn());
-    double ticks_per_beat = ppqn * 10;              // 192 * 10 = 1920
-    double beats_per_minute = j->get_beats_per_measure();
-    double beat_type = j->get_beat_width();
-    if (not_nullptr(j->client()))
+    if (not_nullptr(j->client()) && j->jack_frame_rate() > 0)
     {
         jack_nframes_t frame = jack_get_current_transport_frame(j->client());
-        double jack_tick = frame * ticks_per_beat * beats_per_minute /
-            (j->jack_frame_rate() * 60.0);              // need research
-
-        return jack_tick * (ppqn / (ticks_per_beat * beat_type / 4.0));
+        TempoMap tmap = j->parent().current_tempo_map();
+        return long
+        (
+            tmap->frames_to_pulses(double(frame), double(j->jack_frame_rate()))
+        );
     }
     else
     {
@@ -79,7 +79,18 @@ mastermidibase::mastermidibase
     m_vector_sequence   (),             /* stazed feature                   */
     m_filter_by_channel (false),        /* set based on configuration       */
     m_seq               (nullptr),
-    m_mutex             ()
+    m_anchor_tick       (-1),           /* no lookahead scheduling yet      */
+    m_anchor_us         (0),
+    m_lookahead_us      (0),
+    m_play_count        (0),
+    m_flush_count       (0),
+    m_mutex             (),
+    m_sysex_thread      (),
+    m_sysex_thread_launched (false),
+    m_sysex_stop        (false),
+    m_sysex_pending     (false),
+    m_sysex_cond        (),
+    m_sysex_busses      ()
 {
     // Empty body now
 }
@@ -99,6 +110,7 @@ mastermidibase::mastermidibase
 
 mastermidibase::~mastermidibase ()
 {
+    stop_sysex_thread();
     if (not_nullptr(m_bus_announce))
     {
         delete m_bus_announce;
@@ -172,6 +184,7 @@ void
 mastermidibase::stop ()
 {
     automutex locker(m_mutex);
+    m_anchor_tick = -1;                 /* play_at() now plays directly     */
     m_outbus_array.stop();
     api_stop();
 }
@@ -248,6 +261,7 @@ mastermidibase::flush ()
 {
     automutex locker(m_mutex);
     api_flush();
+    ++m_flush_count;
 }
 
 /**
@@ -275,10 +289,11 @@ mastermidibase::panic ()
 }
 
 /**
- *  Handle the sending of SYSEX events.  The event is sent to all MIDI output
- *  busses.  Then flush() is called.
- *
- *  There's currently no implementation-specific API function for this call.
+ *  Handle the sending of SYSEX events.  The event is queued on all MIDI
+ *  output busses, and the SysEx thread, launched on first use, is woken to
+ *  send it.  This function returns without waiting for any of it to be
+ *  sent, so that the caller (normally the input thread) is not held up by a
+ *  long dump.
  *
  * \threadsafe
  *
@@ -291,7 +306,93 @@ mastermidibase::sysex (event * ev)
 {
     automutex locker(m_mutex);
     m_outbus_array.sysex(ev);
-    flush();                /* recursive locking! */
+    m_sysex_cond.lock();
+    if (! m_sysex_thread_launched && ! m_sysex_stop)
+    {
+        int err = pthread_create(&m_sysex_thread, NULL, sysex_thread_func, this);
+        if (err == 0)
+        {
+            m_sysex_thread_launched = true;
+        }
+        else
+        {
+            errprint("could not launch the SysEx thread");
+        }
+    }
+    m_sysex_pending = true;
+    m_sysex_cond.signal();
+    m_sysex_cond.unlock();
+}
+
+/**
+ *  Stops the SysEx thread, if it is running, and waits for it to exit.  Any
+ *  SysEx data still queued is not sent.  This must be called before the
+ *  busses are torn down; perform calls it, and the destructor calls it
+ *  again, harmlessly, in case the derived class has not already closed the
+ *  MIDI API.
+ */
+
+void
+mastermidibase::stop_sysex_thread ()
+{
+    m_sysex_cond.lock();
+    m_sysex_stop = true;
+    m_sysex_cond.signal();
+    m_sysex_cond.unlock();
+    if (m_sysex_thread_launched)
+    {
+        pthread_join(m_sysex_thread, NULL);
+        m_sysex_thread_launched = false;
+    }
+}
+
+/**
+ *  The body of the SysEx thread.  It hands each output bus the chance to
+ *  send its next piece of queued SysEx data, then sleeps until the earliest
+ *  bus is due again.  When nothing is queued, it waits on m_sysex_cond
+ *  until sysex() signals it.
+ *
+ *  The master lock is held only to copy the list of busses, not while the
+ *  data is sent, so that play() on the other busses never waits for SysEx.
+ *  Each piece is sent under its bus's own lock, so play() on that bus waits
+ *  for one piece at most.  The bus pointers stay valid, since the busses
+ *  are deleted only after this thread has been stopped.
+ */
+
+void
+mastermidibase::sysex_func ()
+{
+    for (;;)
+    {
+        {
+            automutex locker(m_mutex);
+            m_outbus_array.get_busses(m_sysex_busses);
+        }
+
+        long wait_us = -1;
+        int64_t now_us = monotonic_us();
+        int rate = rc().sysex_rate();
+        std::vector<midibus *>::iterator bi;
+        for (bi = m_sysex_busses.begin(); bi != m_sysex_busses.end(); ++bi)
+        {
+            long wait = (*bi)->send_sysex(now_us, rate);
+            if (wait >= 0 && (wait_us < 0 || wait < wait_us))
+                wait_us = wait;
+        }
+        m_sysex_cond.lock();
+        if (m_sysex_stop)
+        {
+            m_sysex_cond.unlock();
+            break;
+        }
+        if (wait_us < 0 && ! m_sysex_pending)
+            m_sysex_cond.wait();                /* nothing queued anywhere  */
+
+        m_sysex_pending = false;
+        m_sysex_cond.unlock();
+        if (wait_us > 0)
+            millisleep((unsigned long)(wait_us + 999) / 1000);
+    }
 }
 
 /**
@@ -319,6 +420,116 @@ mastermidibase::play (bussbyte bus, event * e24, midibyte channel)
 {
     automutex locker(m_mutex);
     m_outbus_array.play(bus, e24, channel);
+    ++m_play_count;
+}
+
+/**
+ *  Plays an event that is due at the given tick.  If the output thread has
+ *  anchored lookahead scheduling (see set_schedule_anchor()), the tick is
+ *  converted to an output-queue time relative to the anchor, and the event
+ *  is queued for that time.  Otherwise the event is played immediately, just
+ *  as play() does.
+ *
+ *  The time is clamped to the window from the anchor to the lookahead, so
+ *  that a stale tick can neither go into the past nor leave an event waiting
+ *  long after playback has moved on.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The buss to play on.
+ *
+ * \param e24
+ *      The seq24 event to play on the buss.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param tick
+ *      The absolute tick at which the event is due.
+ */
+
+void
+mastermidibase::play_at
+(
+    bussbyte bus, event * e24, midibyte channel, midipulse tick
+)
+{
+    automutex locker(m_mutex);
+    if (m_anchor_tick < 0)
+    {
+        m_outbus_array.play(bus, e24, channel);
+    }
+    else
+    {
+        long offset = long
+        (
+            ticks_to_delta_time_us
+            (
+                tick - m_anchor_tick, m_beats_per_minute, m_ppqn
+            )
+        );
+        if (offset < 0)
+            offset = 0;
+        else if (offset > m_lookahead_us)
+            offset = m_lookahead_us;
+
+        m_outbus_array.play_at(bus, e24, channel, m_anchor_us + offset);
+    }
+    ++m_play_count;
+}
+
+/**
+ *  Ties the given tick to the current time of the output queue, so that
+ *  play_at() can convert ticks into queue times.  The output thread calls
+ *  this once per pass, just before it renders the patterns up to the
+ *  lookahead.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      The tick that the playback has reached now.
+ *
+ * \param lookaheadms
+ *      The lookahead, in milliseconds.  If 0, or if the API has no queue to
+ *      schedule on, the anchor is cleared and events are sent directly.
+ *
+ * \return
+ *      Returns true if events will be scheduled ahead.
+ */
+
+bool
+mastermidibase::set_schedule_anchor (midipulse tick, int lookaheadms)
+{
+    automutex locker(m_mutex);
+    int64_t now = lookaheadms > 0 ? api_queue_time_us() : -1 ;
+    if (now >= 0)
+    {
+        m_anchor_tick = tick;
+        m_anchor_us = now;
+        m_lookahead_us = long(lookaheadms) * 1000;
+    }
+    else
+        m_anchor_tick = -1;
+
+    return m_anchor_tick >= 0;
+}
+
+/**
+ *  Removes the scheduled-but-undelivered pattern events from the output
+ *  queue, and clears the anchor, so that anything played before the next
+ *  set_schedule_anchor() goes out directly.  Used on stop, reposition, and
+ *  tempo change.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::cancel_scheduled ()
+{
+    automutex locker(m_mutex);
+    m_anchor_tick = -1;
+    api_cancel_scheduled();
 }
 
 /**
@@ -809,6 +1020,26 @@ mastermidibase::dump_midi_input (event ev)
     }
 }
 
+/**
+ *  The SysEx thread function, launched by mastermidibase::sysex().  It runs
+ *  at normal priority; the pacing of SysEx data does not need real-time
+ *  scheduling, and should not compete with the output thread.
+ *
+ * \param mmb
+ *      Provides the mastermidibase object whose sysex_func() is run.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+sysex_thread_func (void * mmb)
+{
+    mastermidibase * m = (mastermidibase *) mmb;
+    m->sysex_func();
+    return nullptr;
+}
+
 }           // namespace seq64
 
 /*
@@ -75,6 +75,8 @@ midi_container::midi_container (sequence & seq)
 void
 midi_container::add_variable (midipulse v)
 {
+    midibyte bytes[8];                          /* varinum, MSB first       */
+    int count = 0;
     midipulse buffer = v & 0x7F;                /* mask off a no-sign byte  */
     while (v >>= 7)                             /* shift right 7 bits, test */
     {
@@ -83,12 +85,13 @@ midi_container::add_variable (midipulse v)
     }
     for (;;)
     {
-        put(midibyte(buffer) & 0xFF);           /* add the LSB              */
+        bytes[count++] = midibyte(buffer) & 0xFF;   /* add the LSB          */
         if (buffer & 0x80)                      /* if bit 7 set             */
             buffer >>= 8;                       /* get next MSB             */
         else
             break;
     }
+    put_bytes(bytes, count);
 }
 
 /**
@@ -107,10 +110,12 @@ midi_container::add_variable (midipulse v)
 void
 midi_container::add_long (midipulse x)
 {
-    put((x & 0xFF000000) >> 24);
-    put((x & 0x00FF0000) >> 16);
-    put((x & 0x0000FF00) >> 8);
-    put((x & 0x000000FF));
+    midibyte bytes[4];
+    bytes[0] = midibyte((x & 0xFF000000) >> 24);
+    bytes[1] = midibyte((x & 0x00FF0000) >> 16);
+    bytes[2] = midibyte((x & 0x0000FF00) >> 8);
+    bytes[3] = midibyte((x & 0x000000FF));
+    put_bytes(bytes, 4);
 }
 
 /**
@@ -123,8 +128,10 @@ midi_container::add_long (midipulse x)
 void
 midi_container::add_short (midishort x)
 {
-    put((x & 0x0000FF00) >> 8);
-    put((x & 0x000000FF));
+    midibyte bytes[2];
+    bytes[0] = midibyte((x & 0x0000FF00) >> 8);
+    bytes[1] = midibyte((x & 0x000000FF));
+    put_bytes(bytes, 2);
 }
 
 /**
@@ -160,11 +167,13 @@ midi_container::add_event (const event & e, midipulse deltatime)
         midibyte d1 = e.data(1);
         midibyte channel = m_sequence.get_midi_channel();
         midibyte st = e.get_status();
+        midibyte bytes[3];
+        int count = 1;
         add_variable(deltatime);                    /* encode delta_time    */
         if (channel == EVENT_NULL_CHANNEL)
-            put(st | e.get_channel());              /* channel from event   */
+            bytes[0] = st | e.get_channel();        /* channel from event   */
         else
-            put(st | channel);                      /* the sequence channel */
+            bytes[0] = st | channel;                /* the sequence channel */
 
         switch (st & EVENT_CLEAR_CHAN_MASK)                     /* 0xF0 */
         {
@@ -173,18 +182,19 @@ midi_container::add_event (const event & e, midipulse deltatime)
         case EVENT_AFTERTOUCH:                                  /* 0xA0 */
         case EVENT_CONTROL_CHANGE:                              /* 0xB0 */
         case EVENT_PITCH_WHEEL:                                 /* 0xE0 */
-            put(d0);
-            put(d1);
+            bytes[count++] = d0;
+            bytes[count++] = d1;
             break;
 
         case EVENT_PROGRAM_CHANGE:                              /* 0xC0 */
         case EVENT_CHANNEL_PRESSURE:                            /* 0xD0 */
-            put(d0);
+            bytes[count++] = d0;
             break;
 
         default:
             break;
         }
+        put_bytes(bytes, count);
     }
 }
 
@@ -209,8 +219,8 @@ midi_container::add_ex_event (const event & e, midipulse deltatime)
 
     int count = e.get_sysex_size();             /* applies for meta, too    */
     put(count);
-    for (int i = 0; i < count; ++i)
-        put(e.get_sysex()[i]);
+    if (count > 0)
+        put_bytes(&e.get_sysex()[0], count);   /* the whole data block     */
 }
 
 /**
@@ -267,8 +277,8 @@ midi_container::fill_seq_name (const std::string & name)
         len = SEQ64_MAX_DATA_VALUE;
 
     put(midibyte(len));                             /* length of name   */
-    for (int i = 0; i < len; ++i)
-        put(midibyte(name[i]));
+    if (len > 0)
+        put_bytes(reinterpret_cast<const midibyte *>(name.data()), len);
 }
 
 /*
@@ -287,6 +297,29 @@ midi_container::fill_meta_track_end (midipulse deltatime)
     put(0x00);
 }
 
+/**
+ *  Fills in a Set Tempo event at the start of the track, for the song export
+ *  when the tempo map of the song starts with the base tempo rather than a
+ *  Set Tempo event of the tempo track.  See midifile::write_song().
+ *
+ * \param bpm
+ *      The tempo to write, in quarter notes per minute.
+ */
+
+void
+midi_container::fill_start_tempo (midibpm bpm)
+{
+    midibyte t[4];                              /* hold tempo bytes */
+    tempo_us_to_bytes(t, int(tempo_us_from_bpm(bpm)));
+    add_variable(0);                            /* delta time       */
+    put(0xFF);                                  /* meta event       */
+    put(0x51);                                  /* tempo event      */
+    put(0x03);                                  /* data length      */
+    put(t[0]);
+    put(t[1]);
+    put(t[2]);
+}
+
 #ifdef USE_FILL_TIME_SIG_AND_TEMPO
 
 /**
@@ -775,7 +808,8 @@ midi_container::fill (int track, const perform & p, bool doseqspec)
          * to only track 0?  No; seq24 saves these events with each sequence.
          */
 
-        triggers::List & triggerlist = m_sequence.triggerlist();
+        const sequence & seq = m_sequence;          /* read-only access */
+        const triggers::List & triggerlist = seq.triggerlist();
         int triggercount = int(triggerlist.size());
         add_variable(0);
         put(0xFF);
@@ -784,7 +818,7 @@ midi_container::fill (int track, const perform & p, bool doseqspec)
         add_long(c_triggers_new);                       /* ...the triggers code */
         for
         (
-            triggers::List::iterator ti = triggerlist.begin();
+            triggers::List::const_iterator ti = triggerlist.begin();
             ti != triggerlist.end(); ++ti
         )
         {
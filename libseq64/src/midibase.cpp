@@ -55,6 +55,7 @@
 #ifdef PLATFORM_WINDOWS
 #include <windows.h>                    /* Sleep()                          */
 #else
+#include <time.h>                       /* clock_gettime()                  */
 #include <unistd.h>                     /* usleep() or select()             */
 #endif
 
@@ -176,7 +177,11 @@ midibase::midibase
     m_is_virtual_port   (makevirtual),
     m_is_input_port     (isinput),
     m_is_system_port    (makesystem),
-    m_mutex             ()
+    m_mutex             (),
+    m_sysex_queue       (),
+    m_sysex_sent        (0),
+    m_sysex_due_us      (0),
+    m_sysex_mutex       ()
 {
     if (! makevirtual)
     {
@@ -583,8 +588,34 @@ midibase::play (event * e24, midibyte channel)
 }
 
 /**
- *  Takes a native SYSEX event, encodes it to an ALSA event, and then
- *  puts it in the queue.
+ *  Like play(), but hands the event to the output queue to be delivered at
+ *  the given time, rather than immediately.  Implementations without a
+ *  scheduling queue simply play the event now.
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param when_us
+ *      The real time of the output queue, in microseconds, at which the event
+ *      is to be delivered.
+ */
+
+void
+midibase::play_at (event * e24, midibyte channel, int64_t when_us)
+{
+    automutex locker(m_mutex);
+    api_play_at(e24, channel, when_us);
+}
+
+/**
+ *  Queues a copy of the data of a SysEx event for sending on this bus, and
+ *  returns at once.  The data is sent later, at the configured rate, by
+ *  send_sysex().
  *
  * \param e24
  *      The event to be handled.
@@ -593,8 +624,78 @@ midibase::play (event * e24, midibyte channel)
 void
 midibase::sysex (event * e24)
 {
-    automutex locker(m_mutex);
-    api_sysex(e24);
+    if (e24->get_sysex_size() > 0)
+    {
+        automutex locker(m_sysex_mutex);
+        m_sysex_queue.push_back(e24->get_sysex());
+    }
+}
+
+/**
+ *  Sends the next piece of queued SysEx data, if it is due.  The piece is at
+ *  most api_sysex_chunk() bytes, and is sent under the port lock, so that
+ *  channel events played on this bus wait for at most one piece, never for
+ *  a whole dump.  With a byte rate, the next piece is due when the bytes
+ *  sent so far would have gone over a cable of that speed; idle time is not
+ *  banked, so a new dump never goes out in a burst.
+ *
+ * \param now_us
+ *      The current monotonic time, in microseconds, from monotonic_us().  If
+ *      0 (no clock is available), no pacing is done.
+ *
+ * \param bytespersec
+ *      The byte rate to hold to.  If 0, no pacing is done.
+ *
+ * \return
+ *      Returns -1 if nothing is queued, 0 if the next piece can be sent
+ *      right away, or the number of microseconds until it is due.
+ */
+
+long
+midibase::send_sysex (int64_t now_us, int bytespersec)
+{
+    automutex locker(m_sysex_mutex);
+    if (m_sysex_queue.empty())
+        return -1;
+
+    if (now_us > 0 && now_us < m_sysex_due_us)
+        return long(m_sysex_due_us - now_us);
+
+    const std::vector<midibyte> & message = m_sysex_queue.front();
+    int remaining = int(message.size() - m_sysex_sent);
+    int count = api_sysex_chunk();
+    if (count <= 0 || count > remaining)
+        count = remaining;
+
+    bool sent;
+    {
+        automutex apilocker(m_mutex);
+        sent = api_sysex(&message[m_sysex_sent], count);
+        if (sent)
+            api_flush();
+    }
+    if (! sent)
+        return 1000;                    /* port is full, offer it again     */
+
+    m_sysex_sent += std::size_t(count);
+    if (m_sysex_sent >= message.size())
+    {
+        m_sysex_queue.pop_front();
+        m_sysex_sent = 0;
+    }
+    if (now_us > 0 && bytespersec > 0)
+    {
+        if (m_sysex_due_us < now_us)
+            m_sysex_due_us = now_us;    /* do not bank idle time            */
+
+        m_sysex_due_us += int64_t(count) * 1000000 / bytespersec;
+    }
+    if (m_sysex_queue.empty())
+        return -1;
+    else if (now_us > 0 && m_sysex_due_us > now_us)
+        return long(m_sysex_due_us - now_us);
+    else
+        return 0;
 }
 
 /**
@@ -859,6 +960,68 @@ millisleep (unsigned long ms)
 #endif
 }
 
+/**
+ *  Gets the current time of the monotonic clock, in microseconds.  This is
+ *  the clock used to timestamp incoming MIDI events when they arrive (see
+ *  perform::arrival_tick()).  It is safe to call from a real-time callback.
+ *
+ * \win32
+ *      Not yet implemented; returns 0, which callers treat as "time
+ *      unknown".
+ *
+ *  The value is 64 bits wide even where long is 32 bits, since the clock
+ *  counts from boot, and 2^31 microseconds is only about 35 minutes.
+ *
+ * \return
+ *      Returns the time in microseconds, or 0 if not available.
+ */
+
+int64_t
+monotonic_us ()
+{
+#if defined PLATFORM_WINDOWS
+    return 0;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000 + int64_t(ts.tv_nsec / 1000);
+#endif
+}
+
+/**
+ *  Recovers the monotonic_us() arrival time of an input event from its
+ *  time-stamp.  The input back-ends pass the arrival time to perform in
+ *  the midipulse time-stamp of the event, which is only 32 bits wide where
+ *  long is, and so keeps only the low 32 bits of the time.  An event is
+ *  converted within moments of its arrival, so the difference of the low
+ *  32 bits of now and of the stamp is its true age, and now minus that age
+ *  is the full arrival time.  Where midipulse holds 64 bits, the stamp is
+ *  already the full time, and is returned as is.
+ *
+ * \param stamp
+ *      The time-stamp of the input event.  0 means the arrival time is not
+ *      known.
+ *
+ * \param now_us
+ *      The current time, from monotonic_us().
+ *
+ * \return
+ *      Returns the arrival time in microseconds, or 0 if not known.
+ */
+
+int64_t
+arrival_us_from_stamp (midipulse stamp, int64_t now_us)
+{
+    if (stamp == 0 || now_us == 0)
+        return 0;
+
+    if (sizeof(midipulse) >= sizeof(int64_t))
+        return int64_t(stamp);
+
+    int32_t age = int32_t(uint32_t(now_us) - uint32_t(stamp));
+    return now_us - age;
+}
+
 }           // namespace seq64
 
 /*
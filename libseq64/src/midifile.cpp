@@ -63,7 +63,10 @@
  *      -   Proprietary SeqSpec data.
  */
 
+#include <errno.h>                      /* errno, EINTR                     */
 #include <fstream>
+#include <limits.h>                     /* INT_MAX                          */
+#include <stdio.h>                      /* rename()                         */
 
 #include "app_limits.h"                 /* SEQ64_USE_MIDI_VECTOR            */
 #include "calculations.hpp"             /* bpm_from_tempo_us()              */
@@ -78,12 +81,12 @@
 #include "midi_list.hpp"                /* seq64::midi_list container       */
 #endif
 
-/**
- *  A manifest constant for controlling the length of a line-reading
- *  array in a configuration file.
- */
-
-#define SEQ64_MIDI_LINE_MAX         1024
+#if ! defined PLATFORM_WINDOWS
+#include <fcntl.h>                      /* open(), O_RDONLY                 */
+#include <sys/mman.h>                   /* mmap(), munmap(), madvise()      */
+#include <sys/stat.h>                   /* fstat(), S_ISREG()               */
+#include <unistd.h>                     /* close(), write(), fsync()        */
+#endif
 
 /**
  *  The maximum length of a Seq24 track name.  This is a bit excessive.
@@ -199,7 +202,10 @@ midifile::midifile
     m_pos                       (0),
     m_name                      (name),
     m_data                      (),
-    m_char_list                 (),
+    m_bytes                     (nullptr),
+    m_map                       (nullptr),
+    m_map_size                  (0),
+    m_write_buffer              (),
     m_new_format                (! oldformat),
     m_global_bgsequence         (globalbgs),
     m_ppqn                      (0),
@@ -210,12 +216,77 @@ midifile::midifile
 }
 
 /**
- *  A rote destructor.
+ *  A rote destructor.  It releases the mapping of the file, if any.
  */
 
 midifile::~midifile ()
 {
-    // empty body
+    unmap_file();
+}
+
+/**
+ *  Maps the MIDI file into memory, read-only, so that parse() can read it in
+ *  place, instead of copying all of it into m_data first.  The pages are
+ *  read in by the kernel as the parser reaches them, and the parser's peak
+ *  memory is not doubled for a large file.  Only regular files of plausible
+ *  size are mapped; parse() falls back to reading anything else (or any
+ *  failure) into m_data, which also produces its error messages.
+ *
+ * \return
+ *      Returns true if the file is mapped, in which case m_bytes and
+ *      m_file_size are set.
+ */
+
+bool
+midifile::map_file ()
+{
+    bool result = false;
+#if ! defined PLATFORM_WINDOWS
+    int fd = open(m_name.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if
+        (
+            fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            size_t(st.st_size) > sizeof(long) && st.st_size <= INT_MAX
+        )
+        {
+            size_t size = size_t(st.st_size);
+            void * addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED)
+            {
+                (void) madvise(addr, size, MADV_SEQUENTIAL);
+                m_map = addr;
+                m_map_size = size;
+                m_bytes = static_cast<const midibyte *>(addr);
+                m_file_size = int(size);
+                result = true;
+            }
+        }
+        close(fd);                      /* the mapping stays valid      */
+    }
+#endif
+    return result;
+}
+
+/**
+ *  Releases the mapping made by map_file(), if any, and the buffer that
+ *  m_bytes points to.
+ */
+
+void
+midifile::unmap_file ()
+{
+#if ! defined PLATFORM_WINDOWS
+    if (not_nullptr(m_map))
+        (void) munmap(m_map, m_map_size);
+#endif
+    m_map = nullptr;
+    m_map_size = 0;
+    m_bytes = nullptr;
+    m_file_size = 0;
+    m_data.clear();
 }
 
 /**
@@ -256,8 +327,8 @@ midifile::read_short ()
 }
 
 /**
- *  Reads 1 byte of data directly from the m_data vector, incrementing
- *  m_pos after doing so.
+ *  Reads 1 byte of data directly from the mapped file or the m_data vector,
+ *  incrementing m_pos after doing so.
  *
  * \return
  *      Returns the byte that was read.  Returns 0 if there was an error,
@@ -268,9 +339,9 @@ midifile::read_short ()
 midibyte
 midifile::read_byte ()
 {
-    if (m_pos < m_file_size)
+    if (m_pos >= 0 && m_pos < m_file_size)
     {
-        return m_data[m_pos++];
+        return m_bytes[m_pos++];
     }
     else if (! m_disable_reported)
     {
@@ -280,6 +351,25 @@ midifile::read_byte ()
     return 0;
 }
 
+/**
+ *  Gets a byte near the current position without moving it.  Unlike the
+ *  direct indexing of the file data that it replaces, it is bounds-checked.
+ *
+ * \param offset
+ *      The offset of the byte from m_pos.  Defaults to 0, the next byte to
+ *      be read.  A value of -1 gets the byte just read.
+ *
+ * \return
+ *      Returns the byte, or 0 if the position is outside of the file.
+ */
+
+midibyte
+midifile::peek_byte (int offset) const
+{
+    int pos = m_pos + offset;
+    return (pos >= 0 && pos < m_file_size) ? m_bytes[pos] : 0 ;
+}
+
 /**
  *  Read a MIDI Variable-Length Value (VLV), which has a variable number
  *  of bytes.  This function reads the bytes while bit 7 is set in each
@@ -382,44 +472,53 @@ bool
 midifile::parse (perform & p, int screenset, bool importing)
 {
     bool result = true;
-    std::ifstream file
-    (
-        m_name.c_str(), std::ios::in | std::ios::binary | std::ios::ate
-    );
     m_error_is_fatal = false;
-    if (! file.is_open())
+    m_pos = 0;
+    unmap_file();                                   /* from a previous read */
+    if (! map_file())                               /* read it the old way  */
     {
-        m_error_is_fatal = true;
-        m_error_message = "Error opening MIDI file '";
-        m_error_message += m_name;
-        m_error_message += "'";
-        errprint(m_error_message.c_str());
-        return false;
-    }
+        std::ifstream file
+        (
+            m_name.c_str(), std::ios::in | std::ios::binary | std::ios::ate
+        );
+        if (! file.is_open())
+        {
+            m_error_is_fatal = true;
+            m_error_message = "Error opening MIDI file '";
+            m_error_message += m_name;
+            m_error_message += "'";
+            errprint(m_error_message.c_str());
+            return false;
+        }
 
-    int file_size = file.tellg();                   /* get end offset       */
-    if (size_t(file_size) <= sizeof(long))
-    {
-        m_error_is_fatal = true;
-        m_error_message = "Invalid file size... trying to read a directory?";
-        errprint(m_error_message.c_str());
-        return false;
-    }
-    file.seekg(0, std::ios::beg);                   /* seek to start        */
-    try
-    {
-        m_data.resize(file_size);                   /* allocate more data   */
-        m_file_size = file_size;                    /* save for checking    */
-    }
-    catch (const std::bad_alloc & ex)
-    {
-        m_error_is_fatal = true;
-        m_error_message = "Memory allocation failed in midifile::parse()";
-        errprint(m_error_message.c_str());
-        return false;
+        int file_size = file.tellg();               /* get end offset       */
+        if (size_t(file_size) <= sizeof(long))
+        {
+            m_error_is_fatal = true;
+            m_error_message =
+                "Invalid file size... trying to read a directory?";
+            errprint(m_error_message.c_str());
+            return false;
+        }
+        file.seekg(0, std::ios::beg);               /* seek to start        */
+        try
+        {
+            m_data.resize(file_size);               /* allocate more data   */
+            m_file_size = file_size;                /* save for checking    */
+        }
+        catch (const std::bad_alloc & ex)
+        {
+            m_error_is_fatal = true;
+            m_error_message = "Memory allocation failed in midifile::parse()";
+            errprint(m_error_message.c_str());
+            return false;
+        }
+        file.read((char *)(&m_data[0]), file_size); /* vector == array :-)  */
+        file.close();
+        m_bytes = &m_data[0];
     }
-    file.read((char *)(&m_data[0]), file_size);     /* vector == array :-)  */
-    file.close();
+
+    int file_size = m_file_size;
     m_error_message.clear();
     m_disable_reported = false;
     m_smf0_splitter.initialize();                   /* SMF 0 support        */
@@ -676,6 +775,7 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
             midishort seqnum = 0;
             midibyte status = 0;
             midibyte laststatus;
+            int seqchannel = -1;                    /* last channel set     */
             midilong seqspec = 0;                   /* sequencer-specific   */
             bool done = false;                      /* done for each track  */
             sequence * s = new sequence(m_ppqn);    /* create new sequence  */
@@ -691,10 +791,16 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
             RunningTime = 0;                    /* reset time               */
             while (! done)                      /* get each event in track  */
             {
+                if (m_pos >= m_file_size)       /* no End of Track event    */
+                {
+                    errdump("MIDI track truncated, End of Track assumed");
+                    break;
+                }
+
                 event e;                        /* safer here, if "slower"  */
                 Delta = read_varinum();         /* get time delta           */
                 laststatus = status;
-                status = m_data[m_pos];         /* get next status byte     */
+                status = peek_byte();           /* get next status byte     */
                 if ((status & 0x80) == 0x00)    /* is it a status bit ?     */
                     status = laststatus;        /* no, it's running status  */
                 else
@@ -744,7 +850,11 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
                      */
 
                     seq.append_event(e);                  /* does not sort    */
-                    seq.set_midi_channel(channel);        /* set midi channel */
+                    if (channel != seqchannel)            /* set midi channel */
+                    {
+                        seq.set_midi_channel(channel);    /* not per event    */
+                        seqchannel = channel;
+                    }
                     if (is_smf0)
                         m_smf0_splitter.increment(channel);
                     break;
@@ -762,7 +872,11 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
                      */
 
                     seq.append_event(e);                /* does not sort    */
-                    seq.set_midi_channel(channel);      /* set midi channel */
+                    if (channel != seqchannel)          /* set midi channel */
+                    {
+                        seq.set_midi_channel(channel);
+                        seqchannel = channel;
+                    }
                     if (is_smf0)
                         m_smf0_splitter.increment(channel);
                     break;
@@ -931,6 +1045,7 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
                             {
                                 midibyte channel = read_byte();
                                 seq.set_midi_channel(channel);
+                                seqchannel = channel;
                                 if (is_smf0)
                                     m_smf0_splitter.increment(channel);
 
@@ -1073,7 +1188,7 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
                             m_pos += len;               /* skip the rest    */
 #else
                             m_pos += len;               /* skip it          */
-                            if (m_data[m_pos-1] != 0xF7)
+                            if (peek_byte(-1) != 0xF7)
                                 errdump("SysEx terminator byte F7 not found");
 #endif
                         }
@@ -1372,6 +1487,7 @@ midifile::parse_proprietary_track (perform & p, int file_size)
                 read_byte_array(a, 6);
                 p.midi_control_off(i).set(a);
             }
+            p.midi_controls_changed();
         }
         seqspec = parse_prop_header(file_size);
         if (seqspec == c_midiclocks)
@@ -1933,8 +2049,15 @@ midifile::write_track
     midilong tracksize = midilong(lst.size());
     write_long(SEQ64_MTRK_TAG);             /* magic number 'MTrk'          */
     write_long(tracksize);
-    while (! lst.done())                    /* write the track data         */
-        write_byte(lst.get());
+
+    const midibyte * data = lst.bytes();
+    if (not_nullptr(data))
+        write_bytes(data, lst.size());      /* copy the whole track data    */
+    else
+    {
+        while (! lst.done())                /* write the track data         */
+            write_byte(lst.get());
+    }
 }
 
 /**
@@ -1968,6 +2091,93 @@ midifile::prop_item_size (long data_length) const
     return result;
 }
 
+/**
+ *  Writes the accumulated m_write_buffer out to the file named by m_name,
+ *  then clears the buffer.  The whole buffer is written in one operation.
+ *
+ *  On POSIX systems the data goes to a temporary file, "name.tmp", in the
+ *  same directory, which is synced to disk and then renamed over the
+ *  original.  The rename is atomic, so a crash or a full disk in the middle
+ *  of a save leaves the previous version of the file intact, rather than a
+ *  truncated one.  The permissions of an existing file are preserved.
+ *
+ * \param errmsg
+ *      The message to put in m_error_message if the write fails.
+ *
+ * \return
+ *      Returns true if the whole buffer was written and the file is in place.
+ */
+
+bool
+midifile::flush_file (const std::string & errmsg)
+{
+    bool result = false;
+    const char * data = m_write_buffer.empty() ?
+        nullptr : reinterpret_cast<const char *>(&m_write_buffer[0]);
+
+    size_t remaining = m_write_buffer.size();
+
+#if defined PLATFORM_WINDOWS
+
+    std::ofstream file
+    (
+        m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    if (file.is_open())
+    {
+        file.write(data, std::streamsize(remaining));
+        file.close();
+        result = ! file.fail();
+    }
+
+#else
+
+    std::string tmpname = m_name + ".tmp";
+    mode_t mode = 0666;                     /* umask applies, as usual      */
+    struct stat st;
+    if (stat(m_name.c_str(), &st) == 0)
+        mode = st.st_mode & 07777;          /* keep the existing permission */
+
+    int fd = open(tmpname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
+    if (fd >= 0)
+    {
+        result = true;
+        while (remaining > 0)
+        {
+            ssize_t count = ::write(fd, data, remaining);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                result = false;
+                break;
+            }
+            data += count;
+            remaining -= size_t(count);
+        }
+        if (result)
+            result = fsync(fd) == 0;
+
+        if (close(fd) != 0)
+            result = false;
+
+        if (result)
+            result = rename(tmpname.c_str(), m_name.c_str()) == 0;
+
+        if (! result)
+            (void) unlink(tmpname.c_str());
+    }
+
+#endif
+
+    m_write_buffer.clear();
+    if (! result)
+        m_error_message = errmsg;
+
+    return result;
+}
+
 /**
  *  Write the whole MIDI data and Seq24 information out to the file.
  *  Also see the write_song() function, for exporting to standard MIDI.
@@ -1997,6 +2207,7 @@ midifile::write (perform & p, bool doseqspec)
     automutex locker(m_mutex);
     bool result = m_ppqn >= SEQ64_MINIMUM_PPQN && m_ppqn <= SEQ64_MAXIMUM_PPQN;
     m_error_message.clear();
+    m_write_buffer.clear();
     if (! result)
         m_error_message = "Error, invalid PPQN for MIDI file to write";
 
@@ -2069,29 +2280,9 @@ midifile::write (perform & p, bool doseqspec)
             m_error_message = "Error, could not write SeqSpec track";
     }
     if (result)
-    {
-        std::ofstream file
-        (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
-        );
-        if (file.is_open())
-        {
-            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-            std::list<midibyte>::iterator it;
-            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
-            {
-                char c = *it;
-                file.write(&c, 1);
-            }
-            m_char_list.clear();
-        }
-        else
-        {
-            m_error_message = "Error opening MIDI file for writing";
-            result = false;
-        }
-    }
+        result = flush_file("Error writing MIDI file");
+    else
+        m_write_buffer.clear();
     if (result)
         p.is_modified(false);           /* it worked, tell perform about it */
 
@@ -2162,6 +2353,7 @@ midifile::write_song (perform & p)
     automutex locker(m_mutex);
     int numtracks = 0;
     m_error_message.clear();
+    m_write_buffer.clear();
     for (int i = 0; i < p.sequence_high(); ++i) /* count exportable tracks  */
     {
         if (p.is_exportable(i))                 /* do muted tracks count?   */
@@ -2190,8 +2382,16 @@ midifile::write_song (perform & p)
          * incremented only if the track was exportable.  Note that this loop
          * is kind of an elaboration of what goes on in the midi_container ::
          * fill() function for normal Sequencer64 file writing.
+         *
+         * The tempo track is unrolled like any other track, so its Set Tempo
+         * events land where the tempo map puts them.  If the map starts with
+         * the base tempo instead of a Set Tempo event at pulse 0, the first
+         * exported track gets that tempo, so the file plays at the tempo of
+         * the song from the start.
          */
 
+        TempoMap tmap = p.get_tempo_map();
+        bool needtempo = ! tmap->start_changed();
         for (int track = 0; track < p.sequence_high(); ++track)
         {
             if (p.is_exportable(track))
@@ -2209,6 +2409,11 @@ midifile::write_song (perform & p)
 
                     lst.fill_seq_number(track);
                     lst.fill_seq_name(seq.name());
+                    if (needtempo)
+                    {
+                        lst.fill_start_tempo(tmap->segment_bpm(0));
+                        needtempo = false;
+                    }
                     if (track == 0 && ! rc().legacy_format())
                     {
                         /*
@@ -2260,30 +2465,9 @@ midifile::write_song (perform & p)
         }
     }
     if (result)
-    {
-        std::ofstream file
-        (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
-        );
-        if (file.is_open())
-        {
-            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-
-            std::list<midibyte>::const_iterator it;
-            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
-            {
-                const char c = *it;
-                file.write(&c, 1);
-            }
-            m_char_list.clear();
-        }
-        else
-        {
-            m_error_message = "Error opening MIDI file for exporting";
-            result = false;
-        }
-    }
+        result = flush_file("Error writing exported MIDI file");
+    else
+        m_write_buffer.clear();
 
     /*
      * Does not apply to exporting.
@@ -87,6 +87,20 @@ mutex::lock () const
     pthread_mutex_lock(&m_mutex_lock);
 }
 
+/**
+ *  Locks the mutex only if that can be done without waiting.
+ *
+ * \return
+ *      Returns true if the mutex is now locked by the caller, who must then
+ *      unlock() it.
+ */
+
+bool
+mutex::try_lock () const
+{
+    return pthread_mutex_trylock(&m_mutex_lock) == 0;
+}
+
 /**
  *  Unlock the mutex.
  */
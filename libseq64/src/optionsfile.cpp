@@ -44,9 +44,9 @@
  *
  *  Also note that the parse() and write() functions process sections in a
  *  different order!  The reason this does not mess things up is that the
- *  line_after() function always rescans from the beginning of the file.  As
- *  long as each section's sub-values are read and written in the same order,
- *  there will be no problem.
+ *  line_after() function looks each section up in an index of the whole
+ *  file.  As long as each section's sub-values are read and written in the
+ *  same order, there will be no problem.
  *
  * Fixups:
  *
@@ -272,13 +272,11 @@ optionsfile::error_message
 bool
 optionsfile::parse (perform & p)
 {
-    std::ifstream file(m_name.c_str(), std::ios::in | std::ios::ate);
-    if (! file.is_open())
+    if (! load_file())
     {
         printf("? error opening [%s] for reading\n", m_name.c_str());
         return false;
     }
-    file.seekg(0, std::ios::beg);                           /* seek to start */
 
     /*
      * [comments]
@@ -287,7 +285,7 @@ optionsfile::parse (perform & p)
      * read an optional comment block.
      */
 
-    if (line_after(file, "[comments]"))                 /* gets first line  */
+    if (line_after("[comments]"))                       /* gets first line  */
     {
         rc().clear_comments();
         do
@@ -295,17 +293,17 @@ optionsfile::parse (perform & p)
             rc().append_comment_line(m_line);
             rc().append_comment_line("\n");
 
-        } while (next_data_line(file));
+        } while (next_data_line());
     }
 
     /*
      * This call causes parsing to skip all of the header material.  Please note
-     * that the line_after() function always starts from the beginning of the
-     * file every time.  A lot a rescanning!  But it goes fast these days.
+     * that the line_after() function finds any section directly, from the
+     * section index that load_file() built, no matter where we are now.
      */
 
     unsigned sequences = 0;                                 /* seq & ctrl #s */
-    line_after(file, "[midi-control]");                     /* find section  */
+    line_after("[midi-control]");                           /* find section  */
     sscanf(m_line, "%u", &sequences);
 
     /*
@@ -326,7 +324,7 @@ optionsfile::parse (perform & p)
     }
     else if (sequences > 0)
     {
-        ok = next_data_line(file);
+        ok = next_data_line();
         if (! ok)
             return error_message("midi-control", "no data");
         else
@@ -350,7 +348,8 @@ optionsfile::parse (perform & p)
             p.midi_control_toggle(i).set(a);
             p.midi_control_on(i).set(b);
             p.midi_control_off(i).set(c);
-            ok = next_data_line(file);
+            p.midi_controls_changed();
+            ok = next_data_line();
             if (! ok && i < (sequences - 1))
                 return error_message("midi-control", "not enough data");
             else
@@ -366,20 +365,21 @@ optionsfile::parse (perform & p)
      * [mute-group] plus some additional data about how to save them.  After
      * we parse the mute group, we need to see if there is another value for
      * the mute_group_handling_t enumeration.  One little issue... the
-     * parse_mute_group_section() function actually re-opens the file itself,
-     * and once it exits, it's as if the section never existed.  So we also
+     * parse_mute_group_section() function actually re-loads the file itself
+     * (reusing the loaded lines if the file is unchanged), and once it exits,
+     * it's as if the section never existed.  So we also
      * have to pase the new mute-group handling feature there as well.
      */
 
     ok = parse_mute_group_section(p);
     if (ok)
-        ok = line_after(file, "[midi-clock]");
+        ok = line_after("[midi-clock]");
 
     long buses = 0;
     if (ok)
     {
         sscanf(m_line, "%ld", &buses);
-        ok = next_data_line(file) && buses > 0 && buses <= SEQ64_DEFAULT_BUSS_MAX;
+        ok = next_data_line() && buses > 0 && buses <= SEQ64_DEFAULT_BUSS_MAX;
     }
     if (ok)
     {
@@ -396,7 +396,7 @@ optionsfile::parse (perform & p)
             long bus_on, bus;
             sscanf(m_line, "%ld %ld", &bus, &bus_on);
             p.add_clock(static_cast<clock_e>(bus_on));
-            ok = next_data_line(file);
+            ok = next_data_line();
             if (! ok)
             {
                 if (i < (buses-1))
@@ -422,10 +422,10 @@ optionsfile::parse (perform & p)
      *  we note that Kepler34 has this section commented out.
      */
 
-    line_after(file, "[keyboard-control]");
+    line_after("[keyboard-control]");
     long keys = 0;
     sscanf(m_line, "%ld", &keys);
-    ok = next_data_line(file) && keys > 0 && keys <= c_max_keys;
+    ok = next_data_line() && keys > 0 && keys <= c_max_keys;
     if (! ok)
         (void) error_message("keyboard-control");   // now allowed to continue
 
@@ -445,7 +445,7 @@ optionsfile::parse (perform & p)
         long key = 0, seq = 0;
         sscanf(m_line, "%ld %ld", &key, &seq);
         p.set_key_event(key, seq);
-        ok = next_data_line(file);
+        ok = next_data_line();
         if (! ok && i < (keys - 1))
             return error_message("keyboard-control data line");
     }
@@ -456,10 +456,10 @@ optionsfile::parse (perform & p)
      *  we note that Kepler34 has this section commented out.
      */
 
-    line_after(file, "[keyboard-group]");
+    line_after("[keyboard-group]");
     long groups = 0;
     sscanf(m_line, "%ld", &groups);
-    ok = next_data_line(file) && groups > 0 && groups <= c_max_keys;
+    ok = next_data_line() && groups > 0 && groups <= c_max_keys;
     if (! ok)
         (void) error_message("keyboard-group");     // now allowed to continue
 
@@ -470,7 +470,7 @@ optionsfile::parse (perform & p)
         long key = 0, group = 0;
         sscanf(m_line, "%ld %ld", &key, &group);
         p.set_key_group(key, group);
-        ok = next_data_line(file);
+        ok = next_data_line();
         if (! ok && i < (groups - 1))
             return error_message("keyboard-group data line");
     }
@@ -478,7 +478,7 @@ optionsfile::parse (perform & p)
     keys_perform_transfer ktx;
     memset(&ktx, 0, sizeof(ktx));
     sscanf(m_line, "%u %u", &ktx.kpt_bpm_up, &ktx.kpt_bpm_dn);
-    next_data_line(file);
+    next_data_line();
     sscanf
     (
         m_line, "%u %u %u",
@@ -486,7 +486,7 @@ optionsfile::parse (perform & p)
         &ktx.kpt_screenset_dn,
         &ktx.kpt_set_playing_screenset
     );
-    next_data_line(file);
+    next_data_line();
     sscanf
     (
         m_line, "%u %u %u",
@@ -494,7 +494,7 @@ optionsfile::parse (perform & p)
         &ktx.kpt_group_off,
         &ktx.kpt_group_learn
     );
-    next_data_line(file);
+    next_data_line();
     sscanf
     (
         m_line, "%u %u %u %u %u",
@@ -506,12 +506,12 @@ optionsfile::parse (perform & p)
     );
 
     int show_key = 0;
-    next_data_line(file);
+    next_data_line();
     sscanf(m_line, "%d", &show_key);
     ktx.kpt_show_ui_sequence_key = bool(show_key);
-    next_data_line(file);
+    next_data_line();
     sscanf(m_line, "%u", &ktx.kpt_start);
-    next_data_line(file);
+    next_data_line();
     sscanf(m_line, "%u", &ktx.kpt_stop);
 
     if (rc().legacy_format())               /* init "non-legacy" fields */
@@ -533,7 +533,7 @@ optionsfile::parse (perform & p)
          * them.
          */
 
-        next_data_line(file);
+        next_data_line();
         sscanf(m_line, "%u", &ktx.kpt_pause);
         if (ktx.kpt_pause <= 1)             /* no pause key value present   */
         {
@@ -546,7 +546,7 @@ optionsfile::parse (perform & p)
              * New feature for showing sequence numbers in the mainwnd GUI.
              */
 
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%d", &show_key);
             ktx.kpt_show_ui_sequence_number = bool(show_key);
         }
@@ -560,53 +560,53 @@ optionsfile::parse (perform & p)
          * configurations that have devoted those keys to other purposes.
          */
 
-        next_data_line(file);
+        next_data_line();
         sscanf(m_line, "%u", &ktx.kpt_pattern_edit);
 
-        next_data_line(file);
+        next_data_line();
         sscanf(m_line, "%u", &ktx.kpt_event_edit);
 
-        if (next_data_line(file))
+        if (next_data_line())
             sscanf(m_line, "%u", &ktx.kpt_pattern_shift);   /* variset support */
         else
             ktx.kpt_pattern_shift = SEQ64_slash;            /* variset support */
 
-        if (line_after(file, "[New-keys]"))
+        if (line_after("[New-keys]"))
         {
             sscanf(m_line, "%u", &ktx.kpt_song_mode);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_menu_mode);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_follow_transport);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_toggle_jack);
-            next_data_line(file);
+            next_data_line();
         }
-        else if (line_after(file, "[extended-keys]"))
+        else if (line_after("[extended-keys]"))
         {
             sscanf(m_line, "%u", &ktx.kpt_song_mode);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_toggle_jack);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_menu_mode);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_follow_transport);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_fast_forward);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_rewind);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_pointer_position);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_tap_bpm);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_toggle_mutes);
-            next_data_line(file);
+            next_data_line();
 #ifdef SEQ64_SONG_RECORDING
             sscanf(m_line, "%u", &ktx.kpt_song_record);
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%u", &ktx.kpt_oneshot_queue);
-            next_data_line(file);
+            next_data_line();
 #endif
         }
         else
@@ -619,24 +619,24 @@ optionsfile::parse (perform & p)
     p.keys().set_keys(ktx);                 /* copy into perform keys   */
 
     long flag = 0;
-    if (line_after(file, "[jack-transport]"))
+    if (line_after("[jack-transport]"))
     {
         sscanf(m_line, "%ld", &flag);
         rc().with_jack_transport(bool(flag));
 
-        next_data_line(file);
+        next_data_line();
         sscanf(m_line, "%ld", &flag);
         rc().with_jack_master(bool(flag));
 
-        next_data_line(file);
+        next_data_line();
         sscanf(m_line, "%ld", &flag);
         rc().with_jack_master_cond(bool(flag));
 
-        next_data_line(file);
+        next_data_line();
         sscanf(m_line, "%ld", &flag);
         p.song_start_mode(bool(flag));
 
-        if (next_data_line(file))
+        if (next_data_line())
         {
             sscanf(m_line, "%ld", &flag);
             rc().with_jack_midi(bool(flag));
@@ -654,14 +654,14 @@ optionsfile::parse (perform & p)
      *  occurs, we abort... the user must fix the "rc" file.
      */
 
-    if (line_after(file, "[midi-input]"))
+    if (line_after("[midi-input]"))
     {
         int buses = 0;
         int count = sscanf(m_line, "%d", &buses);
         if (count > 0 && buses > 0)
         {
             int b = 0;
-            while (next_data_line(file))
+            while (next_data_line())
             {
                 long bus_on, bus;
                 count = sscanf(m_line, "%ld %ld", &bus, &bus_on);
@@ -691,12 +691,12 @@ optionsfile::parse (perform & p)
      * This is not right; it is already handled above, irregardless of legacy
      * status, and the next section is [manual-alsa-ports], which is handled
      * further on.  The handling here is out of order, but configfile ::
-     * line_after() starts from the beginning every time.
+     * line_after() can find any section in any order.
      */
 
     if (! rc().legacy_format())
     {
-        if (next_data_line(file))                       /* new 2016-08-20 */
+        if (next_data_line())                           /* new 2016-08-20 */
         {
             sscanf(m_line, "%ld", &flag);
             rc().filter_by_channel(bool(flag));
@@ -705,25 +705,25 @@ optionsfile::parse (perform & p)
 
 #endif  // USE_THIS_CODE
 
-    if (line_after(file, "[midi-clock-mod-ticks]"))
+    if (line_after("[midi-clock-mod-ticks]"))
     {
         long ticks = 64;
         sscanf(m_line, "%ld", &ticks);
         midibus::set_clock_mod(ticks);
     }
-    if (line_after(file, "[midi-meta-events]"))
+    if (line_after("[midi-meta-events]"))
     {
         int track = 0;
         sscanf(m_line, "%d", &track);
         rc().tempo_track_number(track);
         p.set_tempo_track_number(track);    /* MIDI file can override this  */
     }
-    if (line_after(file, "[manual-alsa-ports]"))
+    if (line_after("[manual-alsa-ports]"))
     {
         sscanf(m_line, "%ld", &flag);
         rc().manual_alsa_ports(bool(flag));
     }
-    if (line_after(file, "[reveal-alsa-ports]"))
+    if (line_after("[reveal-alsa-ports]"))
     {
         /*
          * If this flag is already raised, it was raised on the command line,
@@ -734,20 +734,38 @@ optionsfile::parse (perform & p)
         if (! rc().reveal_alsa_ports())
             rc().reveal_alsa_ports(bool(flag));
     }
+    if (line_after("[alsa-lookahead]"))
+    {
+        int ms = 0;
+        sscanf(m_line, "%d", &ms);
+        rc().alsa_lookahead_ms(ms);
+    }
+    if (line_after("[undo-budget]"))
+    {
+        int kb = SEQ64_UNDO_BUDGET_DEFAULT;
+        sscanf(m_line, "%d", &kb);
+        rc().undo_budget_kb(kb);
+    }
+    if (line_after("[sysex-rate]"))
+    {
+        int rate = SEQ64_SYSEX_RATE_DEFAULT;
+        sscanf(m_line, "%d", &rate);
+        rc().sysex_rate(rate);
+    }
 
-    if (line_after(file, "[last-used-dir]"))
+    if (line_after("[last-used-dir]"))
     {
         if (strlen(m_line) > 0)
             rc().last_used_dir(m_line); // FIXME: check for valid path
     }
 
-    if (line_after(file, "[recent-files]"))
+    if (line_after("[recent-files]"))
     {
         int count;
         sscanf(m_line, "%d", &count);
         for (int i = 0; i < count; ++i)
         {
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 if (strlen(m_line) > 0)
                     rc().add_recent_file(std::string(m_line));
@@ -758,7 +776,7 @@ optionsfile::parse (perform & p)
     }
 
     long method = 0;
-    if (line_after(file, "[interaction-method]"))
+    if (line_after("[interaction-method]"))
         sscanf(m_line, "%ld", &method);
 
     /*
@@ -770,31 +788,30 @@ optionsfile::parse (perform & p)
 
     if (! rc().legacy_format())
     {
-        if (next_data_line(file))                   /* a new option */
+        if (next_data_line())                       /* a new option */
         {
             sscanf(m_line, "%ld", &method);
             rc().allow_mod4_mode(method != 0);
         }
-        if (next_data_line(file))                   /* a new option */
+        if (next_data_line())                       /* a new option */
         {
             sscanf(m_line, "%ld", &method);
             rc().allow_snap_split(method != 0);
         }
-        if (next_data_line(file))                   /* a new option */
+        if (next_data_line())                       /* a new option */
         {
             sscanf(m_line, "%ld", &method);
             rc().allow_click_edit(method != 0);
         }
-        line_after(file, "[lash-session]");
+        line_after("[lash-session]");
         sscanf(m_line, "%ld", &method);
         rc().lash_support(method != 0);
 
         method = 1;         /* preserve legacy seq24 option if not present */
-        line_after(file, "[auto-option-save]");
+        line_after("[auto-option-save]");
         sscanf(m_line, "%ld", &method);
         rc().auto_option_save(method != 0);
     }
-    file.close();           /* done parsing the "rc" configuration file */
     return true;
 }
 
@@ -822,18 +839,16 @@ optionsfile::parse (perform & p)
 bool
 optionsfile::parse_mute_group_section (perform & p)
 {
-    std::ifstream file(m_name.c_str(), std::ios::in | std::ios::ate);
-    if (! file.is_open())
+    if (! load_file())
     {
         printf("? error opening [%s] for reading\n", m_name.c_str());
         return false;
     }
-    file.seekg(0, std::ios::beg);                           /* seek to start */
 
-    line_after(file, "[mute-group]");               /* Group MIDI control   */
+    line_after("[mute-group]");                     /* Group MIDI control   */
     int gtrack = 0;
     sscanf(m_line, "%d", &gtrack);
-    bool result = next_data_line(file);
+    bool result = next_data_line();
     if (result)
     {
         result = gtrack == 0 || gtrack == (c_max_sets * c_max_keys); /* 1024 */
@@ -893,7 +908,7 @@ optionsfile::parse_mute_group_section (perform & p)
                 p.load_mute_group(g, gm);
             }
 
-            result = next_data_line(file);
+            result = next_data_line();
             if (! result && g < (c_max_groups - 1))
                 return error_message("mute-group data line");
             else
@@ -1130,9 +1145,9 @@ optionsfile::write (const perform & p)
         default:
             break;
         }
-        const midi_control & toggle = ucperf.midi_control_toggle(mcontrol);
-        const midi_control & off = ucperf.midi_control_off(mcontrol);
-        const midi_control & on = ucperf.midi_control_on(mcontrol);
+        const midi_control & toggle = p.midi_control_toggle(mcontrol);
+        const midi_control & off = p.midi_control_off(mcontrol);
+        const midi_control & on = p.midi_control_on(mcontrol);
         snprintf
         (
             outs, sizeof outs,
@@ -1364,6 +1379,54 @@ optionsfile::write (const perform & p)
         << "   # flag for reveal ALSA ports\n"
         ;
 
+    /*
+     * ALSA lookahead
+     */
+
+    file
+        << "\n[alsa-lookahead]\n\n"
+           "# Set to 0 to send ALSA MIDI output directly, as seq24 does.  Set\n"
+           "# to a value from 10 to 50 to have the output thread schedule\n"
+           "# events that many milliseconds ahead on the ALSA sequencer queue,\n"
+           "# so that the kernel timer, not the thread's wake-up, sets the\n"
+           "# timing.  Pending events are cancelled on stop, reposition, and\n"
+           "# tempo change.  Not used with JACK MIDI.\n"
+           "\n"
+        << rc().alsa_lookahead_ms()
+        << "   # lookahead in milliseconds, 0 = off\n"
+        ;
+
+    /*
+     * Undo budget
+     */
+
+    file
+        << "\n[undo-budget]\n\n"
+           "# The memory, in kilobytes, that each pattern may spend on its\n"
+           "# undo and redo records.  Only the events changed by an edit are\n"
+           "# saved, so this covers many edits.  When it is exceeded, the\n"
+           "# oldest edits can no longer be undone.  Set to 0 for no limit.\n"
+           "\n"
+        << rc().undo_budget_kb()
+        << "   # undo budget in kilobytes, 0 = no limit\n"
+        ;
+
+    /*
+     * SysEx rate
+     */
+
+    file
+        << "\n[sysex-rate]\n\n"
+           "# The rate, in bytes per second, at which SysEx messages passed\n"
+           "# through to the output ports are sent.  They are queued, and sent\n"
+           "# in the background, so that a large dump never delays the playing\n"
+           "# of patterns.  3125 is the speed of a MIDI cable.  Set to 0 to send\n"
+           "# as fast as the port accepts the data.\n"
+           "\n"
+        << rc().sysex_rate()
+        << "   # SysEx bytes per second, 0 = no pacing\n"
+        ;
+
     /*
      * Interaction-method
      */
@@ -151,6 +151,7 @@
  *        implementation.
  */
 
+#include <algorithm>                    /* std::sort(), std::unique()       */
 #include <sched.h>
 #include <stdio.h>
 #include <string.h>                     /* memset()                         */
@@ -167,7 +168,8 @@
 #include <windows.h>                    /* Muahhhahahahahah!                */
 #include <mmsystem.h>                   /* Windows timeBeginPeriod()        */
 #else
-#include <time.h>                       /* struct timespec                  */
+#include <errno.h>                      /* EINTR                            */
+#include <time.h>                       /* clock_nanosleep()                */
 #endif
 
 /**
@@ -209,6 +211,211 @@ namespace seq64
 
 midi_control perform::sm_mc_dummy;
 
+/**
+ *  Creates an inactive change queue.  The ring gets the smallest power of
+ *  two that holds one entry per pattern plus one for the performance.
+ *
+ * \param sequences
+ *      The number of patterns that can be reported, normally c_max_sequence.
+ */
+
+change_queue::change_queue (int sequences)
+ :
+    m_sequences     (sequences),
+    m_pending       (sequences + 1),
+    m_cells         (),
+    m_mask          (0),
+    m_enqueue_pos   (0),
+    m_dequeue_pos   (0),
+    m_claimed       (false),
+    m_active        (false),
+    m_interests     (CHANGE_NONE)
+{
+    std::size_t capacity = 1;
+    while (capacity < std::size_t(sequences + 1))
+        capacity *= 2;
+
+    std::vector<cell_t> cells(capacity);
+    m_cells.swap(cells);
+    m_mask = capacity - 1;
+    for (std::size_t c = 0; c < capacity; ++c)
+        m_cells[c].cc_turn.store(c, std::memory_order_relaxed);
+
+    for (int slot = 0; slot <= sequences; ++slot)
+        m_pending[slot].store(0, std::memory_order_relaxed);
+}
+
+/**
+ *  Makes this queue the property of a new subscriber, if it is free.
+ *  Whatever a previous subscriber left undrained is discarded, and a record
+ *  for the performance with all of the subscriber's interests is posted, so
+ *  that the first drain tells the new subscriber to bring itself up to date.
+ *  The queue becomes active only after its interests are stored, so no
+ *  producer filters a change against the previous subscriber's interests.
+ *
+ * \param interests
+ *      The change_t flags that the new subscriber wants to hear about.
+ *
+ * \return
+ *      Returns true if the queue was free and is now claimed.
+ */
+
+bool
+change_queue::claim (unsigned interests)
+{
+    bool expected = false;
+    bool result = m_claimed.compare_exchange_strong(expected, true);
+    if (result)
+    {
+        ChangeList stale;
+        m_interests.store(interests, std::memory_order_release);
+        (void) drain(stale);
+        post(SEQ64_NULL_SEQUENCE, interests);
+        m_active.store(true, std::memory_order_release);
+    }
+    return result;
+}
+
+/**
+ *  Gives up the queue.  Producers that already saw it active may still post
+ *  to it; the next claim() discards those records.
+ */
+
+void
+change_queue::release ()
+{
+    m_active = false;
+    m_claimed = false;
+}
+
+/**
+ *  Adds changes for a pattern, or for the performance.  The slot is pushed
+ *  into the ring only if it had nothing pending, so repeated changes to a
+ *  pattern between two drains cost only an atomic OR.  Changes outside the
+ *  subscriber's interests are dropped.
+ *
+ * \threadsafe
+ *      Lock-free; can be called from any thread.
+ *
+ * \param seq
+ *      The pattern number, or SEQ64_NULL_SEQUENCE for the performance.
+ *      Out-of-range numbers are ignored.
+ *
+ * \param changes
+ *      The change_t flags to add.
+ */
+
+void
+change_queue::post (int seq, unsigned changes)
+{
+    int slot = seq == SEQ64_NULL_SEQUENCE ? m_sequences : seq ;
+    changes &= m_interests;
+    if (slot >= 0 && slot <= m_sequences && changes != CHANGE_NONE)
+    {
+        unsigned old = m_pending[slot].fetch_or(changes);
+        if (old == CHANGE_NONE)
+            (void) push(slot);
+    }
+}
+
+/**
+ *  Moves every pending change record into the given list.  To be called by
+ *  the subscriber only, typically once per frame.
+ *
+ * \param changes
+ *      The destination; records are appended to it.
+ *
+ * \return
+ *      Returns the number of records appended.
+ */
+
+int
+change_queue::drain (ChangeList & changes)
+{
+    int result = 0;
+    int slot;
+    while (pop(slot))
+    {
+        unsigned flags = m_pending[slot].exchange(CHANGE_NONE);
+        if (flags != CHANGE_NONE)
+        {
+            change_record_t cr;
+            cr.cr_seq = slot == m_sequences ? SEQ64_NULL_SEQUENCE : slot ;
+            cr.cr_changes = flags;
+            changes.push_back(cr);
+            ++result;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Adds a slot number at the tail of the ring.  Several producers may race
+ *  here; the one that wins the compare-exchange of the enqueue position
+ *  fills the cell, then hands it to the consumer by advancing its turn.
+ *
+ * \return
+ *      Returns false if the ring is full, which the coalescing in post()
+ *      makes impossible.
+ */
+
+bool
+change_queue::push (int slot)
+{
+    std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        cell_t & cell = m_cells[pos & m_mask];
+        std::size_t turn = cell.cc_turn.load(std::memory_order_acquire);
+        if (turn == pos)
+        {
+            if
+            (
+                m_enqueue_pos.compare_exchange_weak
+                (
+                    pos, pos + 1, std::memory_order_relaxed
+                )
+            )
+            {
+                cell.cc_slot = slot;
+                cell.cc_turn.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (turn < pos)
+            return false;                       /* full, should not happen  */
+        else
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ *  Takes the slot number at the head of the ring, if a producer has
+ *  finished filling it, and hands the cell back for the next lap.
+ *
+ * \param [out] slot
+ *      Receives the slot number.
+ *
+ * \return
+ *      Returns false if the ring is empty.
+ */
+
+bool
+change_queue::pop (int & slot)
+{
+    cell_t & cell = m_cells[m_dequeue_pos & m_mask];
+    std::size_t turn = cell.cc_turn.load(std::memory_order_acquire);
+    bool result = turn == m_dequeue_pos + 1;
+    if (result)
+    {
+        slot = cell.cc_slot;
+        std::size_t next = m_dequeue_pos + m_mask + 1;    /* next lap     */
+        cell.cc_turn.store(next, std::memory_order_release);
+        ++m_dequeue_pos;
+    }
+    return result;
+}
+
 /**
  *  This construction initializes a vast number of member variables, some
  *  of them public (but we're working on that)!
@@ -245,6 +452,7 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_song_start_mode           (false),    // set later during options read
     m_start_from_perfedit       (false),
     m_reposition                (false),
+    m_lookahead_reset           (false),
     m_excell_FF_RW              (1.0f),
     m_FF_RW_button_type         (FF_RW_NONE),
     m_mute_group                (),         // boolean array, size 32 * 32
@@ -293,6 +501,14 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_clocks_per_metronome      (24),
     m_32nds_per_quarter         (8),
     m_us_per_quarter_note       (tempo_us_from_bpm(SEQ64_DEFAULT_BPM)),
+    m_tempo_map
+    (
+        std::make_shared<tempo_map>(m_ppqn, SEQ64_DEFAULT_BPM)
+    ),
+    m_tempo_map_stale           (true),
+    m_tempo_layout              (),
+    m_tempo_base_bpm            (SEQ64_DEFAULT_BPM),
+    m_tempo_segment             (-1),
     m_master_bus                (nullptr),
     m_filter_by_channel         (false),                /* "rc" option      */
     m_master_clocks             (),                     /* vector<clock_e>  */
@@ -302,6 +518,8 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_right_tick                (m_one_measure * 4),    /* m_ppqn * 16      */
     m_starting_tick             (0),
     m_tick                      (0),
+    m_tick_time_us              (0),
+    m_tick_mutex                (),
     m_jack_tick                 (0),
     m_usemidiclock              (false),
     m_midiclockrunning          (false),
@@ -312,6 +530,10 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_midi_cc_toggle            (),         // midi_control []
     m_midi_cc_on                (),         // midi_control []
     m_midi_cc_off               (),         // midi_control []
+    m_midi_control_block        (),         // short [256]
+    m_midi_control_starts       (),
+    m_midi_control_list         (),
+    m_midi_control_dirty        (true),
     m_control_status            (0),
     m_screenset                 (0),        // vice m_playscreen
     m_screenset_offset          (0),
@@ -324,6 +546,13 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_sequence_count            (0),
     m_sequence_max              (c_max_sequence),
     m_sequence_high             (-1),
+    m_play_set                  (),         // slot array [c_max_sequence]
+    m_play_set_count            (0),
+    m_play_set_mode             (false),
+    m_play_set_dirty            (true),
+    m_change_count              (0),
+    m_play_set_mutex            (),
+    m_frame_tick                (0),
 #ifdef SEQ64_EDIT_SEQUENCE_HIGHLIGHT
     m_edit_sequence             (-1),
 #endif
@@ -347,8 +576,13 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_have_redo                 (false),
     m_redo_vect                 (),          // vector of int
     m_notify                    (),          // vector of callback pointers
+    m_change_queues             (),          // array of queue pointers
+    m_change_queue_count        (0),
     m_gui_support               (mygui)
 {
+    for (int i = 0; i < SEQ64_CHANGE_SUBSCRIBERS_MAX; ++i)
+        m_change_queues[i] = nullptr;
+
     keys().group_max(m_max_groups);
     for (int i = 0; i < m_sequence_max; ++i)
     {
@@ -390,6 +624,9 @@ perform::~perform ()
     if (m_in_thread_launched)
         pthread_join(m_in_thread, NULL);
 
+    if (not_nullptr(m_master_bus))
+        m_master_bus->stop_sysex_thread();          /* before ports close   */
+
     for (int seq = 0; seq < m_sequence_high; ++seq) /* m_sequence_max       */
     {
         if (not_nullptr(m_seqs[seq]))
@@ -401,6 +638,16 @@ perform::~perform ()
 
     if (not_nullptr(m_master_bus))
         delete(m_master_bus);
+
+    for (int i = 0; i < SEQ64_CHANGE_SUBSCRIBERS_MAX; ++i)
+    {
+        change_queue * cq = m_change_queues[i];
+        if (not_nullptr(cq))
+        {
+            m_change_queues[i] = nullptr;
+            delete cq;
+        }
+    }
 }
 
 /**
@@ -1550,6 +1797,8 @@ perform::set_left_tick (midipulse tick, bool setstart)
     m_reposition = false;
     if (m_left_tick >= m_right_tick)
         m_right_tick = m_left_tick + m_one_measure;
+
+    notify_change();
 }
 
 /**
@@ -1592,6 +1841,7 @@ perform::set_right_tick (midipulse tick, bool setstart)
 
             m_reposition = false;
         }
+        notify_change();
     }
 }
 
@@ -1647,6 +1897,9 @@ perform::install_sequence (sequence * seq, int seqnum)
 
         result = true;                  /* a modification occurred  */
     }
+    if (result)
+        play_set_changed();
+
     return result;
 }
 
@@ -1783,6 +2036,7 @@ perform::delete_sequence (int seq)
             m_seqs[seq]->set_playing(false);
             delete m_seqs[seq];
             m_seqs[seq] = nullptr;
+            play_set_changed();
             modify();                               /* it is dirty, man     */
         }
     }
@@ -1816,6 +2070,7 @@ perform::set_active (int seq, bool active)
             if (m_seqs[seq]->name().empty())
                 m_seqs[seq]->set_name(std::string("Untitled"));
         }
+        post_change(seq, CHANGE_SEQUENCE);
     }
 }
 
@@ -1958,6 +2213,241 @@ perform::is_dirty_names (int seq)
     return was_active;
 }
 
+/**
+ *  Registers a view for change records, which replace the polling of the
+ *  is_dirty_*() functions for each pattern slot.  The view then calls
+ *  poll_changes() once per frame, and unsubscribe_changes() when it is
+ *  destroyed.  The first poll always yields a record for the performance
+ *  (SEQ64_NULL_SEQUENCE) holding all of the interests, as a prompt to redraw
+ *  everything.
+ *
+ *  To be called from a user-interface thread.
+ *
+ * \param interests
+ *      The change_t flags the view cares about, CHANGE_ALL by default.  A
+ *      view that shows only the tempo and screen-set need not be handed a
+ *      record for every pattern edit.
+ *
+ * \return
+ *      Returns the subscriber number to pass to the other functions, or -1
+ *      if SEQ64_CHANGE_SUBSCRIBERS_MAX views are already subscribed.
+ */
+
+int
+perform::subscribe_changes (unsigned interests)
+{
+    for (int i = 0; i < SEQ64_CHANGE_SUBSCRIBERS_MAX; ++i)
+    {
+        change_queue * cq = m_change_queues[i];
+        if (is_nullptr(cq))
+        {
+            cq = new change_queue(c_max_sequence);
+            change_queue * expected = nullptr;
+            if (! m_change_queues[i].compare_exchange_strong(expected, cq))
+            {
+                delete cq;                      /* another view got here    */
+                cq = expected;
+            }
+            else
+            {
+                std::atomic<int> & highwater = m_change_queue_count;
+                int count = highwater;
+                while (count <= i)              /* reloaded if CAS fails    */
+                {
+                    if (highwater.compare_exchange_weak(count, i + 1))
+                        break;
+                }
+            }
+        }
+        if (cq->claim(interests))
+            return i;
+    }
+    errprint("perform::subscribe_changes(): too many subscribers");
+    return (-1);
+}
+
+/**
+ *  Stops the change records for a view.  Its queue is kept for the next
+ *  subscriber.
+ *
+ * \param subscriber
+ *      The number returned by subscribe_changes().  Ignored if out of range.
+ */
+
+void
+perform::unsubscribe_changes (int subscriber)
+{
+    if (subscriber >= 0 && subscriber < SEQ64_CHANGE_SUBSCRIBERS_MAX)
+    {
+        change_queue * cq = m_change_queues[subscriber];
+        if (not_nullptr(cq))
+            cq->release();
+    }
+}
+
+/**
+ *  Hands a view the changes posted since its last poll, one coalesced record
+ *  per pattern (or for the performance).  No mutex is locked.
+ *
+ * \param subscriber
+ *      The number returned by subscribe_changes().
+ *
+ * \param [out] changes
+ *      Cleared, then filled with the change records.
+ *
+ * \return
+ *      Returns the number of records.  Returns 0 if the subscriber number is
+ *      invalid.
+ */
+
+int
+perform::poll_changes (int subscriber, ChangeList & changes)
+{
+    changes.clear();
+    if (subscriber >= 0 && subscriber < SEQ64_CHANGE_SUBSCRIBERS_MAX)
+    {
+        change_queue * cq = m_change_queues[subscriber];
+        if (not_nullptr(cq))
+            return cq->drain(changes);
+    }
+    return 0;
+}
+
+/**
+ *  Reports a change to every subscribed view, and bumps the change count.
+ *  Called by sequence (edits and mute changes) and by the perform setters.
+ *
+ * \threadsafe
+ *      Lock-free; it is called from the input and output threads as well.
+ *
+ * \param seq
+ *      The number of the pattern that changed, or SEQ64_NULL_SEQUENCE for a
+ *      change to the performance as a whole.
+ *
+ * \param changes
+ *      The change_t flags describing the change.
+ */
+
+void
+perform::post_change (int seq, unsigned changes)
+{
+    if (seq == m_tempo_track_number && (changes & CHANGE_SEQUENCE) != 0)
+        m_tempo_map_stale = true;
+
+    int count = m_change_queue_count;
+    for (int i = 0; i < count; ++i)
+    {
+        change_queue * cq = m_change_queues[i];
+        if (not_nullptr(cq) && cq->active())
+            cq->post(seq, changes);
+    }
+    notify_change();
+}
+
+/**
+ *  Gets the tempo map, first rebuilding it if the tempo track (its events,
+ *  triggers, length, or song-mute status) or the base tempo has changed
+ *  since it was built.  The map converts between pulses
+ *  and time for seeking, JACK positioning, and the time displays, in songs
+ *  with tempo changes.
+ *
+ *  Rebuilding allocates the map and takes the lock of the tempo track, so
+ *  this function is called only from the user-interface side, in particular
+ *  from the GUI timer, which keeps the map up to date after edits.  The
+ *  output thread and the JACK callbacks use current_tempo_map() instead.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Returns the tempo map.  It is never null.
+ */
+
+TempoMap
+perform::get_tempo_map ()
+{
+    const sequence * s = get_sequence(m_tempo_track_number);
+    if (not_nullptr(s) && s->tempo_layout_changed(m_tempo_layout))
+        m_tempo_map_stale = true;
+
+    if (m_tempo_map_stale.exchange(false))
+        rebuild_tempo_map();
+
+    return std::atomic_load(&m_tempo_map);
+}
+
+/**
+ *  Publishes the edits of every pattern for playback, and refreshes their
+ *  thumbnails; see sequence::publish_edits().  Building a playback snapshot
+ *  copies the pattern's events, so, like get_tempo_map(), this function is
+ *  called only from the user-interface side:  the GUI timers, and the main
+ *  loop of the command-line version.  The output thread plays whatever was
+ *  last published, and the MIDI input thread only edits.
+ *
+ * \threadsafe
+ */
+
+void
+perform::publish_patterns ()
+{
+    for (int s = 0; s < m_sequence_high; ++s)
+    {
+        sequence * seq = get_sequence(s);
+        if (not_nullptr(seq))
+            seq->publish_edits();
+    }
+}
+
+/**
+ *  Builds a new tempo map from the base tempo and the Set Tempo events of
+ *  the tempo track, and publishes it.  The events are placed by the
+ *  trigger layout of the tempo track, at each song position where Song-mode
+ *  playback plays them, looping with the pattern; a song-muted or untriggered
+ *  tempo track adds no changes.  See sequence::fill_tempo_map().  Since the
+ *  segments may have moved, follow_tempo_map() is made to apply the tempo
+ *  again at the next position.
+ */
+
+void
+perform::rebuild_tempo_map ()
+{
+    std::shared_ptr<tempo_map> tmap =
+        std::make_shared<tempo_map>(m_ppqn, m_tempo_base_bpm);
+
+    const sequence * s = get_sequence(m_tempo_track_number);
+    if (not_nullptr(s))
+        s->fill_tempo_map(*tmap);
+
+    std::atomic_store(&m_tempo_map, TempoMap(tmap));
+    m_tempo_segment = -1;
+}
+
+/**
+ *  In Song mode, applies the tempo of the tempo-map segment containing the
+ *  given position, whenever the position moves into a different segment.
+ *  Called by set_tick(), both as playback advances and when the position is
+ *  set elsewhere, so the tempo is right for the new position without
+ *  replaying the tempo track from the start.  In Live mode the patterns
+ *  loop, so the Set Tempo events are applied as they are played instead.
+ *
+ *  This runs in the output thread, so it never rebuilds the map; an edit of
+ *  the tempo track is followed once the GUI timer has rebuilt it.
+ *
+ * \param tick
+ *      The new position.
+ */
+
+void
+perform::follow_tempo_map (midipulse tick)
+{
+    if (m_playback_mode)
+    {
+        TempoMap tmap = current_tempo_map();
+        int seg = tmap->segment(tick);
+        if (m_tempo_segment.exchange(seg) != seg)
+            apply_tempo(tmap->segment_bpm(seg));
+    }
+}
+
 /**
  *  Sets the value of the BPM into the master MIDI buss, after making
  *  sure it is squelched to be between 20 and 500.  Replaces
@@ -1970,6 +2460,12 @@ perform::is_dirty_names (int seq)
  *  changed the beats per minute.  This setting does get saved to the MIDI
  *  file, with the c_bpmtag.
  *
+ *  This value also becomes the base tempo of the tempo map, the tempo in
+ *  force until the first Set Tempo event of the tempo track.  So this
+ *  function is only for tempo changes made by the user or read from the
+ *  MIDI file.  Following the JACK transport, which may be in the middle of
+ *  a tempo ramp, uses apply_tempo() instead, leaving the base alone.
+ *
  * \param bpm
  *      Provides the beats/minute value to be set.  It is clamped, if
  *      necessary, between the values SEQ64_MINIMUM_BPM to SEQ64_MAXIMUM_BPM.
@@ -1979,6 +2475,27 @@ perform::is_dirty_names (int seq)
 
 void
 perform::set_beats_per_minute (midibpm bpm)
+{
+    apply_tempo(bpm);
+    if (m_tempo_base_bpm != m_bpm)
+    {
+        m_tempo_base_bpm = m_bpm;
+        m_tempo_map_stale = true;
+    }
+}
+
+/**
+ *  Makes a tempo the current one, without changing the base tempo of the
+ *  tempo map.  Used for the tempo changes of the song itself, from the tempo
+ *  map or from Set Tempo events, as well as by set_beats_per_minute().
+ *
+ * \param bpm
+ *      Provides the beats/minute value to be set.  It is clamped, if
+ *      necessary, between the values SEQ64_MINIMUM_BPM to SEQ64_MAXIMUM_BPM.
+ */
+
+void
+perform::apply_tempo (midibpm bpm)
 {
     if (bpm < SEQ64_MINIMUM_BPM)
         bpm = SEQ64_MINIMUM_BPM;
@@ -2004,6 +2521,10 @@ perform::set_beats_per_minute (midibpm bpm)
         m_master_bus->set_beats_per_minute(bpm);
         m_us_per_quarter_note = tempo_us_from_bpm(bpm);
         m_bpm = bpm;
+        if (is_running())
+            m_lookahead_reset = true;       /* reschedule at the new tempo  */
+
+        post_change(SEQ64_NULL_SEQUENCE, CHANGE_TEMPO);
 
         /*
          * Do we need to adjust the BPM of all of the sequences, including the
@@ -2302,6 +2823,24 @@ perform::midi_control_toggle (int ctl)
     return valid_midi_control_seq(ctl) ? m_midi_cc_toggle[ctl] : sm_mc_dummy ;
 }
 
+/**
+ *  Retrieves a const reference to a value from m_midi_cc_toggle[], for
+ *  callers that only read the control.
+ *
+ * \param ctl
+ *      Provides the index of the control.
+ *
+ * \return
+ *      Returns the "toggle" value if the control value is valid, or a
+ *      reference to sm_mc_dummy otherwise.
+ */
+
+const midi_control &
+perform::midi_control_toggle (int ctl) const
+{
+    return valid_midi_control_seq(ctl) ? m_midi_cc_toggle[ctl] : sm_mc_dummy ;
+}
+
 /**
  *  Retrieves a reference to a value from m_midi_cc_on[].
  *
@@ -2321,6 +2860,23 @@ perform::midi_control_on (int ctl)
     return valid_midi_control_seq(ctl) ? m_midi_cc_on[ctl] : sm_mc_dummy ;
 }
 
+/**
+ *  Retrieves a const reference to a value from m_midi_cc_on[].
+ *
+ * \param ctl
+ *      Provides the index of the control.
+ *
+ * \return
+ *      Returns the "on" value if the control value is valid, and a reference
+ *      to sm_mc_dummy otherwise.
+ */
+
+const midi_control &
+perform::midi_control_on (int ctl) const
+{
+    return valid_midi_control_seq(ctl) ? m_midi_cc_on[ctl] : sm_mc_dummy ;
+}
+
 /**
  *  Retrieves a reference to a value from m_midi_cc_off[].
  *
@@ -2339,6 +2895,23 @@ perform::midi_control_off (int ctl)
     return valid_midi_control_seq(ctl) ? m_midi_cc_off[ctl] : sm_mc_dummy ;
 }
 
+/**
+ *  Retrieves a const reference to a value from m_midi_cc_off[].
+ *
+ * \param ctl
+ *      Provides the index of the control.
+ *
+ * \return
+ *      Returns the "off" value if the control value is valid, and a reference
+ *      to sm_mc_dummy otherwise.
+ */
+
+const midi_control &
+perform::midi_control_off (int ctl) const
+{
+    return valid_midi_control_seq(ctl) ? m_midi_cc_off[ctl] : sm_mc_dummy ;
+}
+
 /**
  *  Copies the given string into m_screenset_notepad[].
  *
@@ -2450,6 +3023,7 @@ perform::set_screenset (int ss)
 #endif
         m_screenset_offset = screenset_offset(ss);
         unset_queued_replace();                 /* clear this new feature   */
+        post_change(SEQ64_NULL_SEQUENCE, CHANGE_SCREENSET);
     }
     return m_screenset;
 }
@@ -2557,36 +3131,162 @@ perform::set_playing_screenset ()
  *  offloading all these calls to a new sequence function.  Hence the new
  *  sequence::play_queue() function.
  *
- *  Finally, we stop the looping at m_sequence_high rather than
- *  m_sequence_max, to save a little time.
+ *  Finally, we visit only the sequences in the play set, rather than every
+ *  slot up to m_sequence_high.  Most slots are empty, muted, or (in Song
+ *  mode) without triggers, and play_queue() would lock each one only to
+ *  advance its last tick.  The set is rebuilt first if it has been marked
+ *  as changed, and sequences that have gone idle are parked afterward.
+ *
+ *  The sequences do not flush the events they play here; the buss is flushed
+ *  once at the end, for all of them.
+ *
+ *  With the [alsa-lookahead] option, the output thread passes a lookahead,
+ *  and the patterns are played that far past the current tick.  Their
+ *  events are then scheduled on the ALSA queue for the time they are due,
+ *  rather than sent now; see mastermidibase::play_at().
  *
  * \param tick
  *      Provides the tick at which to start playing.  This value is also
  *      copied to m_tick.
+ *
+ * \param lookahead
+ *      The number of ticks past \a tick to which the patterns are played.
+ *      Defaults to 0.
  */
 
 void
-perform::play (midipulse tick)
+perform::play (midipulse tick, midipulse lookahead)
 {
     set_tick(tick);
-    for (int seq = 0; seq < m_sequence_high; ++seq)
+
+    midipulse endtick = tick + lookahead;
+    if (m_play_set_dirty || m_play_set_mode != m_playback_mode)
+        rebuild_play_set();
+
+    for (int i = 0; i < m_play_set_count; ++i)
     {
-        sequence * s = get_sequence(seq);
+        sequence * s = get_sequence(m_play_set[i]);
         if (not_nullptr(s))
 #ifdef SEQ64_SONG_RECORDING
-            s->play_queue(tick, m_playback_mode, m_resume_note_ons);
+            s->play_queue(endtick, m_playback_mode, m_resume_note_ons);
 #else
-            s->play_queue(tick, m_playback_mode);
+            s->play_queue(endtick, m_playback_mode);
 #endif
     }
+    m_frame_tick = endtick + 1;                     /* next frame start */
     if (not_nullptr(m_master_bus))
-        m_master_bus->flush();                      /* flush MIDI buss  */
+        m_master_bus->flush();                      /* once per frame   */
+
+    park_idle_sequences();
+}
+
+/**
+ *  Rebuilds the play set from all of the slots, for the current playback
+ *  mode.  A sequence is included unless it is parked and still idle.  A
+ *  parked sequence that is no longer idle is unparked, taking up at the
+ *  start of the next frame.  Called only by the output thread.
+ */
+
+void
+perform::rebuild_play_set ()
+{
+    automutex locker(m_play_set_mutex);
+    m_play_set_dirty = false;                       /* before the scan  */
+    m_play_set_mode = m_playback_mode;
+    m_play_set_count = 0;
+    for (int seq = 0; seq < m_sequence_high; ++seq)
+    {
+        sequence * s = get_sequence(seq);
+        if (not_nullptr(s))
+        {
+            if (s->parked())
+            {
+                if (s->can_park(m_play_set_mode))
+                    continue;
+
+                s->unpark(m_frame_tick);
+            }
+            m_play_set[m_play_set_count++] = seq;
+        }
+    }
+}
+
+/**
+ *  Parks the sequences in the play set that can produce no output, and
+ *  drops them (and any deleted slots) from the set.  The flags checked by
+ *  sequence::can_park() are read without locking, so that the locks are
+ *  taken only in a frame in which some sequence has gone idle.  Called only
+ *  by the output thread.
+ */
+
+void
+perform::park_idle_sequences ()
+{
+    int first = 0;
+    for ( ; first < m_play_set_count; ++first)
+    {
+        sequence * s = get_sequence(m_play_set[first]);
+        if (is_nullptr(s) || s->can_park(m_play_set_mode))
+            break;
+    }
+    if (first < m_play_set_count)
+    {
+        automutex locker(m_play_set_mutex);
+        int count = first;
+        for (int i = first; i < m_play_set_count; ++i)
+        {
+            sequence * s = get_sequence(m_play_set[i]);
+            if (not_nullptr(s) && ! s->park(m_play_set_mode))
+                m_play_set[count++] = m_play_set[i];
+        }
+        m_play_set_count = count;
+    }
+}
+
+/**
+ *  Copies the slot numbers of the sequences that set_orig_ticks(),
+ *  off_sequences(), and reset_sequences() need to visit.  That is the play
+ *  set, unless it has been marked as changed, in which case it might lack a
+ *  woken sequence, and all active slots are copied.  A parked sequence
+ *  needs no visit:  it is not playing, has no notes on, and takes its last
+ *  tick from m_frame_tick.
+ *
+ * \threadsafe
+ *
+ * \param slots
+ *      Provides the destination, which must hold c_max_sequence values.
+ *
+ * \return
+ *      Returns the number of slot numbers copied.
+ */
+
+int
+perform::play_set_slots (int * slots)
+{
+    automutex locker(m_play_set_mutex);
+    int count = 0;
+    if (m_play_set_dirty)
+    {
+        for (int s = 0; s < m_sequence_high; ++s)   /* m_sequence_max   */
+        {
+            if (is_active(s))
+                slots[count++] = s;
+        }
+    }
+    else
+    {
+        for ( ; count < m_play_set_count; ++count)
+            slots[count] = m_play_set[count];
+    }
+    return count;
 }
 
 /**
  *  For every pattern/sequence that is active, sets the "original tick"
  *  value for the pattern.  This is really the "last tick" value, so we
- *  renamed sequence::set_orig_tick() to sequence::set_last_tick().
+ *  renamed sequence::set_orig_tick() to sequence::set_last_tick().  Only the
+ *  play set is visited; the parked sequences get the new tick via
+ *  m_frame_tick.
  *
  * \param tick
  *      Provides the last-tick value to be set for each sequence that is
@@ -2596,10 +3296,14 @@ perform::play (midipulse tick)
 void
 perform::set_orig_ticks (midipulse tick)
 {
-    for (int s = 0; s < m_sequence_high; ++s)       /* m_sequence_max   */
+    int slots[c_max_sequence];
+    int count = play_set_slots(slots);
+    m_frame_tick = tick;
+    for (int i = 0; i < count; ++i)
     {
-        if (is_active(s))
-            m_seqs[s]->set_last_tick(tick);         /* set_orig_tick()  */
+        sequence * s = get_sequence(slots[i]);
+        if (not_nullptr(s))
+            s->set_last_tick(tick);                 /* set_orig_tick()  */
     }
 }
 
@@ -3079,7 +3783,7 @@ perform::inner_start (bool songmode)
     m_condition_var.lock();
     if (! is_running())
     {
-        playback_mode(songmode);
+        playback_mode(songmode);                    /* also dirties set */
         if (songmode)
             off_sequences();
 
@@ -3109,12 +3813,14 @@ perform::inner_stop (bool midiclock)
 {
     start_from_perfedit(false);
     is_running(false);
+    m_master_bus->cancel_scheduled();       /* drop pending lookahead   */
     reset_sequences();
     m_usemidiclock = midiclock;
 }
 
 /**
  *  For all active patterns/sequences, set the playing state to false.
+ *  Parked sequences are already off, so only the play set is visited.
  *
  *  Replaces "for (int s = 0; s < m_sequence_max; ++s)"
  */
@@ -3122,10 +3828,13 @@ perform::inner_stop (bool midiclock)
 void
 perform::off_sequences ()
 {
-    for (int s = 0; s < m_sequence_high; ++s)       /* modest speed-up */
+    int slots[c_max_sequence];
+    int count = play_set_slots(slots);
+    for (int i = 0; i < count; ++i)
     {
-        if (is_active(s))
-            m_seqs[s]->set_playing(false);
+        sequence * s = get_sequence(slots[i]);
+        if (not_nullptr(s))
+            s->set_playing(false);
     }
 }
 
@@ -3228,10 +3937,16 @@ void
 perform::reset_sequences (bool pause)
 {
     void (sequence::* f) (bool) = pause ? &sequence::pause : &sequence::stop ;
-    for (int s = 0; s < m_sequence_high; ++s)           /* m_sequence_max   */
+    int slots[c_max_sequence];
+    int count = play_set_slots(slots);
+    if (! pause)
+        m_frame_tick = 0;                               /* parked markers   */
+
+    for (int i = 0; i < count; ++i)
     {
-        if (is_active(s))
-            (m_seqs[s]->*f)(m_playback_mode);           /* (new parameter)  */
+        sequence * s = get_sequence(slots[i]);
+        if (not_nullptr(s))
+            (s->*f)(m_playback_mode);                   /* (new parameter)  */
     }
     m_master_bus->flush();                              /* flush MIDI buss  */
 }
@@ -3591,6 +4306,51 @@ perform::deinit_jack_transport ()
 #endif
 }
 
+#ifndef PLATFORM_WINDOWS
+
+/**
+ *  Provides the difference (a - b) between two CLOCK_MONOTONIC times.
+ *
+ * \param a
+ *      The later time.
+ *
+ * \param b
+ *      The earlier time.
+ *
+ * \return
+ *      Returns the difference in microseconds.
+ */
+
+static long
+timespec_diff_us (const struct timespec & a, const struct timespec & b)
+{
+    return long(a.tv_sec - b.tv_sec) * 1000000 + (a.tv_nsec - b.tv_nsec) / 1000;
+}
+
+/**
+ *  Moves a CLOCK_MONOTONIC time forward, keeping the nanoseconds normalized.
+ *
+ * \param t
+ *      The time to advance.
+ *
+ * \param us
+ *      The number of microseconds to add; must not be negative.
+ */
+
+static void
+timespec_add_us (struct timespec & t, long us)
+{
+    t.tv_sec += us / 1000000;
+    t.tv_nsec += (us % 1000000) * 1000;
+    if (t.tv_nsec >= 1000000000)
+    {
+        t.tv_nsec -= 1000000000;
+        ++t.tv_sec;
+    }
+}
+
+#endif  // ! PLATFORM_WINDOWS
+
 /**
  *  Performance output function.  This function is called by the free function
  *  output_thread_func().  Here's how it works:
@@ -3604,6 +4364,16 @@ perform::deinit_jack_transport ()
  *      clock tick drift here, which relies on using long and long long
  *      values.  See the Changelog for seq24 0.9.3.
  *
+ *  On Linux, the thread wakes on a grid of absolute CLOCK_MONOTONIC
+ *  deadlines, using clock_nanosleep() with TIMER_ABSTIME, rather than
+ *  sleeping for a relative period computed from a measured elapsed time.
+ *  The ticks are advanced by the spacing of the grid, not by the measured
+ *  sleep, so wake-up jitter does not accumulate into tempo error, and an
+ *  NTP step of the wall clock has no effect.  If a pass overruns the grid by
+ *  more than a whole period, the grid is restarted from the current time,
+ *  and the ticks follow the measured time for that pass, so none are lost.
+ *  Run with the --priority option to also get SCHED_FIFO scheduling.
+ *
  * \warning
  *      Valgrind shows that output_func() is being called before the JACK
  *      client pointer is being initialized!!!
@@ -3634,11 +4404,12 @@ perform::output_func ()
 #else                                       // not Windows
         struct timespec last;               // beginning time
         struct timespec current;            // current time
+        struct timespec deadline;           // next wake-up on the grid
 #ifdef SEQ64_STATISTICS_SUPPORT
         struct timespec stats_loop_start;
         struct timespec stats_loop_finish;
-#endif
         struct timespec delta;              // difference between last & current
+#endif
 #endif
 
         jack_scratchpad pad;
@@ -3689,6 +4460,9 @@ perform::output_func ()
         long stats_clock_width_us = 0;
         long stats_all[100];                // why 100?
         long stats_clock[100];
+        long stats_frames = 0;              // passes that played events
+        long stats_plays = m_master_bus->play_count();
+        long stats_flushes = m_master_bus->flush_count();
         if (rc().stats())                   // \change ca 2016-01-24
         {
             for (int i = 0; i < 100; ++i)
@@ -3734,7 +4508,8 @@ perform::output_func ()
         if (rc().stats())
             stats_last_clock_us = last * 1000;
 #else
-        clock_gettime(CLOCK_REALTIME, &last);   // get start time position
+        clock_gettime(CLOCK_MONOTONIC, &last);  // get start time position
+        deadline = last;                        // the grid starts here
         if (rc().stats())
             stats_last_clock_us = (last.tv_sec*1000000) + (last.tv_nsec/1000);
 #endif
@@ -3744,7 +4519,8 @@ perform::output_func ()
 #ifdef PLATFORM_WINDOWS
         last = timeGetTime();                   // get start time position
 #else
-        clock_gettime(CLOCK_REALTIME, &last);   // get start time position
+        clock_gettime(CLOCK_MONOTONIC, &last);  // get start time position
+        deadline = last;                        // the grid starts here
 #endif
 
 #endif  // SEQ64_STATISTICS_SUPPORT
@@ -3765,7 +4541,7 @@ perform::output_func ()
 #ifdef PLATFORM_WINDOWS
                 stats_loop_start = timeGetTime();
 #else
-                clock_gettime(CLOCK_REALTIME, &stats_loop_start);
+                clock_gettime(CLOCK_MONOTONIC, &stats_loop_start);
 #endif
             }
 #endif  // SEQ64_STATISTICS_SUPPORT
@@ -3779,10 +4555,17 @@ perform::output_func ()
             delta = current - last;
             long delta_us = delta * 1000;
 #else
-            clock_gettime(CLOCK_REALTIME, &current);
-            delta.tv_sec  = current.tv_sec - last.tv_sec;       // delta!
-            delta.tv_nsec = current.tv_nsec - last.tv_nsec;     // delta!
-            long delta_us = (delta.tv_sec * 1000000) + (delta.tv_nsec / 1000);
+            /*
+             * If we woke within a period of the deadline, count time from
+             * the deadline itself, so the ticks advance by the grid spacing
+             * and the wake-up latency is not accumulated.
+             */
+
+            clock_gettime(CLOCK_MONOTONIC, &current);
+            if (timespec_diff_us(current, deadline) < c_thread_trigger_width_us)
+                current = deadline;
+
+            long delta_us = timespec_diff_us(current, last);
 #endif
             midibpm bpm  = m_master_bus->get_beats_per_minute();
 
@@ -3879,6 +4662,7 @@ perform::output_func ()
 
             if (change_position)
             {
+                m_master_bus->cancel_scheduled();   /* drop the lookahead   */
                 set_orig_ticks(m_starting_tick);
                 m_starting_tick = m_left_tick;      // restart at left marker
                 m_reposition = false;
@@ -3965,7 +4749,45 @@ perform::output_func ()
                         play(midipulse(pad.js_current_tick));       // play!
                 }
                 else
-                    play(midipulse(pad.js_current_tick));           // play!
+                {
+                    /*
+                     * With the [alsa-lookahead] option, anchor the current
+                     * tick to the ALSA queue time and play ahead of it, but
+                     * not past the loop end.  A tempo change throws away
+                     * what was scheduled at the old tempo and plays it again
+                     * from here.  If the API cannot schedule, the anchor is
+                     * refused and we play directly as usual.
+                     */
+
+                    midipulse tick = midipulse(pad.js_current_tick);
+                    int lookaheadms = m_usemidiclock ?
+                        0 : rc().alsa_lookahead_ms() ;
+
+                    midipulse lookahead = 0;
+                    if (m_lookahead_reset)
+                    {
+                        m_lookahead_reset = false;
+                        if (lookaheadms > 0)
+                        {
+                            m_master_bus->cancel_scheduled();
+                            set_orig_ticks(tick);
+                        }
+                    }
+                    if (m_master_bus->set_schedule_anchor(tick, lookaheadms))
+                    {
+                        lookahead = midipulse
+                        (
+                            double(bpm) * ppqn * lookaheadms / 60000.0
+                        );
+                        if (perfloop)
+                        {
+                            midipulse room = get_right_tick() - 1 - tick;
+                            if (lookahead > room)
+                                lookahead = room > 0 ? room : 0 ;
+                        }
+                    }
+                    play(tick, lookahead);                          // play!
+                }
 
                 /*
                  * The next line enables proper pausing in both old and seq32
@@ -3987,6 +4809,7 @@ perform::output_func ()
 #ifdef SEQ64_STATISTICS_SUPPORT
                 if (rc().stats())
                 {
+                    ++stats_frames;
                     while (stats_total_tick <= pad.js_total_tick)
                     {
                         /*
@@ -4029,12 +4852,6 @@ perform::output_func ()
             current = timeGetTime();
             delta = current - last;
             long elapsed_us = delta * 1000;
-#else
-            clock_gettime(CLOCK_REALTIME, &current);
-            delta.tv_sec  = current.tv_sec  - last.tv_sec;
-            delta.tv_nsec = current.tv_nsec - last.tv_nsec;
-            long elapsed_us = (delta.tv_sec * 1000000) + (delta.tv_nsec / 1000);
-#endif
 
             /**
              * Now we want to trigger every c_thread_trigger_width_us, and it
@@ -4042,6 +4859,16 @@ perform::output_func ()
              */
 
             delta_us = c_thread_trigger_width_us - elapsed_us;
+#else
+
+            /**
+             * Now we want to trigger every c_thread_trigger_width_us, which
+             * is the spacing of the deadline grid.  The time it took us to
+             * play() does not matter, as the deadlines are absolute.
+             */
+
+            delta_us = c_thread_trigger_width_us;
+#endif
 
             /**
              * Check MIDI clock adjustment.  Note that we replaced
@@ -4058,16 +4885,11 @@ perform::output_func ()
             if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
                 delta_us = long(next_clock_delta_us);
 
+#ifdef PLATFORM_WINDOWS
             if (delta_us > 0)
             {
-#ifdef PLATFORM_WINDOWS
                 delta = delta_us / 1000;
                 Sleep(delta);
-#else
-                delta.tv_sec = delta_us / 1000000;
-                delta.tv_nsec = (delta_us % 1000000) * 1000;
-                nanosleep(&delta, NULL);    /* nanosleep() is Linux */
-#endif
             }
 #ifdef SEQ64_STATISTICS_SUPPORT
             else
@@ -4078,6 +4900,36 @@ perform::output_func ()
                 }
             }
 #endif  // SEQ64_STATISTICS_SUPPORT
+#else
+            if (delta_us > 0)
+                timespec_add_us(deadline, delta_us);
+
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (timespec_diff_us(now, deadline) >= c_thread_trigger_width_us)
+            {
+                deadline = now;             /* overran; restart the grid    */
+#ifdef SEQ64_STATISTICS_SUPPORT
+                if (rc().stats())
+                {
+                    errprint("Underrun");
+                }
+#endif
+            }
+            else
+            {
+                while                       /* absolute, so EINTR is safe   */
+                (
+                    clock_nanosleep
+                    (
+                        CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL
+                    ) == EINTR
+                )
+                {
+                    // retry until the deadline
+                }
+            }
+#endif
 
 #ifdef SEQ64_STATISTICS_SUPPORT
             if (rc().stats())
@@ -4087,7 +4939,7 @@ perform::output_func ()
                 delta = stats_loop_finish - stats_loop_start;
                 long delta_us = delta * 1000;
 #else
-                clock_gettime(CLOCK_REALTIME, &stats_loop_finish);
+                clock_gettime(CLOCK_MONOTONIC, &stats_loop_finish);
                 delta.tv_sec  = stats_loop_finish.tv_sec-stats_loop_start.tv_sec;
                 delta.tv_nsec = stats_loop_finish.tv_nsec-stats_loop_start.tv_nsec;
                 long delta_us = (delta.tv_sec*1000000) + (delta.tv_nsec/1000);
@@ -4143,6 +4995,28 @@ perform::output_func ()
             {
                 printf("[%3d][%8ld]\n", i * 300, stats_clock[i]);
             }
+
+            /*
+             * Each event played used to cost a flush (an ALSA drain system
+             * call); now each frame is flushed once.
+             */
+
+            long plays = m_master_bus->play_count() - stats_plays;
+            long flushes = m_master_bus->flush_count() - stats_flushes;
+            printf("\n\n-- output flushes --\n");
+            printf
+            (
+                "events [%ld] flushes [%ld] frames [%ld] saved [%ld]\n",
+                plays, flushes, stats_frames, plays - flushes
+            );
+            if (stats_frames > 0)
+            {
+                printf
+                (
+                    "saved per frame [%.2f]\n",
+                    double(plays - flushes) / double(stats_frames)
+                );
+            }
         }
 #endif  // SEQ64_STATISTICS_SUPPORT
 
@@ -4784,7 +5658,10 @@ perform::set_thru (bool thru_active, int seq, bool toggle)
  *  This function encapsulates code in input_func() to make it easier to read
  *  and understand.
  *
- *  Here is the processing involved in this function .... TODO.
+ *  Rather than trying all g_midi_control_limit controls, this function looks
+ *  up the controls bound to the event's status and first data byte in the
+ *  table made by build_midi_control_index(), and tries only those, in the
+ *  same order.  The table is rebuilt first if the controls have changed.
  *
  *  Incorporates pull request #24, arnaud-jacquemin, issue #23 "MIDI
  *  controller toggles wrong pattern".
@@ -4803,16 +5680,108 @@ bool
 perform::midi_control_event (const event & ev)
 {
     bool result = false;
-    int offset = m_screenset_offset;
-    for (int ctl = 0; ctl < g_midi_control_limit; ++ctl, ++offset)  /* 84 */
+    if (m_midi_control_dirty)
     {
-        result = handle_midi_control_event(ev, ctl, offset);
-        if (result)
-            break;      /* differs from legacy behavior, which keeps going */
+        m_midi_control_dirty = false;               /* before the rebuild   */
+        build_midi_control_index();
+    }
+
+    int block = m_midi_control_block[ev.get_status()];
+    if (block >= 0)
+    {
+        midibyte d0, d1;
+        ev.get_data(d0, d1);
+
+        int k = block * (c_midi_control_statuses + 1) + d0;
+        int first = m_midi_control_starts[k];
+        int last = m_midi_control_starts[k + 1];
+        for (int i = first; i < last; ++i)
+        {
+            int ctl = m_midi_control_list[i];
+            int offset = m_screenset_offset + ctl;
+            result = handle_midi_control_event(ev, ctl, offset);
+            if (result)
+                break;  /* differs from legacy behavior, which keeps going */
+        }
     }
     return result;
 }
 
+/**
+ *  Rebuilds the lookup table used by midi_control_event().  Every active
+ *  toggle, on, and off setting of the first g_midi_control_limit controls
+ *  adds its control number under its (status, data) pair.  The pairs are
+ *  sorted, and laid out as one block of data-byte offsets per status byte in
+ *  use, each offset indexing the list of control numbers.  Called only by
+ *  the input thread.
+ */
+
+void
+perform::build_midi_control_index ()
+{
+    typedef std::pair<int, int> KeyControl;         /* status:data, control */
+    std::vector<KeyControl> pairs;
+    for (int ctl = 0; ctl < g_midi_control_limit; ++ctl)
+    {
+        const midi_control * settings[3] =
+        {
+            &m_midi_cc_toggle[ctl], &m_midi_cc_on[ctl], &m_midi_cc_off[ctl]
+        };
+        for (int m = 0; m < 3; ++m)
+        {
+            const midi_control & mc = *settings[m];
+            if
+            (
+                mc.active() &&
+                mc.status() >= 0 && mc.status() < c_midi_control_statuses &&
+                mc.data() >= 0 && mc.data() < c_midi_control_statuses
+            )
+            {
+                int key = mc.status() * c_midi_control_statuses + mc.data();
+                pairs.push_back(KeyControl(key, ctl));
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    const int blocksize = c_midi_control_statuses + 1;
+    int blocks = 0;
+    for (int s = 0; s < c_midi_control_statuses; ++s)
+        m_midi_control_block[s] = -1;
+
+    for (int i = 0; i < int(pairs.size()); ++i)
+    {
+        int status = pairs[i].first / c_midi_control_statuses;
+        if (m_midi_control_block[status] < 0)
+            m_midi_control_block[status] = short(blocks++);
+    }
+    m_midi_control_starts.assign(blocks * blocksize, 0);
+    m_midi_control_list.clear();
+    m_midi_control_list.reserve(pairs.size());
+    for (int i = 0; i < int(pairs.size()); ++i)
+    {
+        int status = pairs[i].first / c_midi_control_statuses;
+        int d0 = pairs[i].first % c_midi_control_statuses;
+        int k = m_midi_control_block[status] * blocksize + d0;
+        ++m_midi_control_starts[k + 1];                 /* count, for now   */
+        m_midi_control_list.push_back(short(pairs[i].second));
+    }
+
+    /*
+     * The blocks are in status order, as are the sorted pairs, so a running
+     * sum over all of the blocks turns the counts into offsets.  The first
+     * offset of a block carries the last offset of the block before it.
+     */
+
+    unsigned short total = 0;
+    for (int k = 0; k < int(m_midi_control_starts.size()); ++k)
+    {
+        total += m_midi_control_starts[k];
+        m_midi_control_starts[k] = total;
+    }
+}
+
 /**
  *  Code extracted from midi_control_event() to be re-used for handling
  *  shorter lists of events.
@@ -4840,9 +5809,14 @@ perform::handle_midi_control_event (const event & ev, int ctl, int offset)
     midibyte status = ev.get_status();
     midibyte d0 = 0, d1 = 0;                    /* do we need to zero them? */
     ev.get_data(d0, d1);
-    if (midi_control_toggle(ctl).match(status, d0))
+
+    const perform & cperf = *this;              /* read-only accessors      */
+    const midi_control & toggle = cperf.midi_control_toggle(ctl);
+    const midi_control & on = cperf.midi_control_on(ctl);
+    const midi_control & off = cperf.midi_control_off(ctl);
+    if (toggle.match(status, d0))
     {
-        if (midi_control_toggle(ctl).in_range(d1))
+        if (toggle.in_range(d1))
         {
             if (is_a_sequence)
             {
@@ -4858,9 +5832,9 @@ perform::handle_midi_control_event (const event & ev, int ctl, int offset)
             }
         }
     }
-    if (midi_control_on(ctl).match(status, d0))
+    if (on.match(status, d0))
     {
-        if (midi_control_on(ctl).in_range(d1))
+        if (on.in_range(d1))
         {
             if (is_a_sequence)
             {
@@ -4877,7 +5851,7 @@ perform::handle_midi_control_event (const event & ev, int ctl, int offset)
             else
                 result = handle_midi_control(ctl, true);
         }
-        else if (midi_control_on(ctl).inverse_active())
+        else if (on.inverse_active())
         {
             if (is_a_sequence)
             {
@@ -4895,9 +5869,9 @@ perform::handle_midi_control_event (const event & ev, int ctl, int offset)
                 result = handle_midi_control(ctl, false);
         }
     }
-    if (midi_control_off(ctl).match(status, d0))
+    if (off.match(status, d0))
     {
-        if (midi_control_off(ctl).in_range(d1))  /* Issue #35 */
+        if (off.in_range(d1))                   /* Issue #35                */
         {
             if (is_a_sequence)
             {
@@ -4914,7 +5888,7 @@ perform::handle_midi_control_event (const event & ev, int ctl, int offset)
             else
                 result = handle_midi_control(ctl, false);
         }
-        else if (midi_control_off(ctl).inverse_active())
+        else if (off.inverse_active())
         {
             if (is_a_sequence)
             {
@@ -5007,8 +5981,9 @@ perform::handle_midi_control_event (const event & ev, int ctl, int offset)
  *
  *      These messages are system-wide messages.  We filter system-wide
  *      messages.  If the master MIDI buss is dumping, set the timestamp of
- *      the event and stream it on the sequence.  Otherwise, use the event
- *      data to control the sequencer, if it is valid for that action.
+ *      the event to the pulse at which it arrived (see arrival_tick()) and
+ *      stream it on the sequence.  Otherwise, use the event data to control
+ *      the sequencer, if it is valid for that action.
  *
  *      "Dumping" is set when a seqedit window is open and the user has
  *      clicked the "record MIDI" or "thru MIDI" button.  In this case, if the
@@ -5035,6 +6010,7 @@ perform::input_func ()
         {
             do
             {
+                ev.set_timestamp(0);                /* arrival time unknown */
                 if (m_master_bus->get_midi_event(&ev))
                 {
                     /*
@@ -5110,7 +6086,11 @@ perform::input_func ()
                         {
                             if (! midi_control_record(ev))
                             {
-                                ev.set_timestamp(get_tick());
+                                int64_t arrival_us = arrival_us_from_stamp
+                                (
+                                    ev.get_timestamp(), monotonic_us()
+                                );
+                                ev.set_timestamp(arrival_tick(arrival_us));
                                 if (rc().show_midi())
                                     ev.print();
 
@@ -6552,6 +7532,10 @@ perform::reposition (midipulse tick)
  *  positioning (if applicable), calls the master bus's continue_from()
  *  function, and sets m_current_tick as well.
  *
+ *  It also notes the monotonic time at which the tick was set, for use by
+ *  arrival_tick(), and, in Song mode, sets the tempo of the tempo-map
+ *  segment at the tick; see follow_tempo_map().
+ *
  * \todo
  *      Do we really need m_current_tick???
  */
@@ -6579,7 +7563,12 @@ perform::set_tick (midipulse tick)
 
 #endif  // PLATFORM_DEBUG_TMI
 
-    m_tick = tick;
+    {
+        automutex locker(m_tick_mutex);
+        m_tick = tick;
+        m_tick_time_us = monotonic_us();
+    }
+    follow_tempo_map(tick);
 
     /*
      * \change ca 2017-12-30 Issue #123
@@ -6596,6 +7585,72 @@ perform::set_tick (midipulse tick)
 #endif
 }
 
+/**
+ *  Converts the arrival time of an incoming MIDI event into the pulse at
+ *  which it arrived.  The input busses stamp each event with its arrival
+ *  time on the monotonic_us() clock (for ALSA, converted from the real-time
+ *  stamp of the master queue; for JACK, the time of its frame), so the delay
+ *  in queuing and polling the event does not end up in the recorded timing.
+ *  Until this conversion, the event timestamp holds microseconds, not pulses
+ *  (possibly only their low 32 bits; see arrival_us_from_stamp()).
+ *  The pulse is extrapolated from the last tick set by the output thread,
+ *  and the time it was set, using the current tempo.
+ *
+ *  If the arrival time is unknown (0), or the pulse cannot be extrapolated
+ *  (not running, or following MIDI clock), the current tick is returned, as
+ *  before.  When looping in Song mode, a pulse at or past the right marker is
+ *  wrapped back into the loop.
+ *
+ * \param arrival_us
+ *      The arrival time of the event in microseconds on the monotonic clock,
+ *      or 0 if not known.
+ *
+ * \return
+ *      Returns the pulse at which the event arrived.
+ */
+
+midipulse
+perform::arrival_tick (int64_t arrival_us)
+{
+    midipulse tick;
+    int64_t tick_us;
+    {
+        automutex locker(m_tick_mutex);
+        tick = m_tick;
+        tick_us = m_tick_time_us;
+    }
+    if (arrival_us > 0 && tick_us > 0 && is_running() && ! m_usemidiclock)
+    {
+        double bpm = m_master_bus->get_beats_per_minute();
+        double pulses =
+            double(arrival_us - tick_us) * bpm * m_ppqn / 60000000.0;
+        tick += midipulse(pulses < 0.0 ? pulses - 0.5 : pulses + 0.5);
+        if (tick < 0)
+            tick = 0;
+
+        /*
+         * An event can arrive after the output thread has passed the loop
+         * end but before it has set the tick back to the left marker.  Wrap
+         * the tick into the loop the same way output_func() does.
+         */
+
+        bool perfloop = m_looping;
+        if (perfloop)
+        {
+            perfloop = m_playback_mode || start_from_perfedit() ||
+                song_start_mode();
+        }
+        if (perfloop)
+        {
+            midipulse ltick = get_left_tick();
+            midipulse rtick = get_right_tick();
+            if (rtick > ltick && tick >= rtick)
+                tick = ltick + (tick - rtick) % (rtick - ltick);
+        }
+    }
+    return tick;
+}
+
 /**
  *  Convenience function.  This function is used in the free function version
  *  of FF_RW_timeout() as a callback to the gtk_timeout() function.  It
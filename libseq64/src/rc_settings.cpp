@@ -110,6 +110,9 @@ rc_settings::rc_settings ()
 #endif
     m_manual_alsa_ports         (false),
     m_reveal_alsa_ports         (false),
+    m_alsa_lookahead_ms         (0),
+    m_undo_budget_kb            (SEQ64_UNDO_BUDGET_DEFAULT),
+    m_sysex_rate                (SEQ64_SYSEX_RATE_DEFAULT),
     m_print_keys                (false),
     m_device_ignore             (false),
     m_device_ignore_num         (0),
@@ -158,6 +161,9 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_with_jack_midi            (rhs.m_with_jack_midi),
     m_manual_alsa_ports         (rhs.m_manual_alsa_ports),
     m_reveal_alsa_ports         (rhs.m_reveal_alsa_ports),
+    m_alsa_lookahead_ms         (rhs.m_alsa_lookahead_ms),
+    m_undo_budget_kb            (rhs.m_undo_budget_kb),
+    m_sysex_rate                (rhs.m_sysex_rate),
     m_print_keys                (rhs.m_print_keys),
     m_device_ignore             (rhs.m_device_ignore),
     m_device_ignore_num         (rhs.m_device_ignore_num),
@@ -212,6 +218,9 @@ rc_settings::operator = (const rc_settings & rhs)
         m_with_jack_midi            = rhs.m_with_jack_midi;
         m_manual_alsa_ports         = rhs.m_manual_alsa_ports;
         m_reveal_alsa_ports         = rhs.m_reveal_alsa_ports;
+        m_alsa_lookahead_ms         = rhs.m_alsa_lookahead_ms;
+        m_undo_budget_kb            = rhs.m_undo_budget_kb;
+        m_sysex_rate                = rhs.m_sysex_rate;
         m_print_keys                = rhs.m_print_keys;
         m_device_ignore             = rhs.m_device_ignore;
         m_device_ignore_num         = rhs.m_device_ignore_num;
@@ -268,6 +277,9 @@ rc_settings::set_defaults ()
     m_with_jack_master_cond     = false;
     m_manual_alsa_ports         = false;
     m_reveal_alsa_ports         = false;
+    m_alsa_lookahead_ms         = 0;
+    m_undo_budget_kb            = SEQ64_UNDO_BUDGET_DEFAULT;
+    m_sysex_rate                = SEQ64_SYSEX_RATE_DEFAULT;
     m_print_keys                = false;
     m_device_ignore             = false;
     m_device_ignore_num         = 0;
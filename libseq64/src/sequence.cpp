@@ -42,6 +42,7 @@
  */
 
 #include <string.h>                     /* C::memset()                      */
+#include <algorithm>                    /* std::sort(), std::lower_bound()  */
 
 #include "calculations.hpp"
 #include "mastermidibus.hpp"
@@ -49,6 +50,7 @@
 #include "scales.h"
 #include "sequence.hpp"
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
 
 /**
  *  Enables and marks a user's patch for issue #95.
@@ -91,12 +93,20 @@ sequence::sequence (int ppqn)
     m_parent                    (nullptr),      // set when sequence installed
     m_events                    (),
     m_triggers                  (*this),
-    m_events_undo_hold          (),             // stazed
+    m_hold_undo                 (false),        // stazed
     m_have_undo                 (false),        // stazed
     m_have_redo                 (false),        // stazed
     m_events_undo               (),
     m_events_redo               (),
+    m_undo_journal              (),
+    m_undo_pending              (false),
+    m_undo_bytes                (0),
     m_iterator_draw             (m_events.begin()),
+    m_note_index                (),
+    m_note_extras               (),
+    m_note_span                 (0),
+    m_note_index_edit_count     (0),
+    m_note_index_stale          (true),
     m_channel_match             (false),        // stazed
     m_midi_channel              (0),
     m_bus                       (0),
@@ -131,12 +141,24 @@ sequence::sequence (int ppqn)
     m_dirty_edit                (true),
     m_dirty_perf                (true),
     m_dirty_names               (true),
+    m_change_count              (0),
     m_editing                   (false),
     m_raise                     (false),
     m_name                      (),
     m_last_tick                 (0),
     m_queued_tick               (0),            /* used by perform::play()   */
     m_trigger_offset            (0),            /* needed for record-keeping */
+    m_parked                    (false),
+    m_play_cursor               (0),
+    m_play_offset_base          (0),
+    m_play_next_tick            (0),
+    m_play_offset               (0),
+    m_play_edit_count           (0),
+    m_play_cursor_valid         (false),
+    m_snapshot                  (),
+    m_thumbnail                 (),
+    m_thumb_width               (0),
+    m_thumb_height              (0),
     m_maxbeats                  (c_maxbeats),
     m_ppqn                      (0),            /* set in constructor body   */
     m_seq_number                (-1),           /* may be set later          */
@@ -156,6 +178,7 @@ sequence::sequence (int ppqn)
     m_musical_scale             (int(c_scale_off)),
     m_background_sequence       (SEQ64_SEQUENCE_LIMIT),
     m_mutex                     (),
+    m_play_mutex                (),
     m_note_off_margin           (2)
 {
     m_ppqn = choose_ppqn(ppqn);
@@ -236,11 +259,12 @@ sequence::partial_assign (const sequence & rhs)
 }
 
 /**
- *  Modifies the undo-hold container.
+ *  Starts or ends the undo hold of an LFO or seqdata drag.  Starting it
+ *  sets an undo checkpoint, so that all the changes of the drag are
+ *  recorded; push_undo(true) then makes them one undo record.
  *
  * \param hold
- *      If true, then the events in the m_events container are added to the
- *      m_events_undo_hold container.  Otherwise, that container is cleared.
+ *      If true, the hold starts.  Otherwise, it ends.
  */
 
 void
@@ -248,12 +272,9 @@ sequence::set_hold_undo (bool hold)
 {
     automutex locker(m_mutex);
     if (hold)
-    {
-        for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
-            m_events_undo_hold.add(DREF(i));
-    }
-    else
-       m_events_undo_hold.clear();
+        checkpoint_undo();
+
+    m_hold_undo = hold;
 }
 
 /**
@@ -275,13 +296,16 @@ sequence::event_count () const
 }
 
 /**
- *  Pushes the event-list into the undo-list or the upcoming undo-hold-list.
+ *  Sets an undo checkpoint before an edit of the event-list.  The events
+ *  that the edit adds, removes, or changes are recorded as it is made; see
+ *  checkpoint_undo().
  *
  * \threadsafe
  *
  * \param hold
- *      A new parameter for the stazed undo/redo support, not yet used.
- *      If true, then the events go into the undo-hold-list.
+ *      A new parameter for the stazed undo/redo support.  If true, this
+ *      call ends an LFO or seqdata drag, whose changes have been recorded
+ *      since set_hold_undo(true), and they are made into one undo record.
  */
 
 void
@@ -289,18 +313,123 @@ sequence::push_undo (bool hold)
 {
     automutex locker(m_mutex);
     if (hold)
-        m_events_undo.push(m_events_undo_hold);     // stazed
+    {
+        seal_undo();                                // stazed
+        set_have_undo();
+        set_have_redo();
+    }
     else
-        m_events_undo.push(m_events);
+        checkpoint_undo();
+}
 
+/**
+ *  Sets an undo checkpoint without locking.  Any edit record still pending
+ *  from the previous checkpoint is made first.  Then m_events starts to
+ *  record its changes into m_undo_journal.  The redo records are not
+ *  discarded here, since the edit may turn out to change nothing; see
+ *  seal_undo().
+ *
+ * \threadunsafe
+ */
+
+void
+sequence::checkpoint_undo ()
+{
+    seal_undo();
+    m_undo_journal.ed_removed.clear();
+    m_undo_journal.ed_added.clear();
+    m_events.journal(&m_undo_journal);
+    m_undo_pending = true;
     set_have_undo();                                // stazed
+    set_have_redo();
+}
+
+/**
+ *  Ends the pending edit record, if any, and pushes it onto the undo log,
+ *  unless the edit changed nothing.  Events that the edit added and then
+ *  removed again are dropped from the record first.  An edit that changed
+ *  something invalidates the redo records, which describe a different
+ *  history, so they are discarded; a no-op edit, such as a click that
+ *  selected nothing, keeps them.  The cost depends only on the size of the
+ *  edit.  Edits made when no checkpoint is pending are not recorded, and,
+ *  as with the old full-copy undo, they cannot be undone separately.
+ *
+ * \threadunsafe
+ */
+
+void
+sequence::seal_undo ()
+{
+    if (m_undo_pending)
+    {
+        m_undo_pending = false;
+        m_events.journal(nullptr);
+        event_list::cancel_common(m_undo_journal);
+        bool changed =
+            ! m_undo_journal.ed_removed.empty() ||
+            ! m_undo_journal.ed_added.empty();
+
+        if (changed)
+        {
+            clear_redo();
+            m_undo_bytes += event_list::delta_bytes(m_undo_journal);
+            m_events_undo.push_back(event_list::edit_delta_t());
+            m_events_undo.back().ed_removed.swap(m_undo_journal.ed_removed);
+            m_events_undo.back().ed_added.swap(m_undo_journal.ed_added);
+            trim_undo();
+        }
+        m_undo_journal.ed_removed.clear();
+        m_undo_journal.ed_added.clear();
+    }
 }
 
 /**
- *  If there are items on the undo list, this function pushes the
- *  event-list into the redo-list, puts the top of the undo-list into the
- *  event-list, pops from the undo-list, calls verify_and_link(), and then
- *  calls unselect().
+ *  Discards the redo records.
+ *
+ * \threadunsafe
+ */
+
+void
+sequence::clear_redo ()
+{
+    for (UndoLog::size_type r = 0; r < m_events_redo.size(); ++r)
+        m_undo_bytes -= event_list::delta_bytes(m_events_redo[r]);
+
+    m_events_redo.clear();
+}
+
+/**
+ *  Drops the oldest undo records while the undo and redo records, plus the
+ *  record of the edit in progress, together exceed the [undo-budget] "rc"
+ *  setting.  The newest record, which is the one in progress if there is
+ *  one, is always kept.  A budget of 0 means no limit.
+ *
+ * \threadunsafe
+ */
+
+void
+sequence::trim_undo ()
+{
+    size_t budget = size_t(rc().undo_budget_kb()) * 1024;
+    if (budget == 0)
+        return;
+
+    size_t pending = m_undo_pending ?
+        event_list::delta_bytes(m_undo_journal) : 0 ;
+
+    size_t keep = m_undo_pending ? 0 : 1 ;
+    while (m_undo_bytes + pending > budget && m_events_undo.size() > keep)
+    {
+        m_undo_bytes -= event_list::delta_bytes(m_events_undo.front());
+        m_events_undo.pop_front();
+    }
+}
+
+/**
+ *  If there are items on the undo list, this function reverts the newest
+ *  edit record on the event-list, moves the record to the redo-list, calls
+ *  verify_and_link(), and then calls unselect().  The cost is one pass over
+ *  the event-list plus the size of the edit; no full copy is made.
  *
  *  We would like to be able to set perform's modify flag to false here, but
  *  other sequences might still be in a modified state.  We could add a modify
@@ -313,11 +442,14 @@ void
 sequence::pop_undo ()
 {
     automutex locker(m_mutex);
+    seal_undo();                                /* record the last edit     */
     if (! m_events_undo.empty())                // stazed: m_list_undo
     {
-        m_events_redo.push(m_events);           // move to triggers module?
-        m_events = m_events_undo.top();
-        m_events_undo.pop();
+        m_events_redo.push_back(event_list::edit_delta_t());
+        m_events_redo.back().ed_removed.swap(m_events_undo.back().ed_removed);
+        m_events_redo.back().ed_added.swap(m_events_undo.back().ed_added);
+        m_events_undo.pop_back();
+        m_events.apply(m_events_redo.back(), true);
         verify_and_link();
         unselect();
     }
@@ -326,10 +458,9 @@ sequence::pop_undo ()
 }
 
 /**
- *  If there are items on the redo list, this function pushes the
- *  event-list into the undo-list, puts the top of the redo-list into the
- *  event-list, pops from the redo-list, calls verify_and_link(), and then
- *  calls unselect.
+ *  If there are items on the redo list, this function re-applies the newest
+ *  redo record to the event-list, moves the record back to the undo-list,
+ *  calls verify_and_link(), and then calls unselect.
  *
  * \threadsafe
  */
@@ -338,11 +469,14 @@ void
 sequence::pop_redo ()
 {
     automutex locker(m_mutex);
+    seal_undo();                                /* record the last edit     */
     if (! m_events_redo.empty())                // move to triggers module?
     {
-        m_events_undo.push(m_events);
-        m_events = m_events_redo.top();
-        m_events_redo.pop();
+        m_events_undo.push_back(event_list::edit_delta_t());
+        m_events_undo.back().ed_removed.swap(m_events_redo.back().ed_removed);
+        m_events_undo.back().ed_added.swap(m_events_redo.back().ed_added);
+        m_events_redo.pop_back();
+        m_events.apply(m_events_undo.back());
         verify_and_link();
         unselect();
     }
@@ -374,6 +508,7 @@ sequence::pop_trigger_undo ()
 {
     automutex locker(m_mutex);
     m_triggers.pop_undo();
+    wake();
 }
 
 /**
@@ -387,6 +522,7 @@ sequence::pop_trigger_redo ()
 {
     automutex locker(m_mutex);
     m_triggers.pop_redo();
+    wake();
 }
 
 /**
@@ -1023,11 +1159,12 @@ sequence::toggle_queued ()
 {
     automutex locker(m_mutex);
     m_queued = ! m_queued;
-    m_queued_tick = m_last_tick - mod_last_tick() + m_length;
+    m_queued_tick = last_tick() - mod_last_tick() + m_length;
 #ifdef SEQ64_SONG_RECORDING
     m_off_from_snap = true;
 #endif
-    set_dirty_mp();
+    set_dirty_mute();
+    wake();
 }
 
 #ifdef SEQ64_USE_AUTO_SCREENSET_QUEUE
@@ -1049,7 +1186,7 @@ sequence::off_queued ()
 #ifdef SEQ64_SONG_RECORDING
     m_off_from_snap = true;
 #endif
-    set_dirty_mp();
+    set_dirty_mute();
 }
 
 /**
@@ -1067,7 +1204,8 @@ sequence::on_queued ()
 {
     automutex locker(m_mutex);
     m_queued = true;
-    set_dirty_mp();
+    set_dirty_mute();
+    wake();
 }
 
 #endif  // SEQ64_USE_AUTO_SCREENSET_QUEUE
@@ -1092,6 +1230,26 @@ sequence::on_queued ()
  *  function.  Its return value and side-effects tell if there's a change in
  *  playing based on triggers, and provides the ticks that bracket it.
  *
+ *  Seq24 started every frame at the beginning of the event list and skipped
+ *  forward to the start of the frame, which made each frame cost in
+ *  proportion to the position in the pattern.  We now save the index (and
+ *  loop-wrap offset) at which the frame ended, and resume there if the event
+ *  list has not been edited and the new frame is contiguous with the last
+ *  one.  Any edit, tick repositioning, length change, or trigger-offset
+ *  change falls back to the original scan.
+ *
+ *  The scan walks the contiguous playback array of the event list, touching
+ *  the full event only when it is emitted; see play_events().
+ *
+ *  The events are always played from the last published snapshot, which
+ *  play() never rebuilds; an edit is heard once publish_edits() has
+ *  published it.  In Live mode, a frame normally changes nothing but the
+ *  last tick, the playing notes, and the cursor, which m_play_mutex
+ *  protects.  So, if an editor holds m_mutex (a large paste or quantize,
+ *  say), the frame is played without waiting; see play_snapshot().  Song
+ *  mode, song recording, and the muting of a playing pattern can change the
+ *  state of the sequence, and still wait for m_mutex.
+ *
  * \param tick
  *      Provides the current end-tick value.  The tick comes in as a global
  *      tick.
@@ -1119,7 +1277,20 @@ sequence::play
 #endif
 )
 {
-    automutex locker(m_mutex);
+    bool nolock = ! playback_mode && ! (m_song_mute && m_playing);
+#ifdef SEQ64_SONG_RECORDING
+    if (nolock)
+        nolock = ! m_song_recording;
+#endif
+
+    automutex locker(m_mutex, nolock);      /* try-lock only if nolock      */
+    if (! locker.locked())
+    {
+        play_snapshot(tick);                /* an editor holds the lock     */
+        return;
+    }
+
+    automutex playlocker(m_play_mutex);
     bool trigger_turning_off = false;       /* turn off after in-frame play */
     midipulse start_tick = m_last_tick;     /* modified in triggers::play() */
     midipulse end_tick = tick;
@@ -1147,60 +1318,356 @@ sequence::play
             trigger_turning_off = m_triggers.play(start_tick, end_tick);
         }
     }
-    if (m_playing)                          /* play notes in frame          */
-    {
-        midipulse offset = m_length - m_trigger_offset;
-        midipulse start_tick_offset = start_tick + offset;
-        midipulse end_tick_offset = end_tick + offset;
-        midipulse times_played = m_last_tick / m_length;
-        midipulse offset_base = times_played * m_length;
+    if (m_playing && m_snapshot)            /* play notes in frame          */
+        play_events(*m_snapshot, start_tick, end_tick);
+    else
+        m_play_cursor_valid = false;
+
+    m_last_tick = end_tick + 1;                     /* for next frame       */
+    if (trigger_turning_off)                        /* triggers: "turn off" */
+        set_playing(false);                         /* note-offs at end     */
+
+    m_was_playing = m_playing;
+}
+
+/**
+ *  Plays a Live-mode frame from the last published snapshot, without
+ *  m_mutex, for play() when an editor holds that lock.  The snapshot
+ *  reflects the events as they were before the edit in progress; the edit
+ *  is heard once it is published.
+ *
+ * \threadsafe
+ *      Takes only m_play_mutex, which also guards the m_last_tick and
+ *      m_trigger_offset values that play_events() reads.
+ *
+ * \param tick
+ *      Provides the end tick of the frame.
+ */
+
+void
+sequence::play_snapshot (midipulse tick)
+{
+    automutex locker(m_play_mutex);
+    event_list::PlaybackSnapshot ps = std::atomic_load(&m_snapshot);
+    if (m_playing && ps)
+        play_events(*ps, m_last_tick, tick);
+    else
+        m_play_cursor_valid = false;
+
+    m_last_tick = tick + 1;                         /* for next frame       */
+    m_was_playing = m_playing;
+}
+
+/**
+ *  Emits the events of a playback snapshot that fall in the frame, resuming
+ *  at the playback cursor when that is still valid for the snapshot, and
+ *  saves the cursor for the next frame.  The pattern length used is that of
+ *  the snapshot, so that it always matches the events.
+ *
+ * \threadunsafe
+ *      The caller must hold m_play_mutex, which guards m_last_tick and
+ *      m_trigger_offset.
+ *
+ * \param ps
+ *      Provides the snapshot to play.
+ *
+ * \param start_tick
+ *      The first tick of the frame.
+ *
+ * \param end_tick
+ *      The last tick of the frame.
+ */
+
+void
+sequence::play_events
+(
+    const event_list::playback_snapshot_t & ps,
+    midipulse start_tick, midipulse end_tick
+)
+{
+    midipulse length = ps.ps_length;
+    midipulse offset = length - m_trigger_offset;
+    midipulse start_tick_offset = start_tick + offset;
+    midipulse end_tick_offset = end_tick + offset;
+    midipulse times_played = m_last_tick / length;
+    midipulse offset_base = times_played * length;
 #ifdef SEQ64_STAZED_TRANSPOSE
-        int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
+    int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
 #endif
-        event_list::iterator e = m_events.begin();
-        while (e != m_events.end())
+    const event_list::PlaybackArray & pa = ps.ps_records;
+    int count = int(pa.size());
+    int e = 0;
+    bool resume =
+        m_play_cursor_valid &&
+        m_play_edit_count == ps.ps_edit_count &&
+        m_play_next_tick == start_tick_offset &&
+        m_play_offset == offset;
+
+    if (resume)
+    {
+        e = m_play_cursor;                      /* first event not yet sent */
+        offset_base = m_play_offset_base;
+    }
+    while (e < count)
+    {
+        const event_list::playback_record_t & r = pa[e];
+        midipulse stamp = r.pr_timestamp + offset_base;
+        if (stamp >= start_tick_offset && stamp <= end_tick_offset)
         {
-            event & er = DREF(e);
-            midipulse stamp = er.get_timestamp() + offset_base;
-            if (stamp >= start_tick_offset && stamp <= end_tick_offset)
-            {
+            event & er = *r.pr_event;
 #ifdef SEQ64_STAZED_TRANSPOSE
-                if (transpose != 0 && er.is_note()) /* includes Aftertouch  */
-                {
-                    event transposed_event = er;    /* assign ALL members   */
-                    transposed_event.transpose_note(transpose);
-                    put_event_on_bus(transposed_event);
-                }
-                else
-                {
+            if (transpose != 0 && event::is_note_msg(r.pr_status))
+            {
+                event transposed_event = er;        /* assign ALL members   */
+                transposed_event.transpose_note(transpose);
+                put_event_on_bus(transposed_event, stamp - offset);
+            }
+            else
+            {
 #endif
-                    if (er.is_tempo())
+                if (r.pr_status == EVENT_MIDI_META)
+                {
+                    if
+                    (
+                        r.pr_channel == EVENT_META_SET_TEMPO &&
+                        not_nullptr(m_parent)
+                    )
                     {
-                        if (not_nullptr(m_parent))
-                            m_parent->set_beats_per_minute(er.tempo());
+                        /*
+                         * In Song mode, the tempo track's Set Tempo events
+                         * are applied by position, from the tempo map; see
+                         * perform::set_tick().
+                         */
+
+                        bool mapped = m_parent->playback_mode() &&
+                            number() == m_parent->get_tempo_track_number();
+
+                        if (! mapped)
+                            m_parent->apply_tempo(er.tempo());
                     }
-                    else if (! er.is_ex_data())
-                        put_event_on_bus(er);       /* frame still going    */
-#ifdef SEQ64_STAZED_TRANSPOSE
                 }
+                else if (r.pr_status != EVENT_MIDI_SYSEX)
+                    put_event_on_bus(er, stamp - offset);       /* in frame */
+#ifdef SEQ64_STAZED_TRANSPOSE
+            }
 #endif
+        }
+        else if (stamp > end_tick_offset)
+            break;                                  /* frame is done        */
+
+        ++e;                                        /* go to next event     */
+        if (e == count)                             /* did we hit the end ? */
+        {
+            e = 0;                                  /* yes, start over      */
+            offset_base += length;                  /* for another go at it */
+        }
+    }
+    m_play_cursor = e;                              /* resume here next     */
+    m_play_offset_base = offset_base;
+    m_play_next_tick = end_tick_offset + 1;
+    m_play_offset = offset;
+    m_play_edit_count = ps.ps_edit_count;
+    m_play_cursor_valid = true;
+}
+
+/**
+ *  Publishes a new playback snapshot if the events or the length have
+ *  changed since the last one.  Readers still holding the old snapshot keep
+ *  it alive until they are done with it.
+ *
+ * \threadunsafe
+ *      The caller must hold m_mutex.
+ */
+
+void
+sequence::publish ()
+{
+    if (m_events.playback_stale(m_length) || ! m_snapshot)
+        std::atomic_store(&m_snapshot, m_events.playback(m_length));
+}
+
+/**
+ *  Publishes the edits made since the last publication, and rebuilds the
+ *  thumbnail if a view has asked for one.  Building a snapshot copies the
+ *  whole event list, so this is done only on the user-interface side, from
+ *  perform::publish_patterns(), which the GUI timers (and the main loop of
+ *  the command-line version) call.  It costs nothing if there has been no
+ *  edit.
+ *
+ *  The thumbnail is therefore built on the GUI thread, not on a worker.
+ *  That is one pass over the snapshot just published, made only for a
+ *  pattern that was edited since the last timer tick, and it never runs on
+ *  the output or MIDI input threads.  A worker would have to hold m_mutex
+ *  (or copy the snapshot) while the timer waits for its result anyway,
+ *  since the slot is drawn in the same tick.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::publish_edits ()
+{
+    automutex locker(m_mutex);
+    publish();
+    if (m_thumb_width > 0)
+        build_thumbnail();
+}
+
+/**
+ *  Brings m_thumbnail up to date with the published snapshot, at the size
+ *  last asked for by thumbnail().  The note lines are scaled to the range of
+ *  notes (and tempo values) in the pattern; tempo lines are scaled to the
+ *  full 0 to 127 range.  Lone Note Ons and Note Offs, and notes that wrap
+ *  around, are drawn one pixel wide.  If the pattern has no notes, the
+ *  thumbnail has no lines.
+ *
+ * \threadunsafe
+ *      The caller must hold m_mutex.
+ */
+
+void
+sequence::build_thumbnail ()
+{
+    event_list::PlaybackSnapshot ps = m_snapshot;
+    if (! ps)
+        return;
+
+    Thumbnail current = m_thumbnail;
+    if
+    (
+        current && current->tn_edit_count == ps->ps_edit_count &&
+        current->tn_length == ps->ps_length &&
+        current->tn_width == m_thumb_width &&
+        current->tn_height == m_thumb_height
+    )
+    {
+        return;                                     /* still good           */
+    }
+
+    std::shared_ptr<thumbnail_t> tn = std::make_shared<thumbnail_t>();
+    int width = m_thumb_width;
+    int height = m_thumb_height;
+    midipulse length = ps->ps_length;
+    tn->tn_edit_count = ps->ps_edit_count;
+    tn->tn_length = length;
+    tn->tn_width = width;
+    tn->tn_height = height;
+
+    const event_list::PlaybackArray & records = ps->ps_records;
+    int low = SEQ64_MAX_DATA_VALUE;
+    int high = -1;
+    for (int i = 0; i < int(records.size()); ++i)
+    {
+        const event & e = *records[i].pr_event;
+        int note;
+        if (e.is_note_on() || e.is_note_off())
+            note = records[i].pr_d0;
+        else if (e.is_tempo())
+            note = int(tempo_to_note_value(e.tempo()));
+        else
+            continue;
+
+        if (note < low)
+            low = note;
+
+        if (note > high)
+            high = note;
+    }
+    if (high >= 0 && length > 0)
+    {
+        int range = high - low + 2;                 /* 2-pixel border       */
+        tn->tn_lines.reserve(records.size() / 2);
+        for (int i = 0; i < int(records.size()); ++i)
+        {
+            const event_list::playback_record_t & r = records[i];
+            const event & e = *r.pr_event;
+            midipulse tick_f = r.pr_timestamp;
+            int note;
+            thumb_line_t tl;
+            tl.tl_tempo = false;
+            if (e.is_note_on())
+            {
+                note = r.pr_d0;
+                if (r.pr_link >= 0)
+                    tick_f = records[r.pr_link].pr_timestamp;
             }
-            else if (stamp > end_tick_offset)
-                break;                              /* frame is done        */
+            else if (e.is_note_off())
+            {
+                if (r.pr_link >= 0)
+                    continue;                       /* drawn by its Note On */
 
-            ++e;                                    /* go to next event     */
-            if (e == m_events.end())                /* did we hit the end ? */
+                note = r.pr_d0;
+            }
+            else if (e.is_tempo())
             {
-                e = m_events.begin();               /* yes, start over      */
-                offset_base += m_length;            /* for another go at it */
+                note = int(tempo_to_note_value(e.tempo()));
+                tick_f = r.pr_link >= 0 ?
+                    records[r.pr_link].pr_timestamp : length ;
+
+                tl.tl_tempo = true;
             }
+            else
+                continue;
+
+            tl.tl_x0 = int(r.pr_timestamp * width / length);
+            tl.tl_x1 = int(tick_f * width / length);
+            if (tl.tl_x1 <= tl.tl_x0)
+                tl.tl_x1 = tl.tl_x0 + 1;
+
+            if (tl.tl_tempo)
+                tl.tl_y = height - height * (note + 1) / SEQ64_MAX_DATA_VALUE;
+            else
+                tl.tl_y = height - height * (note + 1 - low) / range;
+
+            tn->tn_lines.push_back(tl);
         }
     }
-    if (trigger_turning_off)                        /* triggers: "turn off" */
-        set_playing(false);
+    std::atomic_store(&m_thumbnail, Thumbnail(tn));
+}
 
-    m_last_tick = end_tick + 1;                     /* for next frame       */
-    m_was_playing = m_playing;
+/**
+ *  Provides the thumbnail of the pattern, scaled to the given size, for the
+ *  pattern slots of the main window.  The thumbnail is rebuilt only when an
+ *  edit has been published since it was built, or when the size changes;
+ *  otherwise the cached one is returned without locking the sequence, so
+ *  that redrawing a slot because the pattern was armed, muted, or queued
+ *  costs no pass over its events.
+ *
+ * \threadsafe
+ *
+ * \param width
+ *      The width of the area holding the notes, in pixels.
+ *
+ * \param height
+ *      The height of the area holding the notes, in pixels.
+ *
+ * \return
+ *      Returns the thumbnail.  It is null only if the size is not valid.
+ */
+
+Thumbnail
+sequence::thumbnail (int width, int height)
+{
+    Thumbnail tn = std::atomic_load(&m_thumbnail);
+    event_list::PlaybackSnapshot ps = std::atomic_load(&m_snapshot);
+    if
+    (
+        tn && ps && tn->tn_edit_count == ps->ps_edit_count &&
+        tn->tn_length == ps->ps_length &&
+        tn->tn_width == width && tn->tn_height == height
+    )
+    {
+        return tn;
+    }
+    if (width <= 0 || height <= 0)
+        return Thumbnail();
+
+    automutex locker(m_mutex);
+    m_thumb_width = width;
+    m_thumb_height = height;
+    publish();
+    build_thumbnail();
+    return m_thumbnail;
 }
 
 /**
@@ -1218,7 +1685,9 @@ sequence::verify_and_link ()
 }
 
 /**
- *  Links a new event.
+ *  Links a new event.  Only the notes added since the last linking are
+ *  examined, so recording into a large pattern stays cheap; see
+ *  event_list::link_appended().
  *
  * \threadsafe
  */
@@ -1227,7 +1696,7 @@ void
 sequence::link_new ()
 {
     automutex locker(m_mutex);
-    m_events.link_new();
+    m_events.link_appended();
 }
 
 /**
@@ -1247,10 +1716,14 @@ void
 sequence::remove (event_list::iterator i)
 {
     event & er = DREF(i);
-    if (er.is_note_off() && m_playing_notes[er.get_note()] > 0)
+    if (er.is_note_off())
     {
-        m_master_bus->play(m_bus, &er, m_midi_channel);
-        --m_playing_notes[er.get_note()];                   // ugh
+        automutex locker(m_play_mutex);
+        if (m_playing_notes[er.get_note()] > 0)
+        {
+            m_master_bus->play(m_bus, &er, m_midi_channel);
+            --m_playing_notes[er.get_note()];               // ugh
+        }
     }
     m_events.remove(i);                                     // erase(i)
 }
@@ -1358,7 +1831,7 @@ sequence::remove_selected ()
     automutex locker(m_mutex);
     if (m_events.mark_selected())
     {
-        m_events_undo.push(m_events);           /* push_undo() without lock */
+        checkpoint_undo();                      /* push_undo() without lock */
         (void) m_events.remove_marked();
         reset_draw_marker();
     }
@@ -1544,6 +2017,130 @@ sequence::get_clipboard_box
     }
 }
 
+/**
+ *  A tempo change, the pulse and the new tempo, as gathered by
+ *  fill_tempo_map().
+ */
+
+typedef std::pair<midipulse, midibpm> TempoChange;
+
+/**
+ *  Comparison function for sorting tempo changes by pulse only, so that a
+ *  stable sort keeps the changes at the same pulse in the order gathered.
+ *
+ * \param a
+ *      The first change.
+ *
+ * \param b
+ *      The second change.
+ *
+ * \return
+ *      Returns true if the first change is at an earlier pulse.
+ */
+
+static bool
+tempo_change_before (const TempoChange & a, const TempoChange & b)
+{
+    return a.first < b.first;
+}
+
+/**
+ *  Adds the Set Tempo events of this sequence to a tempo map, at the song
+ *  positions where Song-mode playback emits them.  Each trigger plays the
+ *  pattern from its start to its end, with the event at pulse t heard at
+ *  every song pulse congruent to t plus the trigger offset, modulo the
+ *  pattern length, as in play_events() and in the song export.  So a tempo
+ *  ramp is repeated for every loop of the pattern inside a trigger.  If the
+ *  pattern is song-muted, or has no triggers, it adds nothing, since it
+ *  then plays nothing in Song mode.
+ *
+ *  The changes are gathered and sorted first, so that the tempo map gets
+ *  them in pulse order, even if a box move has left the triggers out of
+ *  order.
+ *
+ * \threadsafe
+ *
+ * \param tmap
+ *      The tempo map to add the tempo changes to.
+ */
+
+void
+sequence::fill_tempo_map (tempo_map & tmap) const
+{
+    automutex locker(m_mutex);
+    midipulse len = m_length;
+    if (m_song_mute || len <= 0)
+        return;
+
+    std::vector<TempoChange> tempos;
+    event_list::const_iterator i;
+    for (i = m_events.begin(); i != m_events.end(); ++i)
+    {
+        const event & er = DREF(i);
+        if (er.is_tempo())
+            tempos.push_back(TempoChange(er.get_timestamp(), er.tempo()));
+    }
+    if (tempos.empty())
+        return;
+
+    std::vector<TempoChange> changes;
+    const triggers::List & trigs = m_triggers.triggerlist();
+    for (triggers::List::const_iterator t = trigs.begin(); t != trigs.end(); ++t)
+    {
+        midipulse start = t->tick_start();
+        midipulse offset = t->offset() % len;
+        for (int e = 0; e < int(tempos.size()); ++e)
+        {
+            midipulse phase = (tempos[e].first + offset - start) % len;
+            if (phase < 0)
+                phase += len;
+
+            for (midipulse tk = start + phase; tk <= t->tick_end(); tk += len)
+                changes.push_back(TempoChange(tk, tempos[e].second));
+        }
+    }
+    std::stable_sort(changes.begin(), changes.end(), tempo_change_before);
+    for (int c = 0; c < int(changes.size()); ++c)
+        tmap.add(changes[c].first, changes[c].second);
+}
+
+/**
+ *  Checks whether the events, triggers, length, or song-mute status of this
+ *  sequence differ from those saved in a tempo layout, and, if so, saves the
+ *  current ones.  Used by perform::get_tempo_map() to tell whether the tempo
+ *  map built from this sequence is stale, since trigger edits and song-mute
+ *  changes are not reported as edits of the pattern.
+ *
+ * \threadsafe
+ *
+ * \param layout
+ *      The layout saved when the tempo map was last checked.  It is updated
+ *      if it has changed.
+ *
+ * \return
+ *      Returns true if the layout has changed.
+ */
+
+bool
+sequence::tempo_layout_changed (tempo_layout_t & layout) const
+{
+    automutex locker(m_mutex);
+    bool result =
+        layout.tl_edit_count != m_events.edit_count() ||
+        layout.tl_trigger_count != m_triggers.edit_count() ||
+        layout.tl_length != m_length ||
+        layout.tl_song_mute != m_song_mute;
+
+    if (result)
+    {
+        layout.tl_edit_count = m_events.edit_count();
+        layout.tl_trigger_count = m_triggers.edit_count();
+        layout.tl_length = m_length;
+        layout.tl_song_mute = m_song_mute;
+    }
+    return result;
+}
+
 /**
  *  Counts the selected notes in the event list.
  *
@@ -1959,7 +2556,7 @@ sequence::move_selected_notes (midipulse delta_tick, int delta_note)
     if (mark_selected())                            /* locked recursively   */
     {
         automutex locker(m_mutex);
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        checkpoint_undo();                          /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
@@ -2114,7 +2711,7 @@ sequence::stretch_selected (midipulse delta_tick)
         automutex locker(m_mutex);
         unsigned first_ev = 0x7fffffff;             /* timestamp lower limit */
         unsigned last_ev = 0x00000000;              /* timestamp upper limit */
-        m_events_undo.push(m_events);               /* push_undo(), no lock  */
+        checkpoint_undo();                          /* push_undo(), no lock  */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
@@ -2203,7 +2800,7 @@ sequence::grow_selected (midipulse delta)
     if (mark_selected())                            /* locked recursively   */
     {
         automutex locker(m_mutex);                  /* lock it again, dude  */
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        checkpoint_undo();                          /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
@@ -2261,8 +2858,9 @@ sequence::randomize_selected
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
+    bool changed = false;
     automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo(), no lock  */
+    checkpoint_undo();                          /* push_undo(), no lock  */
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -2294,9 +2892,14 @@ sequence::randomize_selected
              */
 
             data[datidx] = datitem;
+            event previous = e;
             e.set_data(data[0], data[1]);
+            m_events.touch(previous, e);            /* edited in place      */
+            changed = true;
         }
     }
+    if (changed)
+        set_dirty();
 }
 
 void
@@ -2305,6 +2908,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
+    bool changed = false;
     automutex locker(m_mutex);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -2330,9 +2934,14 @@ sequence::adjust_data_handle (midibyte status, int adata)
              */
 
             data[datidx] = datitem;
+            event previous = e;
             e.set_data(data[0], data[1]);
+            m_events.touch(previous, e);            /* edited in place      */
+            changed = true;
         }
     }
+    if (changed)
+        set_dirty();
 }
 
 #endif   // USE_STAZED_RANDOMIZE_SUPPORT
@@ -2361,6 +2970,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
 void
 sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 {
+    bool changed = false;
     automutex locker(m_mutex);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -2369,13 +2979,19 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
         {
             if (er.get_status() == astat)   // && er.get_control == acontrol
             {
+                event previous = er;
                 if (event::is_two_byte_msg(astat))
                     er.increment_data2();
                 else if (event::is_one_byte_msg(astat))
                     er.increment_data1();
+
+                m_events.touch(previous, er);       /* edited in place      */
+                changed = true;
             }
         }
     }
+    if (changed)
+        set_dirty();
 }
 
 /**
@@ -2404,6 +3020,7 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 void
 sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 {
+    bool changed = false;
     automutex locker(m_mutex);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -2412,13 +3029,19 @@ sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
         {
             if (er.get_status() == astat)   // && er.get_control == acontrol
             {
+                event previous = er;
                 if (event::is_two_byte_msg(astat))
                     er.decrement_data2();
                 else if (event::is_one_byte_msg(astat))
                     er.decrement_data1();
+
+                m_events.touch(previous, er);       /* edited in place      */
+                changed = true;
             }
         }
     }
+    if (changed)
+        set_dirty();
 }
 
 /**
@@ -2573,7 +3196,7 @@ sequence::paste_selected (midipulse tick, int note)
     {
         automutex locker(m_mutex);
         event_list clipbd = m_events_clipboard;     /* copy the clipboard   */
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        checkpoint_undo();                          /* push_undo(), no lock */
         for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
         {
             event & e = DREF(i);
@@ -2743,6 +3366,7 @@ sequence::change_event_data_range
              * events differently.
              */
 
+            event previous = er;
             if (er.is_tempo())
             {
                 midibpm tempo = note_value_to_tempo(midibyte(newdata));
@@ -2757,9 +3381,12 @@ sequence::change_event_data_range
 
                 er.set_data(d0, d1);
             }
+            m_events.touch(previous, er);               /* edited in place  */
             result = true;
         }
     }
+    if (result)
+        set_dirty();
     return result;
 }
 
@@ -2809,6 +3436,7 @@ sequence::change_event_data_lfo
     double dlength = double(m_length);
     double dbw = double(m_time_beat_width);
     bool have_selection = false;            /* change only selected if true */
+    bool changed = false;
     if (get_num_selected_events(status, cc))
         have_selection = true;
 
@@ -2850,9 +3478,14 @@ sequence::change_event_data_lfo
             else if (event::is_one_byte_msg(status))
                 d0 = newdata;
 
+            event previous = e;
             e.set_data(d0, d1);
+            m_events.touch(previous, e);            /* edited in place      */
+            changed = true;
         }
     }
+    if (changed)
+        set_dirty();
 }
 
 #endif   // SEQ64_STAZED_LFO_SUPPORT
@@ -3273,7 +3906,7 @@ sequence::stream_event (event & ev)
                     if (! keepvelocity)
                         velocity = m_rec_vol;
 
-                    m_events_undo.push(m_events);       /* push_undo()      */
+                    checkpoint_undo();                  /* push_undo()      */
                     add_note                            /* more locking     */
                     (
                         mod_last_tick(), m_snap_tick - m_note_off_margin,
@@ -3286,7 +3919,10 @@ sequence::stream_event (event & ev)
                     --m_notes_on;
 
                 if (m_notes_on <= 0)
+                {
+                    automutex playlocker(m_play_mutex);
                     m_last_tick += m_snap_tick;
+                }
             }
         }
         if (m_thru)
@@ -3314,7 +3950,8 @@ sequence::stream_event (event & ev)
  *
  *  m_dirty_names is set to false in is_dirty_names(); m_dirty_names is set to
  *  false in is_dirty_main(); m_dirty_names is set to false in
- *  is_dirty_perf().
+ *  is_dirty_perf().  The change is also reported to the views through
+ *  notify_parent(), as a CHANGE_SEQUENCE.
  *
  * \threadunsafe
  */
@@ -3323,10 +3960,58 @@ void
 sequence::set_dirty_mp ()
 {
     m_dirty_names = m_dirty_main = m_dirty_perf = true;
+    notify_parent(CHANGE_SEQUENCE);
 }
 
 /**
- *  Call set_dirty_mp() and then sets the dirty flag for editing.
+ *  Like set_dirty_mp(), but for a change of the playing, queued, one-shot,
+ *  or song-mute status, which is reported as a CHANGE_MUTE, so that views
+ *  need not treat it as an edit of the pattern.
+ *
+ * \threadunsafe
+ */
+
+void
+sequence::set_dirty_mute ()
+{
+    m_dirty_names = m_dirty_main = m_dirty_perf = true;
+    notify_parent(CHANGE_MUTE);
+}
+
+/**
+ *  Bumps the change count of this sequence, which views compare instead of
+ *  consuming a flag, and posts the change to the subscribers of the parent
+ *  perform object.  A sequence without a number yet only bumps the parent's
+ *  change count.
+ *
+ * \threadsafe
+ *      Lock-free.
+ *
+ * \param changes
+ *      The change_t flags to post.
+ */
+
+void
+sequence::notify_parent (unsigned changes)
+{
+    ++m_change_count;
+    if (not_nullptr(m_parent))
+    {
+        if (number() >= 0)
+            m_parent->post_change(number(), changes);
+        else
+            m_parent->notify_change();
+    }
+}
+
+/**
+ *  Call set_dirty_mp() and then sets the dirty flag for editing.  Editors
+ *  call this function once an edit is complete, and the undo budget is
+ *  checked here against the edit record in progress.  The playback snapshot
+ *  and the thumbnail are not rebuilt here, since this function is also
+ *  called by the MIDI input thread for each recorded event; the edit is
+ *  published later by publish_edits(), which folds all the edits made
+ *  since the last publication into one pass.
  *
  * \threadsafe
  */
@@ -3334,8 +4019,13 @@ sequence::set_dirty_mp ()
 void
 sequence::set_dirty ()
 {
+    automutex locker(m_mutex);
+    if (m_undo_pending)
+        trim_undo();                        /* the edit counts, too     */
+
     set_dirty_mp();
     m_dirty_edit = true;
+    m_note_index_stale = true;
 }
 
 /**
@@ -3501,6 +4191,7 @@ sequence::add_trigger
 {
     automutex locker(m_mutex);
     m_triggers.add(tick, len, offset, fixoffset);
+    wake();
 }
 
 /**
@@ -3744,6 +4435,7 @@ void
 sequence::set_trigger_offset (midipulse trigger_offset)
 {
     automutex locker(m_mutex);
+    automutex playlocker(m_play_mutex);     /* play_snapshot() reads it     */
     if (m_length > 0)
     {
         m_trigger_offset = trigger_offset % m_length;
@@ -3838,6 +4530,7 @@ sequence::copy_triggers (midipulse starttick, midipulse distance)
 {
     automutex locker(m_mutex);
     m_triggers.copy(starttick, distance);
+    wake();
 }
 
 /**
@@ -4108,6 +4801,7 @@ sequence::paste_trigger (midipulse paste_tick)
 {
     automutex locker(m_mutex);          /* @new ca 2016-08-03   */
     m_triggers.paste(paste_tick);
+    wake();
 }
 
 /**
@@ -4154,7 +4848,8 @@ sequence::pause (bool song_mode)
  *
  * \warning
  *      This iterator is shared by about four GUI object, and they might
- *      interfere with each other!
+ *      interfere with each other!  The piano rolls use visit_notes()
+ *      instead, which gives each view its own list.
  *
  * \threadsafe
  */
@@ -4346,6 +5041,199 @@ sequence::get_next_note_event
     return DRAW_FIN;
 }
 
+/**
+ *  Compare an indexed note to a tick, for std::lower_bound() in
+ *  visit_notes(), and two indexed notes, for the sort in index_notes().
+ */
+
+static bool
+note_before (const event * e, midipulse tick)
+{
+    return e->get_timestamp() < tick;
+}
+
+static bool
+note_earlier (const event * e1, const event * e2)
+{
+    return e1->get_timestamp() < e2->get_timestamp();
+}
+
+/**
+ *  Rebuilds the time index of notes used by visit_notes().  Linked Note Ons
+ *  that do not wrap, and unlinked Note Ons and Note Offs, are indexed by
+ *  time-stamp; wrapped notes and tempo events are kept aside, since they can
+ *  show up anywhere in a time window.  Most edits keep the event list
+ *  sorted, but an in-place move might not have been sorted yet, so the index
+ *  is sorted itself.
+ *
+ * \threadunsafe
+ *      The caller must hold m_mutex.
+ */
+
+void
+sequence::index_notes ()
+{
+    m_note_index.clear();
+    m_note_extras.clear();
+    m_note_span = 0;
+    for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
+    {
+        event & e = DREF(i);
+        if (e.is_note_on() && e.is_linked())
+        {
+            midipulse tick_s = e.get_timestamp();
+            midipulse tick_f = e.get_linked()->get_timestamp();
+            if (tick_f < tick_s)
+            {
+                m_note_extras.push_back(&e);        /* wraps around         */
+            }
+            else
+            {
+                if (tick_f - tick_s > m_note_span)
+                    m_note_span = tick_f - tick_s;
+
+                m_note_index.push_back(&e);
+            }
+        }
+        else if (e.is_note_on() || (e.is_note_off() && ! e.is_linked()))
+            m_note_index.push_back(&e);
+        else if (e.is_tempo())
+            m_note_extras.push_back(&e);
+    }
+    std::stable_sort(m_note_index.begin(), m_note_index.end(), note_earlier);
+    m_note_index_edit_count = m_events.edit_count();
+    m_note_index_stale = false;
+}
+
+/**
+ *  Finds the notes that show up in a rectangle of the piano roll, and copies
+ *  what is needed to draw them into the caller's list.  This replaces
+ *  walking the whole pattern with reset_draw_marker() and
+ *  get_next_note_event(), which share one iterator among all of the views
+ *  and lock the sequence once per event.  Here the sequence is locked once,
+ *  the time index (see index_notes()) narrows the search to the notes that
+ *  can overlap the window, and each view iterates over its own list.
+ *
+ *  A linked note is found if any part of it lies in the window, even if it
+ *  starts before and ends after the window.  A lone Note On or Note Off is
+ *  found if its time-stamp lies in the window.  Tempo events are found if
+ *  the tempo line reaches the window; their note value is the tempo scaled
+ *  to 0 to 127, as in get_next_note_event().
+ *
+ * \threadsafe
+ *
+ * \param tick_start
+ *      The first tick of the window.
+ *
+ * \param tick_end
+ *      The last tick of the window.
+ *
+ * \param note_lo
+ *      The lowest note of the window.
+ *
+ * \param note_hi
+ *      The highest note of the window.
+ *
+ * \param [out] notes
+ *      The list to fill, which is cleared first.  The notes come out in
+ *      time order, followed by wrapped notes and tempo events.
+ *
+ * \return
+ *      Returns the number of notes found.
+ */
+
+int
+sequence::visit_notes
+(
+    midipulse tick_start, midipulse tick_end,
+    int note_lo, int note_hi, NoteInfoList & notes
+)
+{
+    automutex locker(m_mutex);
+    notes.clear();
+    if (m_note_index_stale || m_note_index_edit_count != m_events.edit_count())
+        index_notes();
+
+    std::vector<event *>::const_iterator ni = std::lower_bound
+    (
+        m_note_index.begin(), m_note_index.end(),
+        tick_start - m_note_span, note_before
+    );
+    for ( ; ni != m_note_index.end(); ++ni)
+    {
+        const event & e = **ni;
+        midipulse tick_s = e.get_timestamp();
+        if (tick_s > tick_end)
+            break;                                  /* past the window      */
+
+        int note = e.get_note();
+        if (note < note_lo || note > note_hi)
+            continue;
+
+        note_info_t info;
+        if (e.is_linked() && e.is_note_on())
+        {
+            info.ni_tick_finish = e.get_linked()->get_timestamp();
+            if (info.ni_tick_finish < tick_start)
+                continue;                           /* ends before window   */
+
+            info.ni_type = DRAW_NORMAL_LINKED;
+        }
+        else
+        {
+            if (tick_s < tick_start)
+                continue;
+
+            info.ni_tick_finish = 0;
+            info.ni_type = e.is_note_on() ? DRAW_NOTE_ON : DRAW_NOTE_OFF;
+        }
+        info.ni_tick_start = tick_s;
+        info.ni_note = note;
+        info.ni_velocity = e.get_note_velocity();
+        info.ni_selected = e.is_selected();
+        notes.push_back(info);
+    }
+    for
+    (
+        std::vector<event *>::const_iterator xi = m_note_extras.begin();
+        xi != m_note_extras.end(); ++xi
+    )
+    {
+        const event & e = **xi;
+        note_info_t info;
+        info.ni_tick_start = e.get_timestamp();
+        if (e.is_tempo())
+        {
+            info.ni_type = DRAW_TEMPO;
+            info.ni_note = int(tempo_to_note_value(e.tempo()));
+            info.ni_tick_finish = e.is_linked() ?
+                e.get_linked()->get_timestamp() : m_length ;
+
+            if (info.ni_tick_start > tick_end)
+                continue;
+
+            if (info.ni_tick_finish < tick_start)
+                continue;
+        }
+        else                                        /* a wrapped note       */
+        {
+            info.ni_type = DRAW_NORMAL_LINKED;
+            info.ni_note = e.get_note();
+            info.ni_tick_finish = e.get_linked()->get_timestamp();
+            bool early = info.ni_tick_finish < tick_start;
+            if (info.ni_tick_start > tick_end && early)
+                continue;
+        }
+        if (info.ni_note < note_lo || info.ni_note > note_hi)
+            continue;
+
+        info.ni_velocity = e.get_note_velocity();
+        info.ni_selected = e.is_selected();
+        notes.push_back(info);
+    }
+    return int(notes.size());
+}
+
 /**
  *  Get the next event in the event list.  Then set the status and control
  *  character parameters using that event.  This overload is used only in
@@ -4552,7 +5440,11 @@ void
 sequence::set_last_tick (midipulse tick)
 {
     automutex locker(m_mutex);
+    automutex playlocker(m_play_mutex);
+    wake();
     m_last_tick = tick;
+    m_parked = false;
+    invalidate_play_cursor();
 }
 
 /**
@@ -4567,10 +5459,121 @@ sequence::set_last_tick (midipulse tick)
 midipulse
 sequence::get_last_tick () const
 {
+    midipulse lt = last_tick();
     if (m_length > 0)
-        return (m_last_tick + m_length - m_trigger_offset) % m_length;
+        return (lt + m_length - m_trigger_offset) % m_length;
+    else
+        return lt - m_trigger_offset;
+}
+
+/**
+ *  Provides the last tick played, for the functions that can run while the
+ *  sequence is parked.  In that case m_last_tick is stale, and the parent
+ *  supplies the tick that every playing sequence would be at.
+ *
+ * \return
+ *      Returns m_last_tick, or perform::parked_tick() if parked.
+ */
+
+midipulse
+sequence::last_tick () const
+{
+    if (m_parked && not_nullptr(m_parent))
+        return m_parent->parked_tick();
     else
-        return m_last_tick - m_trigger_offset;
+        return m_last_tick;
+}
+
+/**
+ *  Indicates that this sequence has nothing to do in an output frame, so
+ *  that the output thread can drop it from the play set:  it is not
+ *  playing, queued, recording, or set for one-shot, and, in Song mode, it
+ *  has no triggers.  The flags are read without locking; park() checks again
+ *  under the lock.
+ *
+ * \param songmode
+ *      True if the performance is in Song mode.
+ *
+ * \return
+ *      Returns true if play() would produce nothing but a new last tick.
+ */
+
+bool
+sequence::can_park (bool songmode) const
+{
+    bool result = ! m_playing && ! m_queued && ! m_recording;
+#ifdef SEQ64_SONG_RECORDING
+    if (result)
+        result = ! m_one_shot && ! m_song_recording;
+#endif
+    if (result && songmode)
+        result = m_triggers.count() == 0;
+
+    return result;
+}
+
+/**
+ *  Parks the sequence if can_park() is still true under the lock.  Any
+ *  later state change that could make the sequence play then sees the flag
+ *  and calls wake().
+ *
+ * \threadsafe
+ *
+ * \param songmode
+ *      True if the performance is in Song mode.
+ *
+ * \return
+ *      Returns true if the sequence is now parked.
+ */
+
+bool
+sequence::park (bool songmode)
+{
+    automutex locker(m_mutex);
+    if (can_park(songmode))
+        m_parked = true;
+
+    return m_parked;
+}
+
+/**
+ *  Brings a parked sequence back into play, setting its last tick to the
+ *  start of the next output frame, where it would be had it been played in
+ *  every frame.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      Provides the tick at which the next output frame starts.
+ */
+
+void
+sequence::unpark (midipulse tick)
+{
+    automutex locker(m_mutex);
+    automutex playlocker(m_play_mutex);
+    if (m_parked)
+    {
+        m_last_tick = tick;
+        m_parked = false;
+        invalidate_play_cursor();
+    }
+}
+
+/**
+ *  If the sequence is parked, asks the parent to rebuild its play set, so
+ *  that the sequence is played again.  Called after any change that could
+ *  make can_park() false.
+ *
+ * \threadunsafe
+ *      Called with the sequence lock held.
+ */
+
+void
+sequence::wake ()
+{
+    if (m_parked && not_nullptr(m_parent))
+        m_parent->play_set_changed();
 }
 
 /**
@@ -4762,10 +5765,13 @@ sequence::set_playing (bool p)
     if (p != get_playing())
     {
         m_playing = p;
-        if (! p)
+        if (p)
+            wake();
+        else
             off_playing_notes();
 
-        set_dirty();
+        set_dirty_mute();
+        m_dirty_edit = true;
     }
     m_queued = false;
 #ifdef SEQ64_SONG_RECORDING
@@ -4788,6 +5794,8 @@ sequence::set_recording (bool r)
     automutex locker(m_mutex);
     m_notes_on = 0;             // should this require (r != m_recording)?
     m_recording = r;
+    if (r)
+        wake();
 }
 
 /**
@@ -5038,16 +6046,27 @@ sequence::print_triggers () const
  *  buss.  This function does not bother checking if m_master_bus is a null
  *  pointer.
  *
+ *  Events played from sequence::play() carry their tick, and are not flushed
+ *  here; perform::play() flushes the buss once for the whole frame, rather
+ *  than once per event.  Immediate events, such as MIDI thru, are flushed
+ *  right away.
+ *
  * \param ev
  *      The event to put on the buss.
  *
+ * \param tick
+ *      The absolute tick at which the event is due.  When playback is
+ *      scheduling ahead (see mastermidibase::play_at()), the event is
+ *      queued for that time.  If SEQ64_NULL_MIDIPULSE (the default), the
+ *      event is played and flushed immediately.
+ *
  * \threadsafe
  */
 
 void
-sequence::put_event_on_bus (event & ev)
+sequence::put_event_on_bus (event & ev, midipulse tick)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     midibyte note = ev.get_note();
     bool skip = false;
     if (ev.is_note_on())
@@ -5068,8 +6087,13 @@ sequence::put_event_on_bus (event & ev)
          *      actually playing an event?
          */
 
-        m_master_bus->play(m_bus, &ev, m_midi_channel);
-        m_master_bus->flush();
+        if (is_null_midipulse(tick))
+        {
+            m_master_bus->play(m_bus, &ev, m_midi_channel);
+            m_master_bus->flush();
+        }
+        else
+            m_master_bus->play_at(m_bus, &ev, m_midi_channel, tick);
     }
 }
 
@@ -5077,13 +6101,18 @@ sequence::put_event_on_bus (event & ev)
  *  Sends a note-off event for all active notes.  This function does not
  *  bother checking if m_master_bus is a null pointer.
  *
+ *  If playback is scheduling ahead, some of those notes may have note-ons
+ *  still waiting in the output queue, up to the last tick played, so the
+ *  note-offs are scheduled for that tick rather than sent now.  Otherwise,
+ *  mastermidibase::play_at() sends them immediately.
+ *
  * \threadsafe
  */
 
 void
 sequence::off_playing_notes ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     event e;
     for (int x = 0; x < c_midi_notes; ++x)
     {
@@ -5091,7 +6120,7 @@ sequence::off_playing_notes ()
         {
             e.set_status(EVENT_NOTE_OFF);
             e.set_data(x, midibyte(127));               /* or is 0 better?  */
-            m_master_bus->play(m_bus, &e, m_midi_channel);
+            m_master_bus->play_at(m_bus, &e, m_midi_channel, m_last_tick);
             if (m_playing_notes[x] > 0)
                 m_playing_notes[x]--;
         }
@@ -5189,7 +6218,7 @@ sequence::transpose_notes (int steps, int scale)
         automutex locker(m_mutex);
         event_list transposed_events;
         const int * transpose_table;
-        m_events_undo.push(m_events);               /* push_undo(), no lock  */
+        checkpoint_undo();                          /* push_undo(), no lock  */
         if (steps < 0)
         {
             transpose_table = &c_scales_transpose_dn[scale][0];     /* down */
@@ -5243,7 +6272,7 @@ sequence::shift_notes (midipulse ticks)
     {
         automutex locker(m_mutex);
         event_list shifted_events;
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        checkpoint_undo();                          /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
@@ -5289,12 +6318,16 @@ sequence::apply_song_transpose ()
     if (transpose != 0)
     {
         automutex locker(m_mutex);
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        checkpoint_undo();                          /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
             event & er = DREF(i);
             if (er.is_note())                       /* also aftertouch      */
+            {
+                event previous = er;
                 er.transpose_note(transpose);
+                m_events.touch(previous, er);       /* edited in place      */
+            }
         }
         set_dirty();
     }
@@ -5476,7 +6509,7 @@ sequence::push_quantize
 )
 {
     automutex locker(m_mutex);
-    m_events_undo.push(m_events);
+    checkpoint_undo();
     quantize_events(status, cc, snap_tick, divide, linked);
 }
 
@@ -5486,7 +6519,7 @@ void
 sequence::multiply_pattern (double multiplier)
 {
     automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo(), no lock */
+    checkpoint_undo();                          /* push_undo(), no lock */
     midipulse orig_length = get_length();
     midipulse new_length = midipulse(orig_length * multiplier);
     if (new_length > orig_length)
@@ -5504,7 +6537,10 @@ sequence::multiply_pattern (double multiplier)
             timestamp -= note_off_margin();
 
         timestamp %= m_length;
+
+        event previous = er;
         er.set_timestamp(timestamp);
+        m_events.touch(previous, er);           /* edited in place      */
     }
     verify_and_link();
     if (new_length < orig_length)
@@ -5717,10 +6753,11 @@ void
 sequence::toggle_one_shot ()
 {
     automutex locker(m_mutex);
-    set_dirty_mp();
+    set_dirty_mute();
     m_one_shot = ! m_one_shot;
-    m_one_shot_tick = m_last_tick - mod_last_tick() + m_length;
+    m_one_shot_tick = last_tick() - mod_last_tick() + m_length;
     m_off_from_snap = true;
+    wake();
 }
 
 /**
@@ -5732,7 +6769,7 @@ void
 sequence::off_one_shot ()
 {
     automutex locker(m_mutex);
-    set_dirty_mp();
+    set_dirty_mute();
     m_one_shot = false;
     m_off_from_snap = true;
 }
@@ -5761,6 +6798,7 @@ sequence::song_recording_start (midipulse tick, bool snap)
     m_song_recording_snap = snap;
     m_song_record_tick = tick;
     m_song_recording = true;
+    wake();
 
     /*
      * Do we need to add this setting?
@@ -0,0 +1,267 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempo_map.cpp
+ *
+ *  This module declares/defines the class for converting between pulses and
+ *  time in a song with tempo changes.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-03-17
+ * \updates       2018-03-17
+ * \license       GNU GPLv2 or above
+ *
+ *  The perform object builds a tempo_map from its tempo track; see
+ *  perform::rebuild_tempo_map().  The map is not changed once it is
+ *  published, so that the output thread and the JACK callbacks can use it
+ *  without taking the tempo track's lock.
+ */
+
+#include <algorithm>                    /* std::upper_bound()           */
+
+#include "tempo_map.hpp"                /* seq64::tempo_map             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Comparison function for searching the segments by pulse.
+ *
+ * \param t
+ *      The pulse to look up.
+ *
+ * \param te
+ *      The segment to compare against.
+ *
+ * \return
+ *      Returns true if the pulse is before the start of the segment.
+ */
+
+static bool
+tick_before (midipulse t, const tempo_map::tempo_entry_t & te)
+{
+    return t < te.te_tick;
+}
+
+/**
+ *  Comparison function for searching the segments by time.
+ *
+ * \param us
+ *      The time to look up, in microseconds.
+ *
+ * \param te
+ *      The segment to compare against.
+ *
+ * \return
+ *      Returns true if the time is before the start of the segment.
+ */
+
+static bool
+us_before (double us, const tempo_map::tempo_entry_t & te)
+{
+    return us < te.te_us;
+}
+
+/**
+ *  Principal constructor.  Creates the map with a single segment.
+ *
+ * \param ppqn
+ *      The PPQN of the song.
+ *
+ * \param basebpm
+ *      The tempo of the song until its first Set Tempo event.
+ */
+
+tempo_map::tempo_map (int ppqn, midibpm basebpm)
+ :
+    m_entries       (),
+    m_ppqn          (ppqn > 0 ? ppqn : 1),
+    m_start_changed (false)
+{
+    tempo_entry_t te;
+    te.te_tick = 0;
+    te.te_bpm = basebpm;
+    te.te_us = 0.0;
+    te.te_us_per_pulse = us_per_pulse(basebpm);
+    m_entries.push_back(te);
+}
+
+/**
+ *  Gets the length of one pulse at the given tempo.
+ *
+ * \param bpm
+ *      The tempo, in quarter notes per minute.
+ *
+ * \return
+ *      Returns the microseconds per pulse.
+ */
+
+double
+tempo_map::us_per_pulse (midibpm bpm) const
+{
+    return bpm > 0.0 ? 60000000.0 / (bpm * m_ppqn) : 0.0 ;
+}
+
+/**
+ *  Adds a tempo change.  A change at a pulse that already starts a segment
+ *  replaces the tempo of that segment, so a Set Tempo event at pulse 0
+ *  replaces the base tempo.  The changes are normally added in pulse order,
+ *  as they come from the tempo track, and then only the new segment has to
+ *  have its start time calculated.
+ *
+ * \param tick
+ *      The pulse at which the tempo changes.  A negative value is taken as 0.
+ *
+ * \param bpm
+ *      The new tempo.  If it is not greater than 0, it is ignored.
+ */
+
+void
+tempo_map::add (midipulse tick, midibpm bpm)
+{
+    if (bpm <= 0.0)
+        return;
+
+    if (tick < 0)
+        tick = 0;
+
+    if (tick == 0)
+        m_start_changed = true;
+
+    int seg = segment(tick);
+    if (m_entries[seg].te_tick == tick)
+    {
+        m_entries[seg].te_bpm = bpm;
+        m_entries[seg].te_us_per_pulse = us_per_pulse(bpm);
+    }
+    else
+    {
+        tempo_entry_t te;
+        te.te_tick = tick;
+        te.te_bpm = bpm;
+        te.te_us = 0.0;
+        te.te_us_per_pulse = us_per_pulse(bpm);
+        m_entries.insert(m_entries.begin() + (++seg), te);
+    }
+    for (int s = seg > 0 ? seg : 1 ; s < count(); ++s)
+    {
+        const tempo_entry_t & prev = m_entries[s - 1];
+        tempo_entry_t & te = m_entries[s];
+        te.te_us = prev.te_us +
+            (te.te_tick - prev.te_tick) * prev.te_us_per_pulse;
+    }
+}
+
+/**
+ *  Finds the segment in force at a pulse, by binary search.
+ *
+ * \param tick
+ *      The pulse to look up.
+ *
+ * \return
+ *      Returns the index of the segment.  Pulses before 0 are in segment 0.
+ */
+
+int
+tempo_map::segment (midipulse tick) const
+{
+    std::vector<tempo_entry_t>::const_iterator ti = std::upper_bound
+    (
+        m_entries.begin(), m_entries.end(), tick, tick_before
+    );
+    int result = int(ti - m_entries.begin()) - 1;
+    return result > 0 ? result : 0 ;
+}
+
+/**
+ * \getter m_entries[seg].te_bpm
+ *
+ * \param seg
+ *      The index of the segment, as returned by segment().
+ *
+ * \return
+ *      Returns the tempo of the segment, or the tempo of segment 0 if the
+ *      index is out of range.
+ */
+
+midibpm
+tempo_map::segment_bpm (int seg) const
+{
+    if (seg < 0 || seg >= count())
+        seg = 0;
+
+    return m_entries[seg].te_bpm;
+}
+
+/**
+ *  Converts a pulse position to the time from the start of the song.
+ *
+ * \param pulses
+ *      The position, in pulses, which can have a fractional part.
+ *
+ * \return
+ *      Returns the time in microseconds.
+ */
+
+double
+tempo_map::pulses_to_us (double pulses) const
+{
+    const tempo_entry_t & te = m_entries[segment(midipulse(pulses))];
+    return te.te_us + (pulses - te.te_tick) * te.te_us_per_pulse;
+}
+
+/**
+ *  Converts a time from the start of the song to a pulse position.  This is
+ *  the inverse of pulses_to_us().
+ *
+ * \param us
+ *      The time in microseconds.
+ *
+ * \return
+ *      Returns the position in pulses, with the fractional part.
+ */
+
+double
+tempo_map::us_to_pulses (double us) const
+{
+    std::vector<tempo_entry_t>::const_iterator ti = std::upper_bound
+    (
+        m_entries.begin(), m_entries.end(), us, us_before
+    );
+    int seg = int(ti - m_entries.begin()) - 1;
+    const tempo_entry_t & te = m_entries[seg > 0 ? seg : 0];
+    if (te.te_us_per_pulse > 0.0)
+        return te.te_tick + (us - te.te_us) / te.te_us_per_pulse;
+    else
+        return double(te.te_tick);
+}
+
+}           // namespace seq64
+
+/*
+ * tempo_map.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
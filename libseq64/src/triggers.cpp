@@ -59,6 +59,7 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>                    /* std::stable_sort(), min()    */
 
 #include "sequence.hpp"                 /* the "parent" of the triggers */
 #include "settings.hpp"                 /* seq64::rc() settings access  */
@@ -87,7 +88,10 @@ triggers::triggers (sequence & parent)
     m_clipboard                 (),
     m_undo_stack                (),
     m_redo_stack                (),
-    m_iterator_play_trigger     (),
+    m_edit_count                (0),
+    m_index                     (),
+    m_index_edit_count          (~0UL),
+    m_play_cursor               (0),
     m_iterator_draw_trigger     (),
     m_trigger_copied            (false),
     m_paste_tick                (SEQ64_NO_PASTE_TRIGGER),   // stazed
@@ -135,8 +139,9 @@ triggers::operator = (const triggers & rhs)
         m_clipboard = rhs.m_clipboard;
         m_undo_stack = rhs.m_undo_stack;
         m_redo_stack = rhs.m_redo_stack;
-        m_iterator_play_trigger = rhs.m_iterator_play_trigger;
         m_iterator_draw_trigger = rhs.m_iterator_draw_trigger;
+        m_play_cursor = 0;
+        ++m_edit_count;                 /* our index is now stale       */
         m_trigger_copied = rhs.m_trigger_copied;
         m_ppqn = rhs.m_ppqn;
         m_length = rhs.m_length;
@@ -146,16 +151,18 @@ triggers::operator = (const triggers & rhs)
 
 /**
  *  Pushes the list-trigger into the trigger undo-list, then flags each
- *  item in the undo-list as unselected.
+ *  item in the undo-list as unselected.  The snapshot is a contiguous
+ *  array, so the push is one allocation and a flat copy, not a new node
+ *  for every trigger.
  */
 
 void
 triggers::push_undo ()
 {
-    m_undo_stack.push(m_triggers);
+    m_undo_stack.push(Vector(m_triggers.begin(), m_triggers.end()));
     for
     (
-        List::iterator i = m_undo_stack.top().begin();
+        Vector::iterator i = m_undo_stack.top().begin();
         i != m_undo_stack.top().end(); ++i
     )
     {
@@ -174,9 +181,10 @@ triggers::pop_undo ()
 {
     if (m_undo_stack.size() > 0)
     {
-        m_redo_stack.push(m_triggers);
-        m_triggers = m_undo_stack.top();
+        m_redo_stack.push(Vector(m_triggers.begin(), m_triggers.end()));
+        m_triggers.assign(m_undo_stack.top().begin(), m_undo_stack.top().end());
         m_undo_stack.pop();
+        ++m_edit_count;
     }
 }
 
@@ -191,9 +199,10 @@ triggers::pop_redo ()
 {
     if (m_redo_stack.size() > 0)
     {
-        m_undo_stack.push(m_triggers);
-        m_triggers = m_redo_stack.top();
+        m_undo_stack.push(Vector(m_triggers.begin(), m_triggers.end()));
+        m_triggers.assign(m_redo_stack.top().begin(), m_redo_stack.top().end());
         m_redo_stack.pop();
+        ++m_edit_count;
     }
 }
 
@@ -202,12 +211,13 @@ triggers::pop_redo ()
  *  and on/off triggers, this function handles that kind of playback.
  *  This is a new function for sequence::play() to call.
  *
- *  The for-loop goes through all the triggers, determining if there is are
- *  trigger start/end values before the \a end_tick.  If so, then the trigger
- *  state is set to true (start only within the tick range) or false (end is
- *  within the tick range), and the trigger tick is set to start or end.
- *  The first start or end trigger that is past the end tick cause the search
- *  to end.
+ *  The state is set by the first trigger that has not ended by the \a
+ *  end_tick.  If that trigger has started, the trigger state is set to true
+ *  and the trigger tick is set to its start.  Otherwise the state is false
+ *  and the trigger tick is the end of the trigger before it, if any.  This
+ *  matches the old walk through all the triggers, which stopped at that
+ *  trigger.  The walk now runs over the contiguous index, from where the last
+ *  frame left off, so each frame costs O(1) amortized rather than O(n).
  *
  *                  -------------------------------------
  *      tick_start |                                     | tick_end
@@ -257,33 +267,62 @@ triggers::play
     midipulse trigger_offset = 0;
     midipulse trigger_tick = 0;
     bool trigger_state = false;
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    if (index_stale())
+        compact();
+
+    /*
+     * Find the first trigger that has not ended by the end tick.  Normally
+     * this is the one found in the last frame, or one a little past it.  If
+     * the end tick has gone backward (loop or reposition), search for it.
+     */
+
+    size_t count = m_index.size();
+    size_t k = m_play_cursor;
+    if (k > count || (k > 0 && m_index[k - 1].tick_end() > end_tick))
+        k = find_unended(end_tick);
+
+    while
+    (
+        k < count &&
+        m_index[k].tick_start() <= end_tick && m_index[k].tick_end() <= end_tick
+    )
     {
+        ++k;
+    }
+    m_play_cursor = k;
 
 #ifdef SEQ64_SONG_RECORDING
-        if (i->at_trigger_transition(start_tick, end_tick))
+
+    /*
+     * Only triggers ending at or after the start tick can be at a
+     * transition, and the ends are in order, so walk back from k.
+     */
+
+    for (size_t j = std::min(k + 1, count); j > 0; --j)
+    {
+        const trigger & t = m_index[j - 1];
+        if (t.at_trigger_transition(start_tick, end_tick))
             m_parent.song_playback_block(false);
-#endif
 
-        midipulse trigstart = i->tick_start();
-        midipulse trigend = i->tick_end();
-        midipulse trigoffset = i->offset();
-        if (trigstart <= end_tick)
-        {
-            trigger_state = true;
-            trigger_tick = trigstart;
-            trigger_offset = trigoffset;
-        }
-        if (trigend <= end_tick)
-        {
-            trigger_state = false;
-            trigger_tick = trigend;
-            trigger_offset = trigoffset;
-        }
-        if (trigstart > end_tick || trigend > end_tick)
+        if (t.tick_end() < start_tick)
             break;
     }
 
+#endif
+
+    if (k < count && m_index[k].tick_start() <= end_tick)
+    {
+        trigger_state = true;               /* inside trigger k             */
+        trigger_tick = m_index[k].tick_start();
+        trigger_offset = m_index[k].offset();
+    }
+    else if (k > 0)
+    {
+        trigger_state = false;              /* after the end of trigger k-1 */
+        trigger_tick = m_index[k - 1].tick_end();
+        trigger_offset = m_index[k - 1].offset();
+    }
+
     /*
      * Had triggers in the slice, not equal to current state.  Therefore, it
      * is time to change the sequence trigger state.  We only change state if
@@ -325,7 +364,7 @@ triggers::play
         }
     }
 
-    bool offplay = m_triggers.size() == 0 && m_parent.get_playing();
+    bool offplay = count == 0 && m_parent.get_playing();
 
 #ifdef SEQ64_SONG_RECORDING
     if (offplay)
@@ -339,6 +378,81 @@ triggers::play
     return result;
 }
 
+/**
+ *  Rebuilds the playback index from the trigger list, sorted by start tick.
+ *  The list is normally kept in order, but a box move can leave it out of
+ *  order, so the copy is sorted.
+ */
+
+void
+triggers::compact () const
+{
+    m_index.assign(m_triggers.begin(), m_triggers.end());
+    std::stable_sort(m_index.begin(), m_index.end());
+    m_index_edit_count = m_edit_count;
+}
+
+/**
+ *  Finds, by binary search, the first trigger in the index that has not
+ *  ended by the given tick.  The triggers do not overlap, so both their
+ *  start and end ticks are in order.
+ *
+ * \param tick
+ *      Provides the tick to check.
+ *
+ * \return
+ *      Returns the index of the trigger, or the size of the index if all of
+ *      the triggers have ended.
+ */
+
+size_t
+triggers::find_unended (midipulse tick) const
+{
+    size_t lo = 0;
+    size_t hi = m_index.size();
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        const trigger & t = m_index[mid];
+        if (t.tick_start() <= tick && t.tick_end() <= tick)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ *  Counts, by binary search, the triggers in the index that start at or
+ *  before the given tick.  If the count is not zero, the last of them is
+ *  the only trigger that can contain the tick.
+ *
+ * \param tick
+ *      Provides the tick to check.
+ *
+ * \return
+ *      Returns the number of triggers starting at or before the tick.
+ */
+
+size_t
+triggers::find_started (midipulse tick) const
+{
+    if (index_stale())
+        compact();
+
+    size_t lo = 0;
+    size_t hi = m_index.size();
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (m_index[mid].tick_start() <= tick)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
 /**
  *  Adjusts the given offset by mod'ing it with m_length and adding
  *  m_length if needed, and returning the result.
@@ -448,13 +562,14 @@ triggers::add
     }
     m_triggers.push_front(t);
     m_triggers.sort();                          /* hmmm, another sort       */
+    ++m_edit_count;
 }
 
 /**
- *  This function examines each trigger in the trigger list.  If the given
- *  position is between the current trigger's tick-start and tick-end
- *  values, the these values are copied to the start and end parameters,
- *  respectively, and then we exit.
+ *  This function looks up the trigger containing the given position, by a
+ *  binary search of the playback index.  If the given position is between
+ *  the trigger's tick-start and tick-end values, the these values are copied
+ *  to the start and end parameters, respectively.
  *
  * \param position
  *      The position to examine.
@@ -476,31 +591,31 @@ triggers::add
 bool
 triggers::intersect (midipulse position, midipulse & start, midipulse & ender)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    size_t n = find_started(position);
+    if (n > 0 && position <= m_index[n - 1].tick_end())
     {
-        if (i->tick_start() <= position && position <= i->tick_end())
-        {
-            start = i->tick_start();    /* return by reference */
-            ender = i->tick_end();      /* ditto               */
-            return true;
-        }
+        start = m_index[n - 1].tick_start();    /* return by reference */
+        ender = m_index[n - 1].tick_end();      /* ditto               */
+        return true;
     }
     return false;
 }
 
 /**
+ *  Checks if any trigger contains the given position.  Same as
+ *  get_state().
+ *
+ * \param position
+ *      The position to examine.
  *
+ * \return
+ *      Returns true if a trigger contains the position.
  */
 
 bool
 triggers::intersect (midipulse position)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
-    {
-        if (i->tick_start() <= position && position <= i->tick_end())
-            return true;
-    }
-    return false;
+    return get_state(position);
 }
 
 /**
@@ -562,6 +677,7 @@ triggers::remove (midipulse tick)
         {
             unselect(*i);                       /* adjust selection count    */
             m_triggers.erase(i);
+            ++m_edit_count;
             break;
         }
     }
@@ -588,6 +704,7 @@ triggers::split (trigger & trig, midipulse splittick)
     midipulse new_tick_end = trig.tick_end();
     midipulse new_tick_start = splittick;
     trig.tick_end(splittick - 1);
+    ++m_edit_count;
 
     midipulse len = new_tick_end - new_tick_start;
     if (len > 1)
@@ -692,6 +809,7 @@ triggers::adjust_offsets_to_length (midipulse newlength)
         i->offset(new_offset % newlength);
         i->offset(newlength - i->offset());
     }
+    ++m_edit_count;
 }
 
 /**
@@ -795,6 +913,7 @@ triggers::copy (midipulse starttick, midipulse distance)
         }
     }
     m_triggers.sort();
+    ++m_edit_count;
 }
 
 /**
@@ -877,6 +996,7 @@ triggers::move (midipulse starttick, midipulse distance, bool direction)
         }
         i->offset(adjust_offset(i->offset()));
     }
+    ++m_edit_count;
 }
 
 /**
@@ -1022,6 +1142,7 @@ triggers::move_selected (midipulse tick, bool fixoffset, grow_edit_t which)
                 s->increment_offset(deltatick);
                 s->offset(adjust_offset(s->offset()));
             }
+            ++m_edit_count;
             break;
         }
         else
@@ -1051,6 +1172,7 @@ triggers::offset_selected (midipulse tick, grow_edit_t editmode)
         }
         ++i;
     }
+    ++m_edit_count;
 }
 
 #endif  // SEQ64_SONG_BOX_SELECT
@@ -1075,7 +1197,8 @@ triggers::get_maximum () const
 
 /**
  *  Checks the list of triggers against the given tick.  If any
- *  trigger is found to bracket that tick, then true is returned.
+ *  trigger is found to bracket that tick, then true is returned.  Uses a
+ *  binary search of the playback index.
  *
  * \param tick
  *      Provides the tick of interest.
@@ -1087,16 +1210,8 @@ triggers::get_maximum () const
 bool
 triggers::get_state (midipulse tick) const
 {
-    bool result = false;
-    for (List::const_iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
-    {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
-        {
-            result = true;
-            break;
-        }
-    }
-    return result;
+    size_t n = find_started(tick);
+    return n > 0 && tick <= m_index[n - 1].tick_end();
 }
 
 /**
@@ -1182,6 +1297,7 @@ triggers::remove_selected ()
         {
             unselect(*i);               /* this adjusts the selection count */
             m_triggers.erase(i);
+            ++m_edit_count;
             break;
         }
     }
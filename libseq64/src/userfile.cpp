@@ -127,13 +127,11 @@ userfile::dump_setting_summary ()
 bool
 userfile::parse (perform & /* p */)
 {
-    std::ifstream file(m_name.c_str(), std::ios::in | std::ios::ate);
-    if (! file.is_open())
+    if (! load_file())
     {
         fprintf(stderr, "? error opening [%s]\n", m_name.c_str());
         return false;
     }
-    file.seekg(0, std::ios::beg);                       /* seek to start    */
 
     /*
      * [comments]
@@ -142,7 +140,7 @@ userfile::parse (perform & /* p */)
      * read an optional comment block.
      */
 
-    if (line_after(file, "[comments]"))                 /* gets first line  */
+    if (line_after("[comments]"))                       /* gets first line  */
     {
         usr().clear_comments();
         do
@@ -150,7 +148,7 @@ userfile::parse (perform & /* p */)
             usr().append_comment_line(m_line);
             usr().append_comment_line("\n");
 
-        } while (next_data_line(file));
+        } while (next_data_line());
     }
 
     /*
@@ -168,7 +166,7 @@ userfile::parse (perform & /* p */)
          */
 
         int buses = 0;
-        if (line_after(file, "[user-midi-bus-definitions]"))
+        if (line_after("[user-midi-bus-definitions]"))
             sscanf(m_line, "%d", &buses);               /* atavistic!       */
 
         /*
@@ -178,18 +176,18 @@ userfile::parse (perform & /* p */)
         for (int bus = 0; bus < buses; ++bus)
         {
             std::string label = make_section_name("user-midi-bus", bus);
-            if (! line_after(file, label))
+            if (! line_after(label))
                 break;
 
             if (usr().add_bus(m_line))
             {
-                (void) next_data_line(file);
+                (void) next_data_line();
                 int instruments = 0;
                 sscanf(m_line, "%d", &instruments);     /* no. of channels  */
                 for (int j = 0; j < instruments; ++j)
                 {
                     int channel, instrument;
-                    (void) next_data_line(file);
+                    (void) next_data_line();
                     sscanf(m_line, "%d %d", &channel, &instrument);
                     usr().set_bus_instrument(bus, channel, instrument);
                 }
@@ -210,7 +208,7 @@ userfile::parse (perform & /* p */)
      */
 
     int instruments = 0;
-    if (line_after(file, "[user-instrument-definitions]"))
+    if (line_after("[user-instrument-definitions]"))
         sscanf(m_line, "%d", &instruments);
 
     /*
@@ -220,19 +218,19 @@ userfile::parse (perform & /* p */)
     for (int i = 0; i < instruments; ++i)
     {
         std::string label = make_section_name("user-instrument", i);
-        if (! line_after(file, label))
+        if (! line_after(label))
             break;
 
         if (usr().add_instrument(m_line))
         {
             char ccname[SEQ64_LINE_MAX];
             int ccs = 0;
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &ccs);
             for (int j = 0; j < ccs; ++j)
             {
                 int c = 0;
-                if (! next_data_line(file))
+                if (! next_data_line())
                     break;
 
                 ccname[0] = 0;                              // clear the buffer
@@ -286,40 +284,40 @@ userfile::parse (perform & /* p */)
     if (! rc().legacy_format())
     {
         int scratch = 0;
-        if (line_after(file, "[user-interface-settings]"))
+        if (line_after("[user-interface-settings]"))
         {
             sscanf(m_line, "%d", &scratch);
             usr().grid_style(scratch);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().grid_brackets(scratch);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().mainwnd_rows(scratch);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().mainwnd_cols(scratch);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().max_sets(scratch);            /* should ignore this setting */
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().mainwid_border(scratch);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().mainwid_spacing(scratch);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().control_height(scratch);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().zoom(scratch);
 
@@ -329,7 +327,7 @@ userfile::parse (perform & /* p */)
              * stored in the MIDI file, not in the "user" configuration file.
              */
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().global_seq_feature(scratch != 0);
 
@@ -338,21 +336,21 @@ userfile::parse (perform & /* p */)
              * versus new font.
              */
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().use_new_font(scratch != 0);
 
-            (void) next_data_line(file);
+            (void) next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().allow_two_perfedits(scratch != 0);
 
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%d", &scratch);
                 usr().perf_h_page_increment(scratch);
             }
 
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%d", &scratch);
                 usr().perf_v_page_increment(scratch);
@@ -364,22 +362,22 @@ userfile::parse (perform & /* p */)
              *  have older Sequencer64 "user" configuration files.
              */
 
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%d", &scratch);             /* now an int   */
                 usr().progress_bar_colored(scratch);        /* pick a color */
-                if (next_data_line(file))
+                if (next_data_line())
                 {
                     sscanf(m_line, "%d", &scratch);
                     usr().progress_bar_thick(scratch != 0);
                 }
-                if (next_data_line(file))
+                if (next_data_line())
                 {
                     sscanf(m_line, "%d", &scratch);
                     if (scratch <= 1)                       /* boolean?     */
                     {
                         usr().inverse_colors(scratch != 0);
-                        if (next_data_line(file))
+                        if (next_data_line())
                             sscanf(m_line, "%d", &scratch); /* get redraw   */
                     }
                     if (scratch < SEQ64_MINIMUM_REDRAW)
@@ -389,7 +387,7 @@ userfile::parse (perform & /* p */)
 
                     usr().window_redraw_rate(scratch);
                 }
-                if (next_data_line(file))
+                if (next_data_line())
                 {
                     sscanf(m_line, "%d", &scratch);
                     if (scratch <= 1)                       /* boolean?     */
@@ -398,19 +396,19 @@ userfile::parse (perform & /* p */)
 
 #if defined SEQ64_MULTI_MAINWID
 
-                if (next_data_line(file))
+                if (next_data_line())
                 {
                     sscanf(m_line, "%d", &scratch);
                     if (scratch > 0 && scratch <= SEQ64_MAINWID_BLOCK_ROWS_MAX)
                         usr().block_rows(scratch);
                 }
-                if (next_data_line(file))
+                if (next_data_line())
                 {
                     sscanf(m_line, "%d", &scratch);
                     if (scratch > 0 && scratch <= SEQ64_MAINWID_BLOCK_COLS_MAX)
                         usr().block_columns(scratch);
                 }
-                if (next_data_line(file))
+                if (next_data_line())
                 {
                     sscanf(m_line, "%d", &scratch);
                     usr().block_independent(scratch != 0);
@@ -418,7 +416,7 @@ userfile::parse (perform & /* p */)
 
 #endif  // SEQ64_MULTI_MAINWID
 
-                if (next_data_line(file))
+                if (next_data_line())
                 {
                     float scale = 1.0f;
                     sscanf(m_line, "%f", &scale);
@@ -460,57 +458,57 @@ userfile::parse (perform & /* p */)
 
     if (! rc().legacy_format())
     {
-        if (line_after(file, "[user-midi-settings]"))
+        if (line_after("[user-midi-settings]"))
         {
             int scratch = 0;
             sscanf(m_line, "%d", &scratch);
             usr().midi_ppqn(scratch);
 
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().midi_beats_per_bar(scratch);
 
             float beatspm;
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%f", &beatspm);
             usr().midi_beats_per_minute(midibpm(beatspm));
 
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().midi_beat_width(scratch);
 
-            next_data_line(file);
+            next_data_line();
             sscanf(m_line, "%d", &scratch);
             usr().midi_buss_override(char(scratch));
 
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%d", &scratch);
                 usr().velocity_override(scratch);
             }
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%d", &scratch);
                 usr().bpm_precision(scratch);
             }
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 float inc;
                 sscanf(m_line, "%f", &inc);
                 usr().bpm_step_increment(midibpm(inc));
             }
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 float inc;
                 sscanf(m_line, "%f", &inc);
                 usr().bpm_page_increment(midibpm(inc));
             }
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%f", &beatspm);
                 usr().midi_bpm_minimum(midibpm(beatspm));
             }
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%f", &beatspm);
                 usr().midi_bpm_maximum(midibpm(beatspm));
@@ -521,14 +519,14 @@ userfile::parse (perform & /* p */)
          * -o special options support.
          */
 
-        if (line_after(file, "[user-options]"))
+        if (line_after("[user-options]"))
         {
             int scratch = 0;
             sscanf(m_line, "%d", &scratch);
             usr().option_daemonize(scratch != 0);
 
             char temp[256];
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%s", temp);
                 std::string logfile = std::string(temp);
@@ -545,12 +543,12 @@ userfile::parse (perform & /* p */)
          * Work-arounds for sticky issues
          */
 
-        if (line_after(file, "[user-work-arounds]"))
+        if (line_after("[user-work-arounds]"))
         {
             int scratch = 0;
             sscanf(m_line, "%d", &scratch);
             usr().work_around_play_image(scratch != 0);
-            if (next_data_line(file))
+            if (next_data_line())
             {
                 sscanf(m_line, "%d", &scratch);
                 usr().work_around_transpose_image(scratch != 0);
@@ -559,11 +557,10 @@ userfile::parse (perform & /* p */)
     }
 
     /*
-     * We have all of the data.  Close the file.
+     * We have all of the data.
      */
 
     dump_setting_summary();
-    file.close();                       /* End Of File, EOF, done! */
     return true;
 }
 
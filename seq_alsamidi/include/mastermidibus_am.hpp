@@ -102,6 +102,8 @@ private:
     virtual void api_set_ppqn (int ppqn);
     virtual void api_set_beats_per_minute (midibpm bpm);
     virtual void api_flush ();
+    virtual int64_t api_queue_time_us ();
+    virtual void api_cancel_scheduled ();
     virtual void api_start ();
     virtual void api_stop ();
     virtual void api_continue_from (midipulse tick);
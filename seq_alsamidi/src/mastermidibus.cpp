@@ -65,6 +65,7 @@
 #endif
 #endif
 
+#include "alsa_timestamp.hpp"           /* seq64::alsa_arrival_us()         */
 #include "calculations.hpp"             /* tempo_from_beats_per_minute()    */
 #include "event.hpp"                    /* seq64::event                     */
 #include "mastermidibus.hpp"            /* seq64::mastermidibus             */
@@ -421,6 +422,7 @@ mastermidibus::api_continue_from (midipulse /* tick */)
 void
 mastermidibus::api_stop ()
 {
+    api_cancel_scheduled();
     snd_seq_drain_output(m_alsa_seq);
     snd_seq_sync_output_queue(m_alsa_seq);
     snd_seq_stop_queue(m_alsa_seq, m_queue, NULL);  /* start timer */
@@ -491,6 +493,63 @@ mastermidibus::api_flush ()
     snd_seq_drain_output(m_alsa_seq);
 }
 
+/**
+ *  Gets the current real time of the master queue, which is the clock that
+ *  midibus::api_play_at() schedules against.  If the queue is not running,
+ *  it is started first; api_stop() stops it again at the end of playback.
+ *
+ * \return
+ *      Returns the queue time in microseconds, or -1 if the queue status
+ *      cannot be read.
+ */
+
+int64_t
+mastermidibus::api_queue_time_us ()
+{
+    int64_t result = -1;
+    snd_seq_queue_status_t * status;
+    snd_seq_queue_status_alloca(&status);
+    int rc = snd_seq_get_queue_status(m_alsa_seq, m_queue, status);
+    if (rc == 0 && snd_seq_queue_status_get_status(status) == 0)
+    {
+        snd_seq_start_queue(m_alsa_seq, m_queue, NULL); /* not running yet  */
+        snd_seq_drain_output(m_alsa_seq);
+        rc = snd_seq_get_queue_status(m_alsa_seq, m_queue, status);
+    }
+    if (rc == 0)
+    {
+        const snd_seq_real_time_t * rt =
+            snd_seq_queue_status_get_real_time(status);
+
+        result = int64_t(rt->tv_sec) * 1000000 + int64_t(rt->tv_nsec) / 1000;
+    }
+    return result;
+}
+
+/**
+ *  Drains our output buffer into ALSA, and then removes from the queue the
+ *  pattern events that are still waiting to be delivered, as identified by
+ *  their c_midibus_schedule_tag.  Note-offs are ignored, so that a note
+ *  whose note-on has already sounded is still released.
+ */
+
+void
+mastermidibus::api_cancel_scheduled ()
+{
+    snd_seq_drain_output(m_alsa_seq);
+
+    snd_seq_remove_events_t * remove_events;
+    snd_seq_remove_events_alloca(&remove_events);
+    snd_seq_remove_events_set_condition
+    (
+        remove_events, SND_SEQ_REMOVE_OUTPUT | SND_SEQ_REMOVE_TAG_MATCH |
+            SND_SEQ_REMOVE_IGNORE_OFF
+    );
+    snd_seq_remove_events_set_queue(remove_events, m_queue);
+    snd_seq_remove_events_set_tag(remove_events, c_midibus_schedule_tag);
+    snd_seq_remove_events(m_alsa_seq, remove_events);
+}
+
 /**
  *  Initiate a poll() on the existing poll descriptors.
  *
@@ -670,7 +729,10 @@ mastermidibus::api_get_midi_event (event * inev)
     if (bytes <= 0)                                 /* happens at startup    */
         return false;
 
-    inev->set_timestamp(ev->time.tick);
+    inev->set_timestamp                         /* arrival time, in us  */
+    (
+        midipulse(alsa_arrival_us(m_alsa_seq, m_queue, ev))
+    );
     inev->set_status_keep_channel(buffer[0]);
 
     /**
@@ -37,6 +37,7 @@
 #include "globals.h"                    /* c_max_sequence, etc.     */
 #include "gui_drawingarea_gtk2.hpp"     /* one base class           */
 #include "seqmenu.hpp"                  /* the other base class     */
+#include "perform.hpp"                  /* seq64::ChangeList        */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -153,6 +154,21 @@ private:
 
     const int m_progress_height;
 
+    /**
+     *  Our subscription to the change records of the perform object, or -1
+     *  if perform had no room for one, in which case the slots are polled
+     *  with perform::is_dirty_main() as before.
+     */
+
+    int m_change_subscriber;
+
+    /**
+     *  The change records of the current frame, kept as a member so that
+     *  its storage is reused from one frame to the next.
+     */
+
+    ChangeList m_changes;
+
 public:
 
     mainwid (perform & p, int ss = 0);
@@ -369,6 +369,15 @@ private:
 
     bool m_is_tempo_recording;
 
+    /**
+     *  Set while timer_callback() copies the current tempo into the BPM
+     *  spin-button, so that adj_callback_bpm() does not hand the tempo back
+     *  to set_beats_per_minute().  That would make a tempo change from the
+     *  song, or from JACK, the base tempo of the song.
+     */
+
+    bool m_bpm_from_perform;
+
     /**
      *  The button for bringing up the Song Editor (Performance Editor).
      */
@@ -496,6 +505,21 @@ private:
 
     sigc::connection m_timeout_connect;
 
+    /**
+     *  Our subscription to the tempo and screen-set change records of the
+     *  perform object, or -1 if there was no room, in which case the
+     *  tempo and screen-set are checked on every timer tick.
+     */
+
+    int m_change_subscriber;
+
+    /**
+     *  The change records drained on each timer tick; a member, so that its
+     *  storage is reused.
+     */
+
+    ChangeList m_changes;
+
 #ifdef SEQ64_MAINWND_TAP_BUTTON
 
     /**
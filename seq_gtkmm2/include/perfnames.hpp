@@ -36,6 +36,7 @@
  */
 
 #include "gui_drawingarea_gtk2.hpp"
+#include "perform.hpp"                  /* seq64::ChangeList            */
 #include "seqmenu.hpp"
 
 /*
@@ -162,6 +163,20 @@ private:
 
     bool m_sequence_active[c_max_sequence];
 
+    /**
+     *  Our subscription to the pattern change records of the perform object,
+     *  or -1 if none was available, in which case perform::is_dirty_names()
+     *  is polled for each visible row.
+     */
+
+    int m_change_subscriber;
+
+    /**
+     *  Receives the change records drained in redraw_dirty_sequences().
+     */
+
+    ChangeList m_changes;
+
 public:
 
     perfnames
@@ -172,12 +187,12 @@ public:
     );
 
     /**
-     *  Let's provide a do-nothing virtual destructor.
+     *  Gives up our subscription to change records.
      */
 
     virtual ~perfnames ()
     {
-        // I got nothin'
+        perf().unsubscribe_changes(m_change_subscriber);
     }
 
     void redraw_dirty_sequences ();
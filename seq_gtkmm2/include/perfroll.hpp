@@ -37,6 +37,7 @@
 
 #include "globals.h"                    /* seq64::c_max_sequence            */
 #include "gui_drawingarea_gtk2.hpp"     /* seq64::gui_drawingarea_gtk2      */
+#include "perform.hpp"                  /* seq64::ChangeList                */
 #include "rect.hpp"                     /* seq64::rect class                */
 
 /*
@@ -361,6 +362,21 @@ protected:
 
     bool m_grow_direction;
 
+    /**
+     *  Our subscription to the pattern change records of the perform object.
+     *  If it is -1, perform had no room for another subscriber, and
+     *  perform::is_dirty_perf() is polled for each visible row as before.
+     */
+
+    int m_change_subscriber;
+
+    /**
+     *  The change records drained in redraw_dirty_sequences(), a member so
+     *  that its storage is reused.
+     */
+
+    ChangeList m_changes;
+
 public:
 
     perfroll
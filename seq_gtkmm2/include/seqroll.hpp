@@ -336,6 +336,13 @@ protected:
 
     bool m_drawing_background_seq;
 
+    /**
+     *  This view's own list of the notes to draw, filled by
+     *  sequence::visit_notes() and reused from one redraw to the next.
+     */
+
+    NoteInfoList m_notes;
+
     /**
      *  Provides an option for expanding the number of measures while
      *  recording.  In essence, the "infinite" track we've wanted, thanks
@@ -136,19 +136,24 @@ mainwid::mainwid (perform & p, int ss)
     m_max_sets              (c_max_sets),
     m_screenset_slots       (m_mainwnd_rows * m_mainwnd_cols),
     m_screenset_offset      (m_screenset * m_screenset_slots),
-    m_progress_height       (usr().seqarea_seq_y() + 3)
+    m_progress_height       (usr().seqarea_seq_y() + 3),
+    m_change_subscriber
+    (
+        p.subscribe_changes(CHANGE_SEQUENCE | CHANGE_MUTE)
+    ),
+    m_changes               ()
 {
     if (is_nullptr(gs_mainwid_pointer))
         gs_mainwid_pointer = this;
 }
 
 /**
- *  A rote destructor.
+ *  Ends the subscription to the change records of the performance.
  */
 
 mainwid::~mainwid ()
 {
-    /* Empty body   */
+    perf().unsubscribe_changes(m_change_subscriber);
 }
 
 /**
@@ -451,97 +456,44 @@ mainwid::draw_sequence_on_pixmap (int seqnum)
                 draw_rectangle_on_pixmap(fg_color(), x, y, lx, ly, false);
             }
 
-            int low_note;                                   // for side-effect
-            int high_note;                                  // ditto
-            bool have_notes = seq->get_minmax_note_events(low_note, high_note);
-            if (have_notes)
+            /*
+             * Draw the note events in the sequence, from its cached
+             * thumbnail, which is rebuilt only after the pattern is edited.
+             */
+
+            Thumbnail tn = seq->thumbnail(m_seqarea_seq_x, m_seqarea_seq_y);
+            if (tn)
             {
-                int height = high_note - low_note + 2;      // 2-pixel border
-                int len = seq->get_length();
-                midipulse tick_s;
-                midipulse tick_f;
-                int note;
-                bool selected;
-                int velocity;
-                draw_type_t dt;
                 Color drawcolor = fg_color();
-                Color eventcolor = fg_color();
-
 #ifdef SEQ64_STAZED_TRANSPOSE
                 if (! seq->get_transposable())
-                {
-                    eventcolor = red();
                     drawcolor = red();
-                }
 #endif
-                /*
-                 * Draw the note events in the sequence.
-                 */
-
-                seq->reset_draw_marker();       /* reset container iterator */
-                do
+                for
+                (
+                    std::vector<thumb_line_t>::const_iterator tl =
+                        tn->tn_lines.begin();
+                    tl != tn->tn_lines.end(); ++tl
+                )
                 {
-                    dt = seq->get_next_note_event           /* side-effects */
-                    (
-                        tick_s, tick_f, note, selected, velocity
-                    );
-                    if (dt == DRAW_FIN)
-                        break;
-
-                    int tick_s_x = tick_s * m_seqarea_seq_x / len;
-                    int tick_f_x = tick_f * m_seqarea_seq_x / len;
-                    int note_y;
-                    if (dt == DRAW_TEMPO)
-                    {
-                        /*
-                         * Do not scale by the note range here.
-                         */
-
-                        note_y = m_seqarea_seq_y -
-                             m_seqarea_seq_y * (note + 1) / SEQ64_MAX_DATA_VALUE;
-                    }
-                    else
-                    {
-                        note_y = m_seqarea_seq_y -
-                             m_seqarea_seq_y * (note + 1 - low_note) / height;
-                    }
-                    if (dt == DRAW_NOTE_ON || dt == DRAW_NOTE_OFF)
-                        tick_f_x = tick_s_x + 1;
-
-                    if (tick_f_x <= tick_s_x)
-                        tick_f_x = tick_s_x + 1;
-
-                    if (dt == DRAW_TEMPO)
-                    {
-                        set_line(Gdk::LINE_SOLID, 2);
-                        drawcolor = tempo_paint();
-                        note_y = m_seqarea_seq_y -
-                             m_seqarea_seq_y * (note + 1) / SEQ64_MAX_DATA_VALUE;
-                    }
-
-                    int sx = rectangle_x + tick_s_x;            /* start x  */
-                    int fx = rectangle_x + tick_f_x;            /* finish x */
-                    int sy = rectangle_y + note_y;              /* start y  */
+                    int sx = rectangle_x + tl->tl_x0;           /* start x  */
+                    int fx = rectangle_x + tl->tl_x1;           /* finish x */
+                    int sy = rectangle_y + tl->tl_y;            /* start y  */
                     int fy = sy;                                /* finish y */
-                    draw_line_on_pixmap(drawcolor, sx, sy, fx, fy);
-
-                    if (dt == DRAW_TEMPO)
+                    if (tl->tl_tempo)
                     {
                         /*
                          * We would like to also draw a line from the end of
                          * the current tempo to the start of the next one.
-                         * But we currently have only the x value of the next
-                         * tempo.
-                         *
-                         * sx = fx;
-                         * fy = next tempo value scaled to 127;
                          */
 
+                        set_line(Gdk::LINE_SOLID, 2);
+                        draw_line_on_pixmap(tempo_paint(), sx, sy, fx, fy);
                         set_line(Gdk::LINE_SOLID, 1);
-                        drawcolor = eventcolor;
                     }
-
-                } while (dt != DRAW_FIN);
+                    else
+                        draw_line_on_pixmap(drawcolor, sx, sy, fx, fy);
+                }
             }
         }
         else                                            /* sequence inactive */
@@ -692,7 +644,10 @@ mainwid::redraw (int seqnum)
 /**
  *  Draw the cursors (long vertical bars) on each sequence, so that they
  *  follow the playing progress of each sequence in the mainwid (Patterns
- *  Panel).
+ *  Panel).  Called once per frame by the main window's timer, so this is
+ *  also where the change records of the performance are drained, and the
+ *  slots that were edited or muted/unmuted are redrawn.  A record for the
+ *  whole performance (the first one after subscribing) redraws every slot.
  *
  * \param tick
  *      Starting point for drawing the markers.
@@ -701,6 +656,24 @@ mainwid::redraw (int seqnum)
 void
 mainwid::update_markers (int tick)
 {
+    if (perf().poll_changes(m_change_subscriber, m_changes) > 0)
+    {
+        for
+        (
+            ChangeList::const_iterator c = m_changes.begin();
+            c != m_changes.end(); ++c
+        )
+        {
+            int seqnum = c->cr_seq;
+            if (seqnum == SEQ64_NULL_SEQUENCE)
+            {
+                for (int s = 0; s < m_screenset_slots; ++s)
+                    redraw(m_screenset_offset + s);
+            }
+            else if (valid_sequence(seqnum))
+                redraw(seqnum);
+        }
+    }
     for (int s = 0; s < m_screenset_slots; ++s)
         draw_marker_on_sequence(m_screenset_offset + s, tick);
 }
@@ -710,6 +683,10 @@ mainwid::update_markers (int tick)
  *  vertical progress bar.  If the sequence has no events, this function
  *  doesn't bother drawing a position marker.
  *
+ *  The slot is polled with perform::is_dirty_main() only if we could not
+ *  subscribe to change records; otherwise update_markers() has already
+ *  redrawn it if needed.
+ *
  *  Note that, when Sequencer64 first comes up, and perform::is_dirty_main()
  *  is called, no sequences exist yet.  Also, currently the redraw() is hit
  *  when seq_edit() is called, but not when seq_event_edit() is called, which
@@ -731,7 +708,7 @@ mainwid::update_markers (int tick)
 void
 mainwid::draw_marker_on_sequence (int seqnum, int tick)
 {
-    if (perf().is_dirty_main(seqnum))
+    if (m_change_subscriber < 0 && perf().is_dirty_main(seqnum))
         redraw(seqnum);
 
     if (perf().is_active(seqnum))           /* also checks for nullptr      */
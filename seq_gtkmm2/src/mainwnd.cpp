@@ -321,6 +321,7 @@ mainwnd::mainwnd
     m_button_tempo_log      (manage(new Gtk::Button())),
     m_button_tempo_record   (manage(new Gtk::ToggleButton())),
     m_is_tempo_recording    (false),
+    m_bpm_from_perform      (false),
     m_button_perfedit       (manage(new Gtk::Button())),
 #ifdef SEQ64_STAZED_MENU_BUTTONS
     m_image_songlive        (nullptr),
@@ -384,6 +385,11 @@ mainwnd::mainwnd
     m_entry_notes           (manage(new Gtk::Entry())),
     m_is_running            (false),
     m_timeout_connect       (),                     /* handler              */
+    m_change_subscriber
+    (
+        p.subscribe_changes(CHANGE_TEMPO | CHANGE_SCREENSET)
+    ),
+    m_changes               (),
 #ifdef SEQ64_MAINWND_TAP_BUTTON
     m_current_beats         (0),
     m_base_time_ms          (0),
@@ -1203,6 +1209,7 @@ mainwnd::mainwnd
 
 mainwnd::~mainwnd ()
 {
+    perf().unsubscribe_changes(m_change_subscriber);
     if (not_nullptr(m_perf_edit_2))
         delete m_perf_edit_2;
 
@@ -1336,6 +1343,8 @@ mainwnd::timer_callback ()
 {
     midipulse tick = perf().get_tick();         /* use no get_start_tick()! */
     midibpm bpm = perf().get_beats_per_minute();
+    perf().publish_patterns();                  /* edits, for playback  */
+    TempoMap tmap = perf().get_tempo_map();     /* rebuilt here after edits */
     update_markers(tick);
     if (m_button_queue->get_active() != perf().is_keep_queue())
         m_button_queue->set_active(perf().is_keep_queue());
@@ -1359,7 +1368,11 @@ mainwnd::timer_callback ()
         }
         else
         {
-            std::string t = pulses_to_timestring(tick, bpm, ppqn, false);
+            /*
+             * The elapsed time follows the tempo changes of the song.
+             */
+
+            std::string t = pulses_to_timestring(tick, *tmap, false);
             m_tick_time->set_text(t);
         }
     }
@@ -1373,10 +1386,38 @@ mainwnd::timer_callback ()
     }
 #endif
 
-    if (m_adjust_bpm->get_value() != bpm)
-        m_adjust_bpm->set_value(bpm);
+    /*
+     * The tempo and screen-set controls are brought up to date only when the
+     * perform object reports a change to them.
+     */
 
-    update_screenset();
+    unsigned changes = CHANGE_TEMPO | CHANGE_SCREENSET;
+    if (m_change_subscriber >= 0)
+    {
+        changes = CHANGE_NONE;
+        if (perf().poll_changes(m_change_subscriber, m_changes) > 0)
+        {
+            for
+            (
+                ChangeList::const_iterator c = m_changes.begin();
+                c != m_changes.end(); ++c
+            )
+            {
+                changes |= c->cr_changes;
+            }
+        }
+    }
+    if ((changes & CHANGE_TEMPO) != 0)
+    {
+        if (m_adjust_bpm->get_value() != bpm)
+        {
+            m_bpm_from_perform = true;
+            m_adjust_bpm->set_value(bpm);
+            m_bpm_from_perform = false;
+        }
+    }
+    if ((changes & CHANGE_SCREENSET) != 0)
+        update_screenset();
 
 #ifdef SEQ64_STAZED_MENU_BUTTONS
 
@@ -2648,12 +2689,18 @@ mainwnd::adj_callback_ss ()
 
 /**
  *  This function is the callback for adjusting the BPM value.
- *  Let the perform object keep track of modifications.
+ *  Let the perform object keep track of modifications.  It ignores the
+ *  updates that timer_callback() makes to show the current tempo, which
+ *  perform::apply_tempo() has already applied without changing the base
+ *  tempo of the song.
  */
 
 void
 mainwnd::adj_callback_bpm ()
 {
+    if (m_bpm_from_perform)
+        return;
+
     perf().set_beats_per_minute(midibpm(m_adjust_bpm->get_value()));
     if (m_is_tempo_recording)
         (void) perf().log_current_tempo();
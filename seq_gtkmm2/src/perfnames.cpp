@@ -98,7 +98,12 @@ perfnames::perfnames
     m_seqs_in_set           (usr().seqs_in_set()),          /* c_seqs_in_set*/
     m_sequence_max          (c_max_sequence),
     m_sequence_offset       (0),
-    m_sequence_active       ()                              /* an array     */
+    m_sequence_active       (),                             /* an array     */
+    m_change_subscriber
+    (
+        p.subscribe_changes(CHANGE_SEQUENCE | CHANGE_MUTE)
+    ),
+    m_changes               ()
 {
     for (int i = 0; i < m_sequence_max; ++i)
         m_sequence_active[i] = false;
@@ -489,13 +494,41 @@ perfnames::on_size_allocate (Gtk::Allocation & a)
 }
 
 /**
- *  Redraws sequences that have been modified.
+ *  Redraws sequences that have been modified.  The visible rows named by the
+ *  change records of the performance are redrawn; a record for the whole
+ *  performance redraws them all.  Without a subscription, each visible row
+ *  is polled instead.
  */
 
 void
 perfnames::redraw_dirty_sequences ()
 {
     int y_f = m_window_y / m_names_y;
+    if (m_change_subscriber >= 0)
+    {
+        if (perf().poll_changes(m_change_subscriber, m_changes) == 0)
+            return;
+
+        for
+        (
+            ChangeList::const_iterator c = m_changes.begin();
+            c != m_changes.end(); ++c
+        )
+        {
+            int first = m_sequence_offset;
+            int last = m_sequence_offset + y_f;
+            if (c->cr_seq != SEQ64_NULL_SEQUENCE)
+                first = last = c->cr_seq;
+
+            for (int seq = first; seq <= last; ++seq)
+            {
+                int y = seq - m_sequence_offset;
+                if (y >= 0 && y <= y_f && seq < m_sequence_max)
+                    draw_sequence(seq);
+            }
+        }
+        return;
+    }
     for (int y = 0; y <= y_f; ++y)
     {
         int seq = y + m_sequence_offset;
@@ -170,7 +170,12 @@ perfroll::perfroll
 #endif
     m_moving                (false),
     m_growing               (false),
-    m_grow_direction        (false)
+    m_grow_direction        (false),
+    m_change_subscriber
+    (
+        perf.subscribe_changes(CHANGE_SEQUENCE | CHANGE_MUTE)
+    ),
+    m_changes               ()
 {
     set_ppqn(ppqn);                                         // choose_ppqn(ppqn)
     for (int i = 0; i < m_sequence_max; ++i)
@@ -179,12 +184,13 @@ perfroll::perfroll
 
 /**
  *  This destructor deletes the interaction object.  Well, now there are two
- *  objects, so no explicit deletion necessary.
+ *  objects, so no explicit deletion necessary.  It does end the
+ *  subscription to change records.
  */
 
 perfroll::~perfroll ()
 {
-    // Empty body
+    perf().unsubscribe_changes(m_change_subscriber);
 }
 
 /**
@@ -861,7 +867,10 @@ void perfroll::draw_background_on (int seqnum)
 }
 
 /**
- *  Redraws patterns/sequences that have been modified.
+ *  Redraws patterns/sequences that have been modified.  These are now
+ *  named by the change records drained from the perform object, once per
+ *  frame, rather than found by polling every visible row.  A record for the
+ *  whole performance marks every visible row.
  *
  * \change ca 2016-05-30
  *      Lets try not drawing sequences greater than the maximum, at all.
@@ -872,13 +881,43 @@ perfroll::redraw_dirty_sequences ()
 {
     bool draw = false;
     int yf = m_window_y / m_names_y;
-    for (int y = 0; y <= yf; ++y)
+    if (m_change_subscriber >= 0)
     {
-        int seq = y + m_sequence_offset;
-        if (seq < m_sequence_max && perf().is_dirty_perf(seq))  /* see note */
+        if (perf().poll_changes(m_change_subscriber, m_changes) > 0)
+        {
+            for
+            (
+                ChangeList::const_iterator c = m_changes.begin();
+                c != m_changes.end(); ++c
+            )
+            {
+                int first = m_sequence_offset;
+                int last = m_sequence_offset + yf;
+                if (c->cr_seq != SEQ64_NULL_SEQUENCE)
+                    first = last = c->cr_seq;
+
+                for (int seq = first; seq <= last; ++seq)
+                {
+                    int y = seq - m_sequence_offset;
+                    if (y >= 0 && y <= yf && seq < m_sequence_max)
+                    {
+                        draw_sequence(seq);
+                        draw = true;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        for (int y = 0; y <= yf; ++y)
         {
-            draw_sequence(seq);
-            draw = true;
+            int seq = y + m_sequence_offset;
+            if (seq < m_sequence_max && perf().is_dirty_perf(seq))
+            {
+                draw_sequence(seq);                 /* see note above   */
+                draw = true;
+            }
         }
     }
     if (draw)
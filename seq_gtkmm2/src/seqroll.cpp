@@ -196,6 +196,7 @@ seqroll::seqroll
     m_trans_button_press    (false),
     m_background_sequence   (0),
     m_drawing_background_seq(false),
+    m_notes                 (),
     m_expanded_recording    (false),
     m_status                (0),
     m_cc                    (0)
@@ -768,7 +769,9 @@ seqroll::follow_progress ()
 
 /**
  *  Draws events on the given drawable area.  "Method 0" draws the background
- *  sequence, if active.  "Method 1" draws the sequence itself.
+ *  sequence, if active.  "Method 1" draws the sequence itself.  Only the
+ *  notes that fall in the visible part of the piano roll are fetched, with
+ *  one call to sequence::visit_notes() for each sequence.
  *
  * \param draw
  *      The "drawable" area to draw on.
@@ -777,14 +780,11 @@ seqroll::follow_progress ()
 void
 seqroll::draw_events_on (Glib::RefPtr<Gdk::Drawable> draw)
 {
-    midipulse tick_s;
-    midipulse tick_f;
-    int note;
-    bool selected;
-    int velocity;
-    draw_type_t dt;
-    int starttick = m_scroll_offset_ticks;
-    int endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
+    midipulse starttick = m_scroll_offset_ticks;
+    midipulse endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
+    int notetop = c_rollarea_y - m_scroll_offset_y;
+    int note_hi = notetop / c_key_y + 1;
+    int note_lo = (notetop - m_window_y) / c_key_y - 1;
     sequence * seq = nullptr;
     for (int method = 0; method < 2; ++method)  /* weird way to do it       */
     {
@@ -802,28 +802,24 @@ seqroll::draw_events_on (Glib::RefPtr<Gdk::Drawable> draw)
             seq = &m_seq;
 
         m_gc->set_foreground(black_paint());    /* draw boxes from sequence */
-        seq->reset_draw_marker();
-        while
+        seq->visit_notes(starttick, endtick, note_lo, note_hi, m_notes);
+        for
         (
-            (
-                dt = seq->get_next_note_event(tick_s, tick_f,
-                   note, selected, velocity)
-            ) != DRAW_FIN
+            NoteInfoList::const_iterator ni = m_notes.begin();
+            ni != m_notes.end(); ++ni
         )
         {
+            draw_type_t dt = ni->ni_type;
+            midipulse tick_s = ni->ni_tick_start;
+            midipulse tick_f = ni->ni_tick_finish;
+            int note = ni->ni_note;
+            bool selected = ni->ni_selected;
 #ifdef SEQ64_SEQROLL_DRAW_TEMPO
             bool istempo = dt == DRAW_TEMPO;
             bool do_draw = true;                    /* dt != DRAW_TEMPO;    */
 #else
             bool do_draw = dt != DRAW_TEMPO;
 #endif
-            if (do_draw)
-            {
-                do_draw = tick_s >= starttick && tick_s <= endtick;
-                if (! do_draw)
-                    do_draw = (dt == DRAW_NORMAL_LINKED) &&
-                        tick_f >= starttick && tick_f <= endtick;
-            }
             if (do_draw)
             {
                 int note_width;
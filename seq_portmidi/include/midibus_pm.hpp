@@ -101,7 +101,7 @@ protected:
      *
      * We should be able to implement this in a "sysex_fix" branch:
      *
-     * virtual void api_sysex (event * e24);
+     * virtual bool api_sysex (const midibyte * data, int len);
      *
      * This function should be able to be implemented in Windows and ALSA:
      *
@@ -104,6 +104,7 @@ public slots:
 
     void undo ();
     void redo ();
+    void conditionalUpdate ();
 
 private:
 
@@ -127,6 +128,8 @@ private:
 
     perform & mPerf;
     QTimer * mTimer;
+    unsigned long m_change_count;   // perf().change_count() last drawn
+    int m_progress_x;               // playhead last drawn
     QFont mFont;
     seq64::rect m_old;      // why do we need the namespace here?
     int m_snap;
@@ -94,6 +94,7 @@ private:
 
     perform & m_mainperf;
     QTimer * mTimer;
+    unsigned long m_change_count;   // m_mainperf.change_count() last drawn
     QFont mFont;
 
     int m_4bar_offset;
@@ -105,6 +106,8 @@ signals:
 
 public slots:
 
+    void conditionalUpdate ();
+
 };          // class qperftime
 
 }           // namespace seq64
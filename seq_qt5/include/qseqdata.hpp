@@ -94,6 +94,8 @@ signals:
 
 public slots:
 
+    void conditionalUpdate ();
+
 private:
 
     // Takes two points, returns a Xwin rectangle
@@ -108,6 +110,7 @@ private:
     sequence & m_seq;
     QRect * mOld;
     QTimer * mTimer;
+    unsigned long m_change_count;   // m_seq.change_count() last drawn
     QString mNumbers;
     QFont mFont;
     int m_zoom;
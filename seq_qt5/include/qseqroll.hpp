@@ -159,9 +159,11 @@ private:
     int m_current_y;
     int m_move_snap_offset_x;
 
-    int m_old_progress_x;   // playhead tracking
+    int m_progress_x;       // playhead tracking, see conditionalUpdate()
+    unsigned long m_change_count;   // m_seq.change_count() last drawn
     int m_background_sequence;
     bool m_drawing_background_seq;
+    NoteInfoList m_notes;   // this view's notes, see sequence::visit_notes()
     seq64::edit_mode_t editMode;
 
     int note_x;             // note drawing variables
@@ -177,6 +179,7 @@ signals:
 public slots:
 
     void updateEditMode (seq64::edit_mode_t mode);
+    void conditionalUpdate ();
 
 };          // class qseqroll
 
@@ -72,10 +72,13 @@ signals:
 
 private slots:
 
+    void conditionalUpdate ();
+
 private:
 
     sequence & m_seq;
     QTimer * m_timer;
+    unsigned long m_change_count;   // m_seq.change_count() last drawn
     QFont m_font;
     int m_zoom;
 
@@ -34,6 +34,7 @@
 
 #include <QFrame>
 #include <QPainter>
+#include <QPixmap>
 #include <QMenu>
 #include <QTimer>
 #include <QMessageBox>
@@ -104,7 +105,10 @@ private:
 private:
 
     void drawSequence (int seq);
-    void drawAllSequences ();
+    void drawAllSequences (const QRegion & damaged);
+    QRect slotRect (int seq) const;
+    QRect markerRect (int seq, int tick_x) const;
+    int markerX (seq64::sequence * s) const;
 
     // used to grab std::string bank name and convert it to QString for
     // display
@@ -142,12 +146,17 @@ private:
     bool mButtonDown;
     bool mMoving;                   // are we moving bewteen slots
     bool mAddingNew; /*we can add a new seq here, wait for double click*/
-    midipulse m_last_tick_x[qc_max_sequence];
+    midipulse m_last_tick_x[qc_max_sequence];   // marker drawn, see markerX()
     bool m_last_playing[qc_max_sequence];
+    seq64::sequence * m_slot_seqs[qc_max_sequence];     // as last drawn
+    unsigned long m_slot_changes[qc_max_sequence];      // change_count() drawn
+    Thumbnail m_thumbnails[qc_max_sequence];    // last drawn, see below
+    QPixmap m_thumb_pixmaps[qc_max_sequence];   // notes, re-made on edits
     bool mCanPaste;
 
 private slots:
 
+    void conditionalUpdate ();
     void updateBank (int newBank);
     void updateBankName ();
     void newSeq ();
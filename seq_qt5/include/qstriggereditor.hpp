@@ -89,6 +89,8 @@ signals:
 
 public slots:
 
+    void conditionalUpdate ();
+
 private:
 
     /* checks mins / maxes..  the fills in x,y and width and height */
@@ -109,6 +111,7 @@ private:
     QRect * m_old;
     QRect * m_selected;
     QTimer * mTimer;
+    unsigned long m_change_count;   // m_seq.change_count() last drawn
     QFont mFont;
 
     int m_zoom;             /* one pixel == m_zoom ticks */
@@ -53,6 +53,8 @@ qperfroll::qperfroll (perform & p, QWidget * parent)
     gui_palette_qt5     (),
     mPerf               (p),
     mTimer              (nullptr),
+    m_change_count      (0),
+    m_progress_x        (0),
     mFont               (),
     m_snap              (0),
     m_measure_length    (0),
@@ -94,10 +96,39 @@ qperfroll::qperfroll (perform & p, QWidget * parent)
     // Start refresh timer to queue regular redraws
     mTimer = new QTimer(this);
     mTimer->setInterval(50);
-    QObject::connect(mTimer, SIGNAL(timeout()), this, SLOT(update()));
+    QObject::connect
+    (
+        mTimer, SIGNAL(timeout()), this, SLOT(conditionalUpdate())
+    );
     mTimer->start();
 }
 
+/**
+ *  Called by the refresh timer.  Any change to the performance or to one of
+ *  its sequences (see perform::change_count()) repaints the whole roll.
+ *  Otherwise, while the song plays, only the old and new columns of the
+ *  progress line are repainted.
+ */
+
+void
+qperfroll::conditionalUpdate ()
+{
+    unsigned long changes = perf().change_count();
+    int progress_x = perf().get_tick() / (c_perf_scale_x * zoom);
+    if (changes != m_change_count)
+    {
+        m_change_count = changes;
+        m_progress_x = progress_x;
+        update();
+    }
+    else if (progress_x != m_progress_x)
+    {
+        update(m_progress_x - 1, 0, 3, height());
+        update(progress_x - 1, 0, 3, height());
+        m_progress_x = progress_x;
+    }
+}
+
 /**
  *
  */
@@ -346,13 +377,11 @@ qperfroll::paintEvent(QPaintEvent *)
     painter.setPen(pen);
     painter.drawRect(0, 0, width(), height() - 1);
 
-    //draw playhead
-    midipulse tick = perf().get_tick();
-    int progress_x = tick / (c_perf_scale_x * zoom);
+    //draw playhead, at the position noted by conditionalUpdate()
     pen.setColor(Qt::red);
     pen.setStyle(Qt::SolidLine);
     painter.setPen(pen);
-    painter.drawLine(progress_x, 1, progress_x, height() - 2);
+    painter.drawLine(m_progress_x, 1, m_progress_x, height() - 2);
 
 //  delete mPainter;
 //  delete mBrush;
@@ -537,6 +566,8 @@ qperfroll::mousePressEvent(QMouseEvent *event)
                 half_split_trigger(m_drop_sequence, m_drop_tick);
         }
     }
+
+    update();
 }
 
 /**
@@ -578,6 +609,8 @@ qperfroll::mouseReleaseEvent (QMouseEvent * event)
     m_adding_pressed = false;
     mBoxSelect = false;
     mLastTick = 0;
+
+    update();
 }
 
 /**
@@ -669,6 +702,8 @@ qperfroll::mouseMoveEvent (QMouseEvent * event)
         convert_xy(0, m_current_y, &tick, &m_drop_sequence);
     }
     mLastTick = tick;
+
+    update();
 }
 
 /**
@@ -712,6 +747,7 @@ qperfroll::keyPressEvent (QKeyEvent * event)
         }
     }
 
+    update();
 }
 
 /**
@@ -798,6 +834,8 @@ qperfroll::set_guides(int a_snap, int a_measure, int a_beat)
     m_snap = a_snap;
     m_measure_length = a_measure;
     m_beat_length = a_beat;
+
+    update();
 }
 
 /**
@@ -817,6 +855,8 @@ qperfroll::set_adding(bool a_adding)
         setCursor(Qt::ArrowCursor);
         m_adding = false;
     }
+
+    update();
 }
 
 /**
@@ -827,6 +867,8 @@ void
 qperfroll::undo()
 {
     perf().pop_trigger_undo();
+
+    update();
 }
 
 /**
@@ -837,6 +879,8 @@ void
 qperfroll::redo()
 {
     perf().pop_trigger_redo();
+
+    update();
 }
 
 /**
@@ -848,6 +892,8 @@ qperfroll::zoom_in()
 {
     if (zoom > 1)
         zoom *= 0.5;
+
+    update();
 }
 
 /**
@@ -858,6 +904,8 @@ void
 qperfroll::zoom_out()
 {
     zoom *= 2;
+
+    update();
 }
 
 /**
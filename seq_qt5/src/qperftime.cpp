@@ -50,18 +50,39 @@ qperftime::qperftime(perform & p, QWidget * parent)
     QWidget             (parent),
     m_mainperf          (p),
     mTimer              (new QTimer(this)), // refresh timer for redraws
+    m_change_count      (0),
     mFont               (),
     m_4bar_offset       (0),
     m_snap              (c_ppqn),
     m_measure_length    (c_ppqn * 4),
     zoom                (1)
 {
-    QObject::connect(mTimer, SIGNAL(timeout()), this, SLOT(update()));
+    QObject::connect
+    (
+        mTimer, SIGNAL(timeout()), this, SLOT(conditionalUpdate())
+    );
     mTimer->setInterval(50);
     mTimer->start();
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
 }
 
+/**
+ *  Called by the refresh timer.  The song time line is repainted when the
+ *  performance change count moves, for example when the L/R markers are set
+ *  elsewhere.  Clicks here call update() directly.
+ */
+
+void
+qperftime::conditionalUpdate ()
+{
+    unsigned long changes = m_mainperf.change_count();
+    if (changes != m_change_count)
+    {
+        m_change_count = changes;
+        update();
+    }
+}
+
 /**
  *
  */
@@ -168,6 +189,8 @@ qperftime::mousePressEvent (QMouseEvent * event)
     }
     else
         perf().set_tick(tick);              // reposition timecode
+
+    update();
 }
 
 /**
@@ -199,6 +222,8 @@ qperftime::zoom_in ()
 {
     if (zoom > 1)
         zoom *= 0.5;
+
+    update();
 }
 
 /**
@@ -209,6 +234,8 @@ void
 qperftime::zoom_out ()
 {
     zoom *= 2;
+
+    update();
 }
 
 /**
@@ -220,6 +247,8 @@ qperftime::set_guides (int snap, int measure)
 {
     m_snap = snap;
     m_measure_length = measure;
+
+    update();
 }
 
 }           // namespace seq64
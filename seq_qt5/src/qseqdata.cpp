@@ -56,6 +56,7 @@ qseqdata::qseqdata (sequence & seq, QWidget * parent)
     m_seq           (seq),
     mOld            (new QRect()),
     mTimer          (nullptr),          // (new QTimer(this)),
+    m_change_count  (0),
     mNumbers        (),
     mFont           (),
     m_zoom          (1),
@@ -71,10 +72,30 @@ qseqdata::qseqdata (sequence & seq, QWidget * parent)
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
     mTimer = new QTimer(this);  // start refresh timer to queue regular redraws
     mTimer->setInterval(20);
-    QObject::connect(mTimer, SIGNAL(timeout()), this, SLOT(update()));
+    QObject::connect
+    (
+        mTimer, SIGNAL(timeout()), this, SLOT(conditionalUpdate())
+    );
     mTimer->start();
 }
 
+/**
+ *  Called by the refresh timer.  The data pane is repainted only when the
+ *  sequence reports a change; dragging a new level in this pane calls
+ *  update() directly.
+ */
+
+void
+qseqdata::conditionalUpdate ()
+{
+    unsigned long changes = m_seq.change_count();
+    if (changes != m_change_count)
+    {
+        m_change_count = changes;
+        update();
+    }
+}
+
 /**
  *
  */
@@ -84,6 +105,8 @@ qseqdata::zoom_in ()
 {
     if (m_zoom > 1)
         m_zoom *= 0.5;
+
+    update();
 }
 
 /**
@@ -95,6 +118,8 @@ qseqdata::zoom_out ()
 {
     if (m_zoom < 32)
         m_zoom *= 2;
+
+    update();
 }
 
 /**
@@ -232,6 +257,8 @@ qseqdata::mousePressEvent (QMouseEvent *event)
     mOld->setY(0);
     mOld->setWidth(0);
     mOld->setHeight(0);
+
+    update();
 }
 
 /**
@@ -265,6 +292,8 @@ qseqdata::mouseReleaseEvent (QMouseEvent *event)
     }
     else if (mRelativeAdjust)
         mRelativeAdjust = false;
+
+    update();
 }
 
 /**
@@ -316,6 +345,8 @@ qseqdata::mouseMoveEvent (QMouseEvent * event)
 
         mDropY = mCurrentY;
     }
+
+    update();
 }
 
 /**
@@ -360,6 +391,8 @@ qseqdata::set_data_type (midibyte a_status, midibyte a_control = 0)
 {
     m_status = a_status;
     m_cc = a_control;
+
+    update();
 }
 
 /**
@@ -87,7 +87,8 @@ qseqroll::qseqroll
     m_current_x             (0),
     m_current_y             (0),
     m_move_snap_offset_x    (0),
-    m_old_progress_x        (0),
+    m_progress_x            (0),
+    m_change_count          (0),
     m_background_sequence   (0),
     m_drawing_background_seq (false),
     editMode                (mode),
@@ -106,16 +107,47 @@ qseqroll::qseqroll
 
     mTimer = new QTimer(this);
     mTimer->setInterval(20);
-    QObject::connect(mTimer, SIGNAL(timeout()), this, SLOT(update()));
+    QObject::connect
+    (
+        mTimer, SIGNAL(timeout()), this, SLOT(conditionalUpdate())
+    );
     mTimer->start();
 }
 
+/**
+ *  Called by the refresh timer.  The whole roll is repainted only if the
+ *  sequence has changed since the last look; otherwise, if the progress bar
+ *  has moved, only the strips under its old and new positions are repainted.
+ *  With the transport stopped and nothing edited, nothing is repainted.
+ *  Changes made with the mouse or keyboard in this widget call update()
+ *  directly.
+ */
+
+void
+qseqroll::conditionalUpdate ()
+{
+    unsigned long changes = m_seq.change_count();
+    int progress_x = m_seq.get_last_tick() / m_zoom + c_keyboard_padding_x;
+    if (changes != m_change_count)
+    {
+        m_change_count = changes;
+        m_progress_x = progress_x;
+        update();
+    }
+    else if (progress_x != m_progress_x)
+    {
+        update(m_progress_x - 1, 0, 3, height());
+        update(progress_x - 1, 0, 3, height());
+        m_progress_x = progress_x;
+    }
+}
+
 /**
  *
  */
 
 void
-qseqroll::paintEvent (QPaintEvent *)
+qseqroll::paintEvent (QPaintEvent * event)
 {
     QPainter painter(this);
     QBrush brush(Qt::NoBrush);
@@ -221,17 +253,23 @@ qseqroll::paintEvent (QPaintEvent *)
     pen.setColor(Qt::red);                // draw the playhead
     pen.setStyle(Qt::SolidLine);
     painter.setPen(pen);
-    painter.drawLine(m_old_progress_x, 0, m_old_progress_x, height() * 8);
-    m_old_progress_x = (m_seq.get_last_tick() / m_zoom + c_keyboard_padding_x);
+    painter.drawLine(m_progress_x, 0, m_progress_x, height() * 8);
+
+    /*
+     * Draw notes.  Only the notes in the exposed part of the widget are
+     * fetched, with some slack on the left for the width of drum hits.
+     */
+
+    QRect area = event->rect();
+    midipulse start_tick =
+        (area.left() - c_keyboard_padding_x - keyY) * m_zoom;
+
+    midipulse end_tick = (area.right() - c_keyboard_padding_x) * m_zoom;
+    int note_hi = (keyAreaY - area.top()) / keyY + 1;
+    int note_lo = (keyAreaY - area.bottom()) / keyY - 1;
+    if (start_tick < 0)
+        start_tick = 0;
 
-    midipulse tick_s;                       // draw notes
-    midipulse tick_f;
-    int note;
-    bool selected;
-    int velocity;
-    draw_type_t dt;
-    int start_tick = 0;
-    int end_tick = (width() * m_zoom);
     sequence * seq = nullptr;
     for (int method = 0; method < 2; ++method)
     {
@@ -250,161 +288,152 @@ qseqroll::paintEvent (QPaintEvent *)
 
         pen.setColor(Qt::black);      /* draw boxes from sequence */
         pen.setStyle(Qt::SolidLine);
-        seq->reset_draw_marker();
-        while
+        seq->visit_notes(start_tick, end_tick, note_lo, note_hi, m_notes);
+        for
         (
-            (
-                dt = seq->get_next_note_event
-                (
-                    tick_s, tick_f, note, selected, velocity
-                )
-            ) != DRAW_FIN
+            NoteInfoList::const_iterator ni = m_notes.begin();
+            ni != m_notes.end(); ++ni
         )
         {
-            if
-            (
-                (tick_s >= start_tick && tick_s <= end_tick) ||
-                (
-                    (dt == DRAW_NORMAL_LINKED) &&
-                    (tick_f >= start_tick && tick_f <= end_tick)
-                )
-            )
+            draw_type_t dt = ni->ni_type;
+            midipulse tick_s = ni->ni_tick_start;
+            midipulse tick_f = ni->ni_tick_finish;
+            int note = ni->ni_note;
+            bool selected = ni->ni_selected;
+            note_x = tick_s / m_zoom + c_keyboard_padding_x;
+            note_y = keyAreaY - (note * keyY) - keyY - 1 + 2;
+            switch (editMode)
             {
-                note_x = tick_s / m_zoom + c_keyboard_padding_x;
-                note_y = keyAreaY - (note * keyY) - keyY - 1 + 2;
-                switch (editMode)
-                {
-                case EDIT_MODE_NOTE:
-                    note_height = keyY - 3;
-                    break;
+            case EDIT_MODE_NOTE:
+                note_height = keyY - 3;
+                break;
 
-                case EDIT_MODE_DRUM:
-                    note_height = keyY;
-                    break;
-                }
+            case EDIT_MODE_DRUM:
+                note_height = keyY;
+                break;
+            }
 
-                int in_shift = 0;
-                int length_add = 0;
-                if (dt == DRAW_NORMAL_LINKED)
+            int in_shift = 0;
+            int length_add = 0;
+            if (dt == DRAW_NORMAL_LINKED)
+            {
+                if (tick_f >= tick_s)
                 {
-                    if (tick_f >= tick_s)
-                    {
-                        note_width = (tick_f - tick_s) / m_zoom;
-                        if (note_width < 1)
-                            note_width = 1;
-                    }
-                    else
-                        note_width = (m_seq.get_length() - tick_s) / m_zoom;
+                    note_width = (tick_f - tick_s) / m_zoom;
+                    if (note_width < 1)
+                        note_width = 1;
                 }
                 else
-                    note_width = 16 / m_zoom;
+                    note_width = (m_seq.get_length() - tick_s) / m_zoom;
+            }
+            else
+                note_width = 16 / m_zoom;
 
-                if (dt == DRAW_NOTE_ON)
-                {
-                    in_shift = 0;
-                    length_add = 2;
-                }
+            if (dt == DRAW_NOTE_ON)
+            {
+                in_shift = 0;
+                length_add = 2;
+            }
+
+            if (dt == DRAW_NOTE_OFF)
+            {
+                in_shift = -1;
+                length_add = 1;
+            }
+            pen.setColor(Qt::black);
+            if (method == 0)
+                pen.setColor(Qt::darkGray);
+
+            brush.setStyle(Qt::SolidPattern);
+            brush.setColor(Qt::black);
+            painter.setBrush(brush);
+            painter.setPen(pen);
+            switch (editMode)
+            {
+            case EDIT_MODE_NOTE:
 
-                if (dt == DRAW_NOTE_OFF)
+                // Draw outer note boundary (shadow)
+
+                painter.drawRect(note_x, note_y, note_width, note_height);
+                if (tick_f < tick_s)    // shadow for notes  before zero
                 {
-                    in_shift = -1;
-                    length_add = 1;
+                    painter.setPen(pen);
+                    painter.drawRect
+                    (
+                        c_keyboard_padding_x, note_y,
+                        tick_f / m_zoom, note_height
+                    );
                 }
-                pen.setColor(Qt::black);
-                if (method == 0)
-                    pen.setColor(Qt::darkGray);
+                break;
 
-                brush.setStyle(Qt::SolidPattern);
-                brush.setColor(Qt::black);
-                painter.setBrush(brush);
-                painter.setPen(pen);
-                switch (editMode)
+            case EDIT_MODE_DRUM:
+                QPointF points[4] =     // polygon for drum hits
                 {
-                case EDIT_MODE_NOTE:
-
-                    // Draw outer note boundary (shadow)
-
-                    painter.drawRect(note_x, note_y, note_width, note_height);
-                    if (tick_f < tick_s)    // shadow for notes  before zero
-                    {
-                        painter.setPen(pen);
-                        painter.drawRect
-                        (
-                            c_keyboard_padding_x, note_y,
-                            tick_f / m_zoom, note_height
-                        );
-                    }
-                    break;
+                    QPointF(note_x - note_height * 0.5,
+                            note_y + note_height * 0.5),
+                    QPointF(note_x, note_y),
+                    QPointF(note_x + note_height * 0.5,
+                            note_y + note_height * 0.5),
+                    QPointF(note_x, note_y + note_height)
+                };
+                painter.drawPolygon(points, 4);
+                break;
+            }
 
-                case EDIT_MODE_DRUM:
-                    QPointF points[4] =     // polygon for drum hits
-                    {
-                        QPointF(note_x - note_height * 0.5,
-                                note_y + note_height * 0.5),
-                        QPointF(note_x, note_y),
-                        QPointF(note_x + note_height * 0.5,
-                                note_y + note_height * 0.5),
-                        QPointF(note_x, note_y + note_height)
-                    };
-                    painter.drawPolygon(points, 4);
-                    break;
-                }
+            // Draw note highlight if there's room, always draw them in
+            // drum mode
 
-                // Draw note highlight if there's room, always draw them in
-                // drum mode
+            if (note_width > 3 || editMode == EDIT_MODE_DRUM)
+            {
+                // red noted selected, otherwise plain white
+                if (selected)
+                    brush.setColor(Qt::red);
+                else
+                    brush.setColor(Qt::white);
 
-                if (note_width > 3 || editMode == EDIT_MODE_DRUM)
+                painter.setBrush(brush);
+                if (method == 1)
                 {
-                    // red noted selected, otherwise plain white
-                    if (selected)
-                        brush.setColor(Qt::red);
-                    else
-                        brush.setColor(Qt::white);
-
-                    painter.setBrush(brush);
-                    if (method == 1)
+                    switch (editMode)
                     {
-                        switch (editMode)
+                    case EDIT_MODE_NOTE: // if the note fits in the grid
+                        if (tick_f >= tick_s)
                         {
-                        case EDIT_MODE_NOTE: // if the note fits in the grid
-                            if (tick_f >= tick_s)
-                            {
-                                // draw inner note (highlight)
-                                painter.drawRect
-                                (
-                                    note_x + in_shift, note_y,
-                                    note_width - 1 + length_add, note_height - 1
-                                );
-                            }
-                            else
-                            {
-                                painter.drawRect
-                                (
-                                    note_x + in_shift, note_y,
-                                    note_width, note_height - 1
-                                );
-                                painter.drawRect
-                                (
-                                    c_keyboard_padding_x, note_y,
-                                    (tick_f / m_zoom) - 3 + length_add,
-                                    note_height - 1
-                                );
-                            }
-                            break;
-
-                        case EDIT_MODE_DRUM: // draw inner note (highlight)
-                            QPointF points[4] =
-                            {
-                                QPointF(note_x - note_height * 0.5,
-                                        note_y + note_height * 0.5),
-                                QPointF(note_x, note_y),
-                                QPointF(note_x + note_height * 0.5 - 1,
-                                        note_y + note_height * 0.5),
-                                QPointF(note_x, note_y + note_height - 1)
-                            };
-                            painter.drawPolygon(points, 4);
-                            break;
+                            // draw inner note (highlight)
+                            painter.drawRect
+                            (
+                                note_x + in_shift, note_y,
+                                note_width - 1 + length_add, note_height - 1
+                            );
                         }
+                        else
+                        {
+                            painter.drawRect
+                            (
+                                note_x + in_shift, note_y,
+                                note_width, note_height - 1
+                            );
+                            painter.drawRect
+                            (
+                                c_keyboard_padding_x, note_y,
+                                (tick_f / m_zoom) - 3 + length_add,
+                                note_height - 1
+                            );
+                        }
+                        break;
+
+                    case EDIT_MODE_DRUM: // draw inner note (highlight)
+                        QPointF points[4] =
+                        {
+                            QPointF(note_x - note_height * 0.5,
+                                    note_y + note_height * 0.5),
+                            QPointF(note_x, note_y),
+                            QPointF(note_x + note_height * 0.5 - 1,
+                                    note_y + note_height * 0.5),
+                            QPointF(note_x, note_y + note_height - 1)
+                        };
+                        painter.drawPolygon(points, 4);
+                        break;
                     }
                 }
             }
@@ -691,6 +720,8 @@ qseqroll::mousePressEvent (QMouseEvent * event)
     }
     if (needs_update)       // set seq dirty if something's changed
         m_seq.set_dirty();
+
+    update();
 }
 
 /**
@@ -795,6 +826,8 @@ qseqroll::mouseReleaseEvent (QMouseEvent * event)
     m_seq.unpaint_all();
     if (needs_update)           /* if they clicked, something changed */
         m_seq.set_dirty();
+
+    update();
 }
 
 /**
@@ -828,6 +861,8 @@ qseqroll::mouseMoveEvent (QMouseEvent * event)
         convert_xy(m_current_x, m_current_y, tick, note);
         m_seq.add_note(tick, m_note_length - 2, note, true);
     }
+
+    update();
 }
 
 /**
@@ -837,6 +872,7 @@ qseqroll::mouseMoveEvent (QMouseEvent * event)
 void
 qseqroll::keyPressEvent (QKeyEvent * event)
 {
+    update();                           /* most of these keys edit  */
     if (event->key() == Qt::Key_Delete || event->key() == Qt::Key_Backspace)
     {
         m_seq.push_undo();
@@ -1104,6 +1140,8 @@ qseqroll::zoom_in ()
 {
     if (m_zoom > 1)
         m_zoom *= 0.5;
+
+    update();
 }
 
 /**
@@ -1115,6 +1153,8 @@ qseqroll::zoom_out ()
 {
     if (m_zoom < 32)
         m_zoom *= 2;
+
+    update();
 }
 
 /**
@@ -1125,6 +1165,7 @@ void
 qseqroll::updateEditMode (edit_mode_t mode)
 {
     editMode = mode;
+    update();
 }
 
 }           // namespace seq64
@@ -50,15 +50,35 @@ qseqtime::qseqtime (sequence & seq, QWidget * parent)
     QWidget     (parent),
     m_seq       (seq),
     m_timer     (new QTimer(this)),  // refresh timer to queue regular redraws
+    m_change_count(0),
     m_font      (),
     m_zoom      (1)
 {
-    QObject::connect(m_timer, SIGNAL(timeout()), this, SLOT(update()));
+    QObject::connect
+    (
+        m_timer, SIGNAL(timeout()), this, SLOT(conditionalUpdate())
+    );
     m_timer->setInterval(50);
     m_timer->start();
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
 }
 
+/**
+ *  Called by the refresh timer.  The time line only needs repainting when
+ *  the sequence (its length or time signature) changes, or on zooming.
+ */
+
+void
+qseqtime::conditionalUpdate ()
+{
+    unsigned long changes = m_seq.change_count();
+    if (changes != m_change_count)
+    {
+        m_change_count = changes;
+        update();
+    }
+}
+
 /**
  *
  */
@@ -176,6 +196,8 @@ qseqtime::zoom_in ()
 {
     if (m_zoom > 1)
         m_zoom *= 0.5;
+
+    update();
 }
 
 /**
@@ -187,6 +209,8 @@ qseqtime::zoom_out ()
 {
     if (m_zoom < 32)
         m_zoom *= 2;
+
+    update();
 }
 
 }           // namespace seq64
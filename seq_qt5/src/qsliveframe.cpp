@@ -70,6 +70,10 @@ qsliveframe::qsliveframe (perform & perf, QWidget * parent)
     mAddingNew          (false),
     m_last_tick_x       (),             // array
     m_last_playing      (),             // array
+    m_slot_seqs         (),             // array
+    m_slot_changes      (),             // array
+    m_thumbnails        (),             // array
+    m_thumb_pixmaps     (),             // array
     mCanPaste           (false)
 {
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -98,7 +102,10 @@ qsliveframe::qsliveframe (perform & perf, QWidget * parent)
 
     mRedrawTimer = new QTimer(this);
     mRedrawTimer->setInterval(50);
-    connect(mRedrawTimer, SIGNAL(timeout()), this, SLOT(update()));
+    connect
+    (
+        mRedrawTimer, SIGNAL(timeout()), this, SLOT(conditionalUpdate())
+    );
     mRedrawTimer->start();
 }
 
@@ -118,9 +125,103 @@ qsliveframe::~qsliveframe()
  */
 
 void
-qsliveframe::paintEvent (QPaintEvent *)
+qsliveframe::paintEvent (QPaintEvent * event)
+{
+    thumbW = (ui->frame->width() - 1 - qc_mainwid_spacing * 8) / qc_mainwnd_cols;
+    thumbH = (ui->frame->height() - 1 - qc_mainwid_spacing * 5) / qc_mainwnd_rows;
+    drawAllSequences(event->region());
+}
+
+/**
+ *  Called by the refresh timer.  Instead of repainting the whole grid, it
+ *  marks as damaged only the slots whose sequence has changed (see
+ *  sequence::change_count()) or been added or removed, and, for the other
+ *  slots, the old and new columns of the progress marker, if it has moved.
+ *  While the transport is stopped and nothing changes, nothing is painted.
+ */
+
+void
+qsliveframe::conditionalUpdate ()
+{
+    if (thumbW <= 0 || previewW <= 0)           /* not painted yet          */
+    {
+        update();
+        return;
+    }
+
+    int offset = m_bank_id * qc_mainwnd_rows * qc_mainwnd_cols;
+    for (int i = 0; i < qc_mainwnd_rows * qc_mainwnd_cols; ++i)
+    {
+        int seq = offset + i;
+        sequence * s = mPerf.get_sequence(seq);
+        unsigned long changes = not_nullptr(s) ? s->change_count() : 0 ;
+        if (s != m_slot_seqs[seq] || changes != m_slot_changes[seq])
+        {
+            m_slot_seqs[seq] = s;
+            m_slot_changes[seq] = changes;
+            if (not_nullptr(s))
+                m_last_tick_x[seq] = markerX(s);
+
+            update(slotRect(seq));
+        }
+        else if (not_nullptr(s))
+        {
+            int tick_x = markerX(s);
+            if (tick_x != m_last_tick_x[seq])
+            {
+                update(markerRect(seq, m_last_tick_x[seq]));
+                update(markerRect(seq, tick_x));
+                m_last_tick_x[seq] = tick_x;
+            }
+        }
+    }
+}
+
+/**
+ *  Provides the area covered by a pattern slot, including the thick border
+ *  drawn around a playing pattern.
+ */
+
+QRect
+qsliveframe::slotRect (int seq) const
+{
+    int i = (seq / qc_mainwnd_rows) % qc_mainwnd_cols;
+    int j =  seq % qc_mainwnd_rows;
+    int base_x = (ui->frame->x() + 1 + (thumbW + qc_mainwid_spacing) * i);
+    int base_y = (ui->frame->y() + 1 + (thumbH + qc_mainwid_spacing) * j);
+    return QRect(base_x - 1, base_y - 1, thumbW + 4, thumbH + 4);
+}
+
+/**
+ *  Provides the column covered by the progress marker of a slot, drawn by
+ *  drawSequence() one pixel left of the given offset into the note box,
+ *  which starts 9 pixels into the slot.
+ */
+
+QRect
+qsliveframe::markerRect (int seq, int tick_x) const
+{
+    QRect slot = slotRect(seq);
+    return QRect(slot.x() + 1 + 9 + tick_x - 2, slot.y(), 3, slot.height());
+}
+
+/**
+ *  Calculates the offset of the progress marker of a pattern into the note
+ *  box of its slot, from the current tick.  Uses the note box width left by
+ *  the last drawSequence().
+ */
+
+int
+qsliveframe::markerX (sequence * s) const
 {
-    drawAllSequences();
+    int length = s->get_length();
+    if (length <= 0)
+        return 0;
+
+    midipulse tick = mPerf.get_tick();
+    tick += length - s->get_trigger_offset();
+    tick %= length;
+    return int(tick * previewW / length);
 }
 
 /**
@@ -143,10 +244,9 @@ qsliveframe::drawSequence (int seq)
     midipulse tick = mPerf.get_tick();  // timing info for timed draw elements
     int metro = (tick / c_ppqn) % 2;
 
-    // Grab frame dimensions for scaled drawing
+    // Frame dimensions for scaled drawing (thumbW, thumbH) come from
+    // paintEvent()
 
-    thumbW = (ui->frame->width() - 1 - qc_mainwid_spacing * 8) / qc_mainwnd_cols;
-    thumbH = (ui->frame->height() - 1 - qc_mainwid_spacing * 5) / qc_mainwnd_rows;
     previewW = thumbW - mFont.pointSize() * 2;
     previewH = thumbH - mFont.pointSize() * 5;
     if
@@ -155,10 +255,9 @@ qsliveframe::drawSequence (int seq)
         seq < ((m_bank_id + 1) * qc_mainwnd_rows * qc_mainwnd_cols)
     )
     {
-        int i = (seq / qc_mainwnd_rows) % qc_mainwnd_cols;
-        int j =  seq % qc_mainwnd_rows;
-        int base_x = (ui->frame->x() + 1 + (thumbW + qc_mainwid_spacing) * i);
-        int base_y = (ui->frame->y() + 1 + (thumbH + qc_mainwid_spacing) * j);
+        QRect slot = slotRect(seq);
+        int base_x = slot.x() + 1;
+        int base_y = slot.y() + 1;
         sequence * s = mPerf.get_sequence(seq);
         if (not_nullptr(s))
         {
@@ -264,60 +363,52 @@ qsliveframe::drawSequence (int seq)
             //draw inner box for notes
             painter.drawRect(rectangle_x-2, rectangle_y-1, previewW, previewH);
 
-            int lowest_note;    //  = s->get_lowest_note_event();
-            int highest_note;   //  = s->get_highest_note_event();
-            (void) s->get_minmax_note_events(lowest_note, highest_note);
-
-            int height = highest_note - lowest_note + 2;
-            int length = s->get_length();
-            long tick_s;
-            long tick_f;
-            int note;
-            bool selected;
-            int velocity;
-            draw_type_t dt;
-            s->reset_draw_marker();
-
             previewH -= 6;          // add padding to box measurements
             previewW -= 6;
             rectangle_x += 2;
             rectangle_y += 2;
 
-            while
-            (
+            /*
+             * The notes are drawn from the sequence's cached thumbnail into
+             * a pixmap for this slot, only when the pattern has been edited
+             * or the frame resized.  Otherwise the pixmap is just copied.
+             */
+
+            Thumbnail tn = s->thumbnail(previewW, previewH);
+            if (tn && tn != m_thumbnails[seq])
+            {
+                QPixmap notes(previewW + 4, previewH + 4);
+                notes.fill(Qt::transparent);
+
+                QPainter notepainter(&notes);
+                QPen notepen(Qt::black);
+                notepen.setWidth(2);
+                notepainter.setPen(notepen);
+                for
                 (
-                    dt = s->get_next_note_event
+                    std::vector<thumb_line_t>::const_iterator tl =
+                        tn->tn_lines.begin();
+                    tl != tn->tn_lines.end(); ++tl
+                )
+                {
+                    notepainter.drawLine
                     (
-                        tick_s, tick_f, note, selected, velocity
-                    )
-                ) != DRAW_FIN
-            )
+                        tl->tl_x0 + 2, tl->tl_y + 2, tl->tl_x1 + 2, tl->tl_y + 2
+                    );
+                }
+                notepainter.end();
+                m_thumbnails[seq] = tn;
+                m_thumb_pixmaps[seq] = notes;
+            }
+            if (tn)
             {
-                int note_y = previewH -
-                             (previewH  * (note + 1 - lowest_note)) / height ;
-
-                int tick_s_x = (tick_s * previewW)  / length;
-                int tick_f_x = (tick_f * previewH)  / length;
-
-                if (dt == DRAW_NOTE_ON || dt == DRAW_NOTE_OFF)
-                    tick_f_x = tick_s_x + 1;
-                if (tick_f_x <= tick_s_x)
-                    tick_f_x = tick_s_x + 1;
-
-                pen.setColor(Qt::black); // draw line representing this note
-                pen.setWidth(2);
-                painter.setPen(pen);
-                painter.drawLine(rectangle_x + tick_s_x,
-                                   rectangle_y + note_y,
-                                   rectangle_x + tick_f_x,
-                                   rectangle_y + note_y);
+                painter.drawPixmap
+                (
+                    rectangle_x - 2, rectangle_y - 2, m_thumb_pixmaps[seq]
+                );
             }
 
-            int a_tick = mPerf.get_tick();     // draw playhead
-            a_tick += (length - s->get_trigger_offset());
-            a_tick %= length;
-
-            midipulse tick_x = a_tick * previewW / length;
+            int tick_x = m_last_tick_x[seq];   // playhead, see markerX()
             if (s->get_playing())
                 pen.setColor(Qt::red);
             else
@@ -367,12 +458,13 @@ qsliveframe::drawSequence (int seq)
  */
 
 void
-qsliveframe::drawAllSequences ()
+qsliveframe::drawAllSequences (const QRegion & damaged)
 {
+    int offset = m_bank_id * qc_mainwnd_rows * qc_mainwnd_cols;
     for (int i = 0; i < (qc_mainwnd_rows * qc_mainwnd_cols); i++)
     {
-        drawSequence(i + (m_bank_id * qc_mainwnd_rows * qc_mainwnd_cols));
-        m_last_tick_x[i + (m_bank_id * qc_mainwnd_rows * qc_mainwnd_cols)] = 0;
+        if (damaged.intersects(slotRect(offset + i)))
+            drawSequence(offset + i);
     }
 }
 
@@ -405,7 +497,7 @@ qsliveframe::setBank (int newBank)
 void
 qsliveframe::redraw ()
 {
-    drawAllSequences();
+    update();
 }
 
 /**
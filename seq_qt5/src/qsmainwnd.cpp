@@ -411,12 +411,16 @@ qsmainwnd::update_window_title ()
 }
 
 /**
- *
+ *  Called by the GUI timer.  Also publishes the pattern edits for playback,
+ *  and rebuilds the tempo map of the performance if the tempo track has been
+ *  edited, since the output thread only reads them.
  */
 
 void
 qsmainwnd::refresh ()
 {
+    perf().publish_patterns();
+    (void) perf().get_tempo_map();
     m_beat_ind->update();
 }
 
@@ -62,6 +62,7 @@ qstriggereditor::qstriggereditor
     m_old               (new QRect()),
     m_selected          (new QRect()),
     mTimer              (new QTimer(this)), // refresh timer for regular redraws
+    m_change_count      (0),
     mFont               (),
     m_zoom              (1),
     m_snap              (1),
@@ -86,11 +87,31 @@ qstriggereditor::qstriggereditor
     m_snap = m_seq.get_snap_tick();
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
 
-    QObject::connect(mTimer, SIGNAL(timeout()), this, SLOT(update()));
+    QObject::connect
+    (
+        mTimer, SIGNAL(timeout()), this, SLOT(conditionalUpdate())
+    );
     mTimer->setInterval(20);
     mTimer->start();
 }
 
+/**
+ *  Called by the refresh timer.  Like the piano roll, the event strip is
+ *  repainted only when the sequence change count has moved, or when a mouse
+ *  or key handler here calls update().
+ */
+
+void
+qstriggereditor::conditionalUpdate ()
+{
+    unsigned long changes = m_seq.change_count();
+    if (changes != m_change_count)
+    {
+        m_change_count = changes;
+        update();
+    }
+}
+
 /**
  *
  */
@@ -100,6 +121,8 @@ qstriggereditor::zoom_in()
 {
     if (m_zoom > 1)
         m_zoom *= 0.5;
+
+    update();
 }
 
 /**
@@ -111,6 +134,8 @@ qstriggereditor::zoom_out()
 {
     if (m_zoom < 32)
         m_zoom *= 2;
+
+    update();
 }
 
 /**
@@ -403,6 +428,8 @@ qstriggereditor::mousePressEvent (QMouseEvent *event)
             set_adding(true);
         }
     }
+
+    update();
 }
 
 /**
@@ -457,6 +484,8 @@ qstriggereditor::mouseReleaseEvent (QMouseEvent * event)
     m_moving_init = false;
     m_painting = false;
     m_seq.unpaint_all();
+
+    update();
 }
 
 /**
@@ -485,6 +514,8 @@ qstriggereditor::mouseMoveEvent (QMouseEvent * event)
         convert_x(m_current_x, &tick);
         drop_event(tick);
     }
+
+    update();
 }
 
 /**
@@ -535,6 +566,8 @@ qstriggereditor::keyPressEvent (QKeyEvent * event)
     }
     if (ret == true)
         m_seq.set_dirty();
+
+    update();
 }
 
 /**
@@ -699,6 +732,8 @@ qstriggereditor::set_adding (bool a_adding)
         setCursor(Qt::ArrowCursor);
         m_adding = false;
     }
+
+    update();
 }
 
 /**
@@ -710,6 +745,8 @@ qstriggereditor::set_data_type (midibyte a_status, midibyte a_control)
 {
     m_status = a_status;
     m_cc = a_control;
+
+    update();
 }
 
 }           // namespace seq64
@@ -116,6 +116,24 @@ protected:
         m_midi_master.api_flush();
     }
 
+    /**
+     *  Provides the output-queue time for lookahead scheduling.
+     */
+
+    virtual int64_t api_queue_time_us ()
+    {
+        return m_midi_master.api_queue_time_us();
+    }
+
+    /**
+     *  Removes the scheduled pattern events from the output queue.
+     */
+
+    virtual void api_cancel_scheduled ()
+    {
+        m_midi_master.api_cancel_scheduled();
+    }
+
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port)
     {
         m_midi_master.api_port_start(masterbus, bus, port);
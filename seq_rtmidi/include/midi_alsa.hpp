@@ -159,7 +159,11 @@ protected:
     virtual int api_poll_for_midi ();
 
     virtual void api_play (event * e24, midibyte channel);
-    virtual void api_sysex (event * e24);
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, int64_t when_us
+    );
+    virtual bool api_sysex (const midibyte * data, int len);
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
     virtual void api_start ();
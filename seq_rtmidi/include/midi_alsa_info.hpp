@@ -100,6 +100,8 @@ public:
     virtual void api_set_beats_per_minute (midibpm b);
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port);
     virtual void api_flush ();
+    virtual int64_t api_queue_time_us ();
+    virtual void api_cancel_scheduled ();
 
 private:
 
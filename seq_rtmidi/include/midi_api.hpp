@@ -139,7 +139,32 @@ public:
     virtual int api_poll_for_midi () = 0;
 
     virtual void api_play (event * e24, midibyte channel) = 0;
-    virtual void api_sysex (event * e24) = 0;
+
+    /**
+     *  Schedules an event on the output queue.  Only ALSA has one; the other
+     *  APIs play the event immediately.
+     */
+
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, int64_t /*when*/
+    )
+    {
+        api_play(e24, channel);
+    }
+
+    virtual bool api_sysex (const midibyte * data, int len) = 0;
+
+    /**
+     *  The largest piece of a SysEx message that api_sysex() is given.
+     *  Re-declared here so that rtmidi can forward it; JACK overrides it.
+     */
+
+    virtual int api_sysex_chunk () const
+    {
+        return midibase::api_sysex_chunk();
+    }
+
     virtual void api_continue_from (midipulse tick, midipulse beats) = 0;
     virtual void api_start () = 0;
     virtual void api_stop () = 0;
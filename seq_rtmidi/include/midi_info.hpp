@@ -433,6 +433,27 @@ public:
     virtual int api_poll_for_midi () = 0;
     virtual void api_flush () = 0;
 
+    /**
+     *  Provides the real time of the output queue, in microseconds, for
+     *  lookahead scheduling.  Used only in the midi_alsa_info class; a
+     *  negative value means events must be sent directly.
+     */
+
+    virtual int64_t api_queue_time_us ()
+    {
+        return -1;
+    }
+
+    /**
+     *  Removes scheduled pattern events from the output queue.  Used only in
+     *  the midi_alsa_info class.
+     */
+
+    virtual void api_cancel_scheduled ()
+    {
+        // Empty body
+    }
+
     /**
      *  Used only in the midi_jack_info class.
      */
@@ -24,6 +24,13 @@
 #include "midi_api.hpp"
 #include "midi_jack_info.hpp"           /* seq64::midi_jack_info            */
 
+/**
+ *  Indicates to midi_jack::send_message() that the message should be
+ *  stamped with the current JACK frame time.
+ */
+
+#define SEQ64_JACK_FRAME_NOW    jack_nframes_t(-1)
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -148,6 +155,7 @@ protected:
     void close_client ();
     void close_port ();
     bool create_ringbuffer (size_t rbsize);
+    bool create_sysex_ringbuffer (size_t rbsize);
     bool connect_port
     (
         bool input,
@@ -189,7 +197,19 @@ protected:
     }
 
     virtual void api_play (event * e24, midibyte channel);
-    virtual void api_sysex (event * e24);
+    virtual bool api_sysex (const midibyte * data, int len);
+
+    /**
+     * \return
+     *      Returns 0, because JACK MIDI events must be whole messages, so
+     *      SysEx is never split into pieces.
+     */
+
+    virtual int api_sysex_chunk () const
+    {
+        return 0;
+    }
+
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
     virtual void api_start ();
@@ -202,7 +222,12 @@ protected:
 private:
 
     void send_byte (midibyte evbyte);
-    bool send_message (const midi_message & message);
+    bool send_message
+    (
+        const midi_message & message,
+        jack_nframes_t frame = SEQ64_JACK_FRAME_NOW
+    );
+    bool send_data (const char * bytes, int nbytes, jack_nframes_t frame);
     bool set_virtual_name (int portid, const std::string & portname);
 
 };          // class midi_jack
@@ -228,6 +253,8 @@ public:
 
 private:
 
+    bool get_sysex_event (event * inev);
+
     /**
      *  This function is virtual, so we don't call it in the constructor,
      *  using open_client_impl() directly instead.  This function replaces the
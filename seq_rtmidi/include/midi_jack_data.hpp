@@ -26,6 +26,31 @@
 namespace seq64
 {
 
+/**
+ *  Provides the header that precedes each outgoing message in the
+ *  midi_jack_data::m_jack_buffsize ring-buffer.  Besides the size of the
+ *  message bytes stored in the m_jack_buffmessage ring-buffer, it carries the
+ *  JACK frame time at which the message was sent, so that the output process
+ *  callback can place the message at the proper frame offset in the cycle.
+ */
+
+typedef struct
+{
+    /**
+     *  Holds the value of jack_frame_time() when the message was queued,
+     *  possibly adjusted by the caller.
+     */
+
+    jack_nframes_t jh_frame;
+
+    /**
+     *  Holds the number of bytes in the message.
+     */
+
+    int jh_size;
+
+} jack_message_header_t;
+
 /**
  *  Contains the JACK MIDI API data as a kind of scratchpad for this object.
  *  This guy needs a constructor taking parameters for an rtmidi_in_data
@@ -54,8 +79,9 @@ struct midi_jack_data
     jack_port_t * m_jack_port;
 
     /**
-     *  Holds the size of data for communicating between the client
-     *  ring-buffer and the JACK port's internal buffer.
+     *  Holds the size and frame time of the data for communicating between
+     *  the client ring-buffer and the JACK port's internal buffer.  Each entry
+     *  is a jack_message_header_t.
      */
 
     jack_ringbuffer_t * m_jack_buffsize;
@@ -67,6 +93,16 @@ struct midi_jack_data
 
     jack_ringbuffer_t * m_jack_buffmessage;
 
+    /**
+     *  Input ports only.  Holds incoming SysEx messages too long to fit in a
+     *  midi_message, so that the input process callback can pass them on
+     *  without allocating memory.  Each entry is an int byte count followed
+     *  by the bytes.  Drained by midi_in_jack::api_get_midi_event() on the
+     *  non-real-time side.
+     */
+
+    jack_ringbuffer_t * m_jack_sysex;
+
     /**
      *  The last time-stamp obtained.  Use for calculating the delta time, I
      *  would imagine.
@@ -90,6 +126,7 @@ struct midi_jack_data
         m_jack_port         (nullptr),
         m_jack_buffsize     (nullptr),
         m_jack_buffmessage  (nullptr),
+        m_jack_sysex        (nullptr),
         m_jack_lasttime     (0),
         m_jack_rtmidiin     (nullptr)
     {
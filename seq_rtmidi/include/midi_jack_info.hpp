@@ -16,6 +16,7 @@
  *    the midi_jack
  */
 
+#include <poll.h>                       /* struct pollfd                */
 #include <jack/jack.h>
 
 #include "midi_info.hpp"                /* seq64::midi_port_info etc.   */
@@ -51,6 +52,14 @@ private:
 
     std::vector<midi_jack *> m_jack_ports;
 
+    /**
+     *  Holds the wake-up descriptors of the input ports' queues, for the
+     *  poll() in api_poll_for_midi().  A member, so that it is not
+     *  reallocated on every call.
+     */
+
+    std::vector<struct pollfd> m_poll_fds;
+
     /**
      *  Holds the JACK sequencer client pointer so that it can be used
      *  by the midibus objects.  This is actually an opaque pointer; there is
@@ -190,7 +190,7 @@ protected:
     }
 
     virtual void api_play (event * e24, midibyte channel);
-    virtual void api_sysex (event * e24);
+    virtual bool api_sysex (const midibyte * data, int len);
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
     virtual void api_start ();
@@ -115,6 +115,12 @@ protected:
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, int64_t when_us
+    );
+    virtual bool api_sysex (const midibyte * data, int len);
+    virtual int api_sysex_chunk () const;
 
 };          // class midibus (rtmidi version)
 
@@ -78,6 +78,14 @@ public:
         get_api()->api_play(e24, channel);
     }
 
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, int64_t when_us
+    )
+    {
+        get_api()->api_play_at(e24, channel, when_us);
+    }
+
     virtual void api_continue_from (midipulse tick, midipulse beats)
     {
         get_api()->api_continue_from(tick, beats);
@@ -143,9 +151,14 @@ public:
         return get_api()->api_poll_for_midi();
     }
 
-    virtual void api_sysex (event * e24)
+    virtual bool api_sysex (const midibyte * data, int len)
+    {
+        return get_api()->api_sysex(data, len);
+    }
+
+    virtual int api_sysex_chunk () const
     {
-        get_api()->api_sysex(e24);
+        return get_api()->api_sysex_chunk();
     }
 
     virtual void api_flush ()
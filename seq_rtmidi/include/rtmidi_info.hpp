@@ -268,6 +268,16 @@ public:
         get_api_info()->api_flush();
     }
 
+    int64_t api_queue_time_us ()
+    {
+        return get_api_info()->api_queue_time_us();
+    }
+
+    void api_cancel_scheduled ()
+    {
+        get_api_info()->api_cancel_scheduled();
+    }
+
     int api_poll_for_midi ()
     {
         return get_api_info()->api_poll_for_midi();
@@ -17,11 +17,12 @@
  *  refactor and partition, and slightly easier to read.
  */
 
+#include <atomic>                           /* std::atomic<unsigned>        */
 #include <string>                           /* std::string                  */
-#include <vector>                           /* std::vector container        */
 
 #include "event.hpp"                        /* seq64::event namespace       */
 #include "midibyte.hpp"                     /* seq64::midibyte typedef      */
+#include "seq64_rtmidi_features.h"          /* SEQ64_RTMIDI_CHECK_RT_ALLOC  */
 
 /**
  * This was the version of the RtMidi library from which this reimplementation
@@ -71,11 +72,20 @@
 #define SEQ64_NO_INDEX          (-1)        /* good values start at 0       */
 
 /**
- *  Default size of the MIDI queue.
+ *  Default size of the MIDI queue.  The ring holds one more slot than this.
  */
 
 #define SEQ64_DEFAULT_QUEUE_SIZE    100
 
+/**
+ *  Capacity of a midi_message, in bytes.  Large enough for any channel or
+ *  system message, and for short SysEx messages such as identity replies and
+ *  MMC commands.  Longer SysEx messages are too big to copy around in the
+ *  queue, and are handed off separately by the API that receives them.
+ */
+
+#define SEQ64_MIDI_MESSAGE_SIZE     32
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -116,6 +126,12 @@ enum rtmidi_api
  *  Provides a handy capsule for a MIDI message, based on the
  *  std::vector<unsigned char> data type from the RtMidi project.
  *
+ *  The bytes are now held in a fixed-size array, so that creating, copying,
+ *  and queuing a message never touches the heap.  This is necessary because
+ *  messages are built inside the JACK process callbacks, where allocating
+ *  memory can block.  Messages too long to fit (i.e. long SysEx) must be
+ *  handled by another path; see push() and assign().
+ *
  *  Please note that the ALSA module in sequencer64's rtmidi infrastructure
  *  uses the seq64::event rather than the seq64::midi_message object.
  *  For the moment, we will translate between them until we have the
@@ -125,27 +141,25 @@ enum rtmidi_api
 class midi_message
 {
 
-public:
+private:
 
     /**
-     *  Holds the data of the MIDI message.  Callers should use
-     *  midi_message::container rather than using the vector directly.
-     *  Bytes are added by the push() function, and are safely accessed
-     *  (with bounds-checking) by operator [].
+     *  Holds the event status and data bytes.  Only the first m_count bytes
+     *  are meaningful.
      */
 
-    typedef std::vector<midibyte> container;
-
-private:
+    midibyte m_bytes[SEQ64_MIDI_MESSAGE_SIZE];
 
     /**
-     *  Holds the event status and data bytes.
+     *  Holds the number of bytes in use in m_bytes[].
      */
 
-    container m_bytes;
+    int m_count;
 
     /**
-     *  Holds the (optional) timestamp of the MIDI message.
+     *  Holds the (optional) timestamp of the MIDI message.  For input
+     *  messages, this is the arrival time in microseconds on the monotonic
+     *  clock (see seq64::monotonic_us()), or 0 if not known.
      */
 
     double m_timestamp;
@@ -156,43 +170,64 @@ public:
 
     midibyte operator [] (int i) const
     {
-        return (i >= 0 && i < int(m_bytes.size())) ? m_bytes[i] : 0 ;
+        return (i >= 0 && i < m_count) ? m_bytes[i] : 0 ;
     }
 
-#ifdef USE_MIDI_MESSAGE_AT_ACCESS
-
-    midibyte & at (int i)
+    const char * array () const
     {
-        return m_bytes.at(i);       /* can throw an exception */
+        return reinterpret_cast<const char *>(&m_bytes[0]);
     }
 
-    const midibyte & at (int i) const
+    int count () const
     {
-        return m_bytes.at(i);       /* can throw an exception */
+        return m_count;
     }
 
-#endif
-
-    const char * array () const
+    bool empty () const
     {
-        return reinterpret_cast<const char *>(&m_bytes[0]);
+        return m_count == 0;
     }
 
-    int count () const
+    /**
+     * \return
+     *      Returns true if no more bytes can be pushed.
+     */
+
+    bool full () const
     {
-        return int(m_bytes.size());
+        return m_count == SEQ64_MIDI_MESSAGE_SIZE;
     }
 
-    bool empty () const
+    /**
+     *  Empties the message, without any deallocation.
+     */
+
+    void clear ()
     {
-        return m_bytes.empty();
+        m_count = 0;
     }
 
-    void push (midibyte b)
+    /**
+     *  Appends a byte to the message.
+     *
+     * \param b
+     *      The byte to append.
+     *
+     * \return
+     *      Returns false if the message is full; the byte is then dropped.
+     */
+
+    bool push (midibyte b)
     {
-        m_bytes.push_back(b);
+        bool result = m_count < SEQ64_MIDI_MESSAGE_SIZE;
+        if (result)
+            m_bytes[m_count++] = b;
+
+        return result;
     }
 
+    bool assign (const midibyte * data, int len);
+
     double timestamp () const
     {
         return m_timestamp;
@@ -205,7 +240,7 @@ public:
 
     bool is_sysex () const
     {
-        return m_bytes.size() > 0 ? event::is_sysex_msg(m_bytes[0]) : false ;
+        return m_count > 0 ? event::is_sysex_msg(m_bytes[0]) : false ;
     }
 
     void show () const;
@@ -215,7 +250,7 @@ public:
 /**
  *  MIDI caller callback function type definition.  Used to be nested in the
  *  rtmidi_in class.  The timestamp parameter has been folded into the
- *  midi_message class (a wrapper for std::vector<unsigned char>), and the
+ *  midi_message class (a wrapper for a fixed-size byte array), and the
  *  pointer has been replaced by a reference.
  */
 
@@ -229,6 +264,19 @@ typedef void (* rtmidi_callback_t)
  *  Provides a queue of midi_message structures.  This entity used to be a
  *  plain structure nested in the midi_in_api class.  We made it a class to
  *  encapsulate some common operations to save a burden on the callers.
+ *
+ *  The queue is a lock-free single-producer/single-consumer ring.  The
+ *  producer is the API's input callback (e.g. the JACK process thread), which
+ *  calls add() and then signal().  The consumer is the input thread
+ *  (perform::input_func()), which sleeps in a poll() on wake_fd(), then
+ *  calls front(), pop(), and pop_front().  The producer owns m_back, the
+ *  consumer owns m_front; each publishes its index with a release store,
+ *  and reads the other's index with an acquire load.  One slot is kept
+ *  empty to tell "full" from "empty", so no shared count is needed.
+ *
+ *  On Linux, an eventfd lets the consumer sleep until the producer signals
+ *  that data has arrived.  The file descriptor is available via wake_fd(),
+ *  so that several queues can be waited on with one poll() call.
  */
 
 class midi_queue
@@ -236,11 +284,11 @@ class midi_queue
 
 private:
 
-    unsigned m_front;
-    unsigned m_back;
-    unsigned m_size;
+    std::atomic<unsigned> m_front;
+    std::atomic<unsigned> m_back;
     unsigned m_ring_size;
     midi_message * m_ring;
+    int m_wake_fd;
 
 public:
 
@@ -248,21 +296,26 @@ public:
     ~midi_queue ();
 
     /**
-     * \getter m_size == 0
+     * \getter m_front == m_back
      */
 
     bool empty () const
     {
-        return m_size == 0;
+        return m_front.load(std::memory_order_acquire) ==
+            m_back.load(std::memory_order_acquire);
     }
 
     /**
-     * \getter m_size == 0
+     * \getter
+     *      The number of messages in the queue.  Exact only when called from
+     *      the producer or the consumer thread.
      */
 
     int count () const
     {
-        return int(m_size);
+        unsigned f = m_front.load(std::memory_order_acquire);
+        unsigned b = m_back.load(std::memory_order_acquire);
+        return m_ring_size > 0 ? int((b + m_ring_size - f) % m_ring_size) : 0 ;
     }
 
     /**
@@ -272,7 +325,20 @@ public:
 
     bool full () const
     {
-        return m_size == m_ring_size;
+        return m_ring_size == 0 || next_index
+        (
+            m_back.load(std::memory_order_relaxed)
+        ) == m_front.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \getter m_wake_fd
+     *      Returns -1 if the platform has no wake-up descriptor.
+     */
+
+    int wake_fd () const
+    {
+        return m_wake_fd;
     }
 
     bool add (const midi_message & mmsg);
@@ -280,14 +346,28 @@ public:
     midi_message pop_front ();
     void allocate (unsigned queuesize = SEQ64_DEFAULT_QUEUE_SIZE);
     void deallocate ();
+    void signal ();
+    void clear_signal ();
 
     /**
      * \getter m_ring[m_front]
+     *      Consumer only; check empty() first.
      */
 
     const midi_message & front () const
     {
-        return m_ring[m_front];
+        return m_ring[m_front.load(std::memory_order_relaxed)];
+    }
+
+private:
+
+    /**
+     *  Advances a ring index, wrapping around.
+     */
+
+    unsigned next_index (unsigned i) const
+    {
+        return (i + 1 == m_ring_size) ? 0 : i + 1 ;
     }
 
 };
@@ -474,6 +554,37 @@ public:
 
 };          // class rtmidi_in_data
 
+#ifdef SEQ64_RTMIDI_CHECK_RT_ALLOC
+
+/**
+ *  Marks the current thread as running real-time code (e.g. a JACK process
+ *  callback) for the lifetime of the object.  While any such guard is alive
+ *  in a thread, every heap allocation made by that thread is counted by the
+ *  replacement operator new in rtmidi_types.cpp.  Use the
+ *  SEQ64_RT_ALLOC_GUARD() macro rather than this class directly, so that the
+ *  check disappears from normal builds.
+ */
+
+class rt_alloc_guard
+{
+
+public:
+
+    rt_alloc_guard ();
+    ~rt_alloc_guard ();
+
+    static unsigned long count ();
+
+};          // class rt_alloc_guard
+
+#define SEQ64_RT_ALLOC_GUARD()  seq64::rt_alloc_guard rt_alloc_guard_object
+
+#else
+
+#define SEQ64_RT_ALLOC_GUARD()
+
+#endif      // SEQ64_RTMIDI_CHECK_RT_ALLOC
+
 }           // namespace seq64
 
 #endif      // SEQ64_RTMIDI_TYPES_HPP
@@ -74,6 +74,17 @@
 #define SEQ64_BUILD_RTMIDI_DUMMY        /* an alternative for OSX, etc.     */
 #endif
 
+/**
+ *  Debugging aid for the JACK real-time path.  If defined, the global
+ *  operator new and operator delete are replaced (see rtmidi_types.cpp) so
+ *  that heap allocations made inside a JACK process callback are counted.
+ *  There should be none; the count is reported when the JACK client is
+ *  closed.  Not for release builds, since every allocation in the
+ *  application pays for the check.
+ */
+
+#undef  SEQ64_RTMIDI_CHECK_RT_ALLOC
+
 #endif      // SEQ64_RTMIDI_FEATURES_H
 
 /*
@@ -266,7 +266,9 @@ mastermidibus::activate ()
  *  Initiate a poll() on the existing poll descriptors.  This is a
  *  primitive poll, which exits when some data is obtained.
  *
- *          m_midi_master.api_poll_for_midi();       // NON-FUNCTIONAL!
+ *  For JACK, the input busses are checked first without blocking.  If none
+ *  has data, midi_jack_info::api_poll_for_midi() sleeps until the JACK input
+ *  callback signals one of the input queues.
  */
 
 int
@@ -274,18 +276,10 @@ mastermidibus::api_poll_for_midi ()
 {
     if (m_use_jack_polling)
     {
-        for (;;)
-        {
-            if (m_inbus_array.poll_for_midi())
-            {
-                return 1;
-            }
-            else
-            {
-                millisleep(1);
-                return 0;
-            }
-        }
+        if (m_inbus_array.poll_for_midi())
+            return 1;
+        else
+            return m_midi_master.api_poll_for_midi();
     }
     else
         return m_midi_master.api_poll_for_midi();
@@ -294,12 +294,15 @@ midi_alsa::api_init_in ()
     snd_seq_port_subscribe_set_dest(subs, &dest);       /* local              */
 
     /*
-     * Use the master queue, and get ticks, then subscribe.
+     * Use the master queue, and get its real time as the timestamp of each
+     * incoming event, then subscribe.  See
+     * midi_alsa_info::api_get_midi_event().
      */
 
     int queue = parent_bus().queue_number();
     snd_seq_port_subscribe_set_queue(subs, queue);
     snd_seq_port_subscribe_set_time_update(subs, 1);
+    snd_seq_port_subscribe_set_time_real(subs, 1);
     result = snd_seq_subscribe_port(m_seq, subs);
     if (result < 0)
     {
@@ -487,7 +490,8 @@ midi_alsa::api_deinit_in ()
 
     int queue = parent_bus().queue_number();
     snd_seq_port_subscribe_set_queue(subs, queue);
-    snd_seq_port_subscribe_set_time_update(subs, queue);    /* get ticks    */
+    snd_seq_port_subscribe_set_time_update(subs, queue);    /* get stamps   */
+    snd_seq_port_subscribe_set_time_real(subs, 1);          /* real time    */
 
     int result = snd_seq_unsubscribe_port(m_seq, subs);     /* unsubscribe  */
     if (result < 0)
@@ -586,41 +590,71 @@ midi_alsa::api_play (event * e24, midibyte channel)
 }
 
 /**
- *  min() for long values.
+ *  Like api_play(), but rather than sending the event directly, schedules
+ *  it on the global queue at the given real time.  The event is tagged with
+ *  c_midibus_schedule_tag so that midi_alsa_info::api_cancel_scheduled() can
+ *  pull it back out.
  *
- * \param a
- *      First operand.
+ * \threadsafe
  *
- * \param b
- *      Second operand.
+ * \param e24
+ *      The event to be played on this bus.
  *
- * \return
- *      Returns the minimum value of a and b.
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param when_us
+ *      The real time of the global queue, in microseconds, at which the event
+ *      is to be delivered.
  */
 
-inline long
-min (long a, long b)
+void
+midi_alsa::api_play_at (event * e24, midibyte channel, int64_t when_us)
 {
-    return (a < b) ? a : b ;
-}
+    midibyte buffer[4];                             /* temp for MIDI data   */
+    buffer[0] = e24->get_status();                  /* fill buffer          */
+    buffer[0] += (channel & 0x0F);
+    e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
 
-/**
- *  Defines the value used for sleeping, in microseconds.  Defined locally
- *  simply for visibility.  Why 80000?
- */
+    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
+    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
+
+    snd_seq_event_t ev;
+    snd_seq_ev_clear(&ev);                          /* clear event          */
+    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
+    snd_midi_event_free(midi_ev);                   /* free the parser      */
+    snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
+    snd_seq_ev_set_subs(&ev);
+    ev.tag = c_midibus_schedule_tag;                /* cancellable          */
 
-#define SEQ64_USLEEP_US     80000
+    snd_seq_real_time_t when;
+    when.tv_sec = (unsigned int)(when_us / 1000000);
+    when.tv_nsec = (unsigned int)(when_us % 1000000) * 1000;
+    snd_seq_ev_schedule_real(&ev, parent_bus().queue_number(), 0, &when);
+    snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
+}
 
 /**
- *  Takes a native SYSEX event, encodes it to an ALSA event, and then
- *  puts it in the queue.
+ *  Sends one piece of a SysEx message directly to the subscribers of this
+ *  port, bypassing the queue.  The pieces, at most c_midibus_sysex_chunk
+ *  bytes each, come from midibase::send_sysex(), which is called by the
+ *  SysEx thread and paces them at the configured rate, so there is no
+ *  sleeping here, and no caller is held up while a dump goes out.
  *
- * \param e24
- *      The event to be handled.
+ * \param data
+ *      Points to the bytes of the piece.
+ *
+ * \param len
+ *      The number of bytes in the piece.
+ *
+ * \return
+ *      Always returns true.  The port is in blocking mode, so ALSA always
+ *      takes the piece; if it fails, the error is reported, and the piece is
+ *      dropped rather than retried.
  */
 
-void
-midi_alsa::api_sysex (event * e24)
+bool
+midi_alsa::api_sysex (const midibyte * data, int len)
 {
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);                              /* clear event      */
@@ -628,31 +662,11 @@ midi_alsa::api_sysex (event * e24)
     snd_seq_ev_set_source(&ev, m_local_addr_port);      /* set source       */
     snd_seq_ev_set_subs(&ev);
     snd_seq_ev_set_direct(&ev);                         /* it's immediate   */
+    snd_seq_ev_set_sysex(&ev, len, const_cast<midibyte *>(data));
+    if (snd_seq_event_output_direct(m_seq, &ev) < 0)   /* pump it out      */
+        errprint("SysEx output failed");
 
-    /*
-     *  Replaced by a vector of midibytes:
-     *
-     *      midibyte * data = e24->get_sysex();
-     *
-     *  This is a bit tricky, and relies on the standard property of
-     *  std::vector where all n elements of the vector are guaranteed to be
-     *  stored contiguously (in order to be accessible via random-access
-     *  iterators).
-     *
-     *  256 == c_midi_alsa_sysex_chunk
-     */
-
-    const int chunk = 256;
-    event::SysexContainer & data = e24->get_sysex();
-    int data_size = e24->get_sysex_size();
-    for (int offset = 0; offset < data_size; offset += chunk)
-    {
-        int data_left = data_size - offset;
-        snd_seq_ev_set_sysex(&ev, min(data_left, chunk), &data[offset]);
-        snd_seq_event_output_direct(m_seq, &ev);        /* pump into queue  */
-        usleep(SEQ64_USLEEP_US);
-        api_flush();
-    }
+    return true;
 }
 
 /**
@@ -840,30 +854,6 @@ midi_alsa::api_set_beats_per_minute (midibpm bpm)
     snd_seq_set_queue_tempo(m_seq, queue, tempo);
 }
 
-#ifdef REMOVE_QUEUED_ON_EVENTS_CODE
-
-/**
- *  Deletes events in the queue.  This function is not used anywhere, and
- *  there was no comment about the intent/context of this function.
- */
-
-void
-midi_alsa::remove_queued_on_events (int tag)
-{
-    snd_seq_remove_events_t * remove_events;
-    snd_seq_remove_events_malloc(&remove_events);
-    snd_seq_remove_events_set_condition
-    (
-        remove_events, SND_SEQ_REMOVE_OUTPUT | SND_SEQ_REMOVE_TAG_MATCH |
-            SND_SEQ_REMOVE_IGNORE_OFF
-    );
-    snd_seq_remove_events_set_tag(remove_events, tag);
-    snd_seq_remove_events(m_seq, remove_events);
-    snd_seq_remove_events_free(remove_events);
-}
-
-#endif      // REMOVE_QUEUED_ON_EVENTS_CODE
-
 /**
  *  ALSA MIDI input normal port or virtual port constructor.  The kind of port
  *  is determine by which port-initialization function the mastermidibus
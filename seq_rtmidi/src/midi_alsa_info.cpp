@@ -55,9 +55,11 @@
  *      SND_SEQ_PORT_CAP_NO_EXPORT      0x80
  */
 
+#include "alsa_timestamp.hpp"           /* seq64::alsa_arrival_us()         */
 #include "calculations.hpp"             /* seq64::tempo_us_from_bpm()       */
 #include "event.hpp"                    /* seq64::event and other tokens    */
 #include "midi_alsa_info.hpp"           /* seq64::midi_alsa_info            */
+#include "midibase.hpp"                 /* seq64::monotonic_us()            */
 #include "midibus_common.hpp"           /* from the libseq64 sub-project    */
 #include "settings.hpp"                 /* seq64::rc() configuration object */
 
@@ -293,6 +295,65 @@ midi_alsa_info::api_flush ()
     snd_seq_drain_output(m_alsa_seq);
 }
 
+/**
+ *  Gets the current real time of the global queue, which is the clock that
+ *  midi_alsa::api_play_at() schedules against.  Nothing else in the rtmidi
+ *  build starts this queue, so it is started here the first time lookahead
+ *  scheduling asks for it, and then left running.
+ *
+ * \return
+ *      Returns the queue time in microseconds, or -1 if the queue status
+ *      cannot be read.
+ */
+
+int64_t
+midi_alsa_info::api_queue_time_us ()
+{
+    int64_t result = -1;
+    int queue = global_queue();
+    snd_seq_queue_status_t * status;
+    snd_seq_queue_status_alloca(&status);
+    int rc = snd_seq_get_queue_status(m_alsa_seq, queue, status);
+    if (rc == 0 && snd_seq_queue_status_get_status(status) == 0)
+    {
+        snd_seq_start_queue(m_alsa_seq, queue, NULL);   /* not running yet  */
+        snd_seq_drain_output(m_alsa_seq);
+        rc = snd_seq_get_queue_status(m_alsa_seq, queue, status);
+    }
+    if (rc == 0)
+    {
+        const snd_seq_real_time_t * rt =
+            snd_seq_queue_status_get_real_time(status);
+
+        result = int64_t(rt->tv_sec) * 1000000 + int64_t(rt->tv_nsec) / 1000;
+    }
+    return result;
+}
+
+/**
+ *  Drains our output buffer into ALSA, and then removes from the global
+ *  queue the pattern events that are still waiting to be delivered, as
+ *  identified by their c_midibus_schedule_tag.  Note-offs are ignored, so
+ *  that a note whose note-on has already sounded is still released.
+ */
+
+void
+midi_alsa_info::api_cancel_scheduled ()
+{
+    snd_seq_drain_output(m_alsa_seq);
+
+    snd_seq_remove_events_t * remove_events;
+    snd_seq_remove_events_alloca(&remove_events);
+    snd_seq_remove_events_set_condition
+    (
+        remove_events, SND_SEQ_REMOVE_OUTPUT | SND_SEQ_REMOVE_TAG_MATCH |
+            SND_SEQ_REMOVE_IGNORE_OFF
+    );
+    snd_seq_remove_events_set_queue(remove_events, global_queue());
+    snd_seq_remove_events_set_tag(remove_events, c_midibus_schedule_tag);
+    snd_seq_remove_events(m_alsa_seq, remove_events);
+}
+
 /**
  *  Sets the PPQN numeric value, then makes ALSA calls to set up the PPQ
  *  tempo.
@@ -578,7 +639,10 @@ midi_alsa_info::api_get_midi_event (event * inev)
         return false;
     }
 
-    inev->set_timestamp(ev->time.tick);
+    inev->set_timestamp                         /* arrival time, in us  */
+    (
+        midipulse(alsa_arrival_us(m_alsa_seq, global_queue(), ev))
+    );
     inev->set_status_keep_channel(buffer[0]);
 
     /**
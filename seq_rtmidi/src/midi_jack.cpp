@@ -137,7 +137,9 @@
  *      make sure we're doing this correctly.
  */
 
+#include <cstring>                      /* memcpy() for the SysEx record    */
 #include <sstream>
+#include <vector>                       /* std::vector for long SysEx       */
 #include <jack/midiport.h>
 #include <jack/ringbuffer.h>
 
@@ -161,6 +163,86 @@
 namespace seq64
 {
 
+/**
+ *  Copies bytes into the write vector of a JACK ring-buffer, at the given
+ *  offset from the write pointer, wrapping into the second part of the
+ *  vector as needed.  The caller has already checked that there is room.
+ *
+ * \param vec
+ *      The write vector, from jack_ringbuffer_get_write_vector().
+ *
+ * \param offset
+ *      The offset from the start of the free space at which to copy.
+ *
+ * \param src
+ *      The bytes to copy.
+ *
+ * \param len
+ *      The number of bytes to copy.
+ */
+
+static void
+ringbuffer_copy
+(
+    const jack_ringbuffer_data_t * vec, size_t offset,
+    const char * src, size_t len
+)
+{
+    while (len > 0)
+    {
+        int part = offset < vec[0].len ? 0 : 1 ;
+        size_t start = part == 0 ? offset : offset - vec[0].len ;
+        size_t count = vec[part].len - start;
+        if (count > len)
+            count = len;
+
+        memcpy(vec[part].buf + start, src, count);
+        offset += count;
+        src += count;
+        len -= count;
+    }
+}
+
+/**
+ *  Stores a long SysEx message in the SysEx ring-buffer as a single record,
+ *  the size (an int) followed by the bytes.  Both parts are copied before
+ *  the write pointer is advanced, so the reader never sees a size without
+ *  its bytes.  Nothing is allocated, so this can be called from the JACK
+ *  process callback.
+ *
+ * \param rb
+ *      The SysEx ring-buffer.
+ *
+ * \param buffer
+ *      The bytes of the message.
+ *
+ * \param size
+ *      The number of bytes in the message.
+ *
+ * \return
+ *      Returns true if there was room for the record.  Otherwise the message
+ *      is lost, as it would be if the input queue were full.
+ */
+
+static bool
+sysex_record_write (jack_ringbuffer_t * rb, const midibyte * buffer, int size)
+{
+    size_t total = sizeof size + size_t(size);
+    bool result = not_nullptr(rb) && jack_ringbuffer_write_space(rb) >= total;
+    if (result)
+    {
+        jack_ringbuffer_data_t vec[2];
+        jack_ringbuffer_get_write_vector(rb, vec);
+        ringbuffer_copy(vec, 0, (const char *) &size, sizeof size);
+        ringbuffer_copy
+        (
+            vec, sizeof size, (const char *) buffer, size_t(size)
+        );
+        jack_ringbuffer_write_advance(rb, total);
+    }
+    return result;
+}
+
 /**
  *  Defines the JACK input process callback.  It is the JACK process callback
  *  for a MIDI output port (e.g. "system:midi_capture_1", which gives us the
@@ -172,9 +254,12 @@ namespace seq64
  *
  *      -#  Get the JACK port buffer and the MIDI event-count into this
  *          buffer.
- *      -#  For each MIDI event, get the event from JACK and push it into a
- *          local midi_message object.
- *      -#  Get the event time, converting it to a delta time if possible.
+ *      -#  For each MIDI event, get the event from JACK and copy it into a
+ *          local midi_message object.  If it is a SysEx message too long for
+ *          a midi_message, it is copied to the m_jack_sysex ring-buffer
+ *          instead, and the rest of the steps are skipped.
+ *      -#  Get the event's arrival time, from its JACK frame, on the
+ *          monotonic clock used by perform::arrival_tick() for recording.
  *      -#  If it is not a SysEx continuation, then:
  *          -#  If we're using a callback, pass the data to that callback.  Do
  *              we need this callback to interface with the midibus-based
@@ -183,6 +268,11 @@ namespace seq64
  *              queue.  One can then grab this data in a midibase ::
  *              poll_for_midi() call.  We still ought to check the add
  *              success.
+ *      -#  If anything was queued, signal the queue once, to wake up the
+ *          input thread.
+ *
+ *  Nothing here allocates memory: the midi_message is a fixed-size object,
+ *  and the queue and the ring-buffer are allocated when the port is set up.
  *
  *  The ALSA code polls for events, and that model is also available here.
  *  We're still working exactly how it will work best.
@@ -205,6 +295,8 @@ namespace seq64
 int
 jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
 {
+    SEQ64_RT_ALLOC_GUARD();
+
     midi_jack_data * jackdata = reinterpret_cast<midi_jack_data *>(arg);
     rtmidi_in_data * rtindata = jackdata->m_jack_rtmidiin;
 
@@ -240,31 +332,49 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
     {
         jack_midi_event_t jmevent;
         jack_time_t jtime;
+        midi_message message;
+        bool queued = false;
+        jack_client_t * client = jackdata->m_jack_client;
+        jack_nframes_t cyclestart = jack_last_frame_time(client);
+        jack_time_t jacknow = jack_get_time();
+        int64_t now_us = monotonic_us();
         int evcount = jack_midi_get_event_count(buff);
         for (int j = 0; j < evcount; ++j)
         {
-            midi_message message;
             int rc = jack_midi_event_get(&jmevent, buff, j);
             if (rc == 0)
             {
                 int eventsize = int(jmevent.size);
-                for (int i = 0; i < eventsize; ++i)
-                    message.push(jmevent.buffer[i]);
-
-                jack_time_t delta_jtime;
-                jtime = jack_get_time();            /* compute delta time   */
-                if (rtindata->first_message())
+                if (! message.assign(jmevent.buffer, eventsize))
                 {
-                    rtindata->first_message(false);
-                    delta_jtime = jack_time_t(0);
-                }
-                else
-                {
-                    jtime -= jackdata->m_jack_lasttime;
-                    delta_jtime = jack_time_t(jtime * 0.000001);
+                    /*
+                     * Too big for the queue; only a long SysEx can get here.
+                     */
+
+                    if
+                    (
+                        sysex_record_write
+                        (
+                            jackdata->m_jack_sysex, jmevent.buffer, eventsize
+                        )
+                    )
+                    {
+                        queued = true;
+                    }
+                    continue;
                 }
-                message.timestamp(delta_jtime);
-                jackdata->m_jack_lasttime = jtime;
+
+                /*
+                 * The event was captured during the previous period, at
+                 * frame offset jmevent.time.  Convert that frame to JACK
+                 * time, and then to the monotonic clock, via the times we
+                 * took at the top of the callback.
+                 */
+
+                jack_nframes_t frame = cyclestart + jmevent.time - nframes;
+                jtime = jack_frames_to_time(client, frame);
+                int64_t age_us = int64_t(jacknow) - int64_t(jtime);
+                message.timestamp(double(now_us - age_us));
                 if (! rtindata->continue_sysex())
                 {
                     if (rtindata->using_callback())
@@ -272,9 +382,9 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                         rtmidi_callback_t callback = rtindata->user_callback();
                         callback(message, rtindata->user_data());
                     }
-                    else
+                    else if (rtindata->queue().add(message))
                     {
-                        (void) rtindata->queue().add(message);
+                        queued = true;
                     }
                 }
             }
@@ -290,6 +400,8 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                 }
             }
         }
+        if (queued)
+            rtindata->queue().signal();     /* one wake-up per cycle        */
     }
     return 0;
 }
@@ -320,6 +432,16 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
  *  tests, we are getting 1024 frames, and the code seems to work without that
  *  loop.
  *
+ *  Each message used to be reserved at frame offset 0, so that everything
+ *  queued during a period landed at the start of the next buffer, smearing
+ *  the timing by up to a whole period.  Now each message carries the JACK
+ *  frame time at which it was sent (see midi_jack::send_message()), and is
+ *  played exactly one period later:  its offset in this cycle is its send
+ *  time plus nframes, minus jack_last_frame_time().  A message whose offset
+ *  falls beyond this cycle is left in the ring-buffer for a later cycle.
+ *  Late messages, and those that would be out of order, are clamped to the
+ *  last offset used, since JACK refuses unsorted events.
+ *
  * \param nframes
  *    The frame number to be processed.
  *
@@ -333,6 +455,8 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
 int
 jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
 {
+    SEQ64_RT_ALLOC_GUARD();
+
     midi_jack_data * jackdata = reinterpret_cast<midi_jack_data *>(arg);
 
 #ifdef SEQ64_USE_DEBUG_OUTPUT
@@ -357,7 +481,6 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
     }
 #endif  // SEQ64_USE_DEBUG_OUTPUT
 
-    static size_t soffset = 0;
     void * buf = jack_port_get_buffer(jackdata->m_jack_port, nframes);
     jack_midi_clear_buffer(buf);                    /* no nullptr test      */
 
@@ -369,29 +492,49 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
     );
 #endif
 
-    /*
-     * A for-loop over the number of nframes?  See discussion above.
-     */
-
-    while (jack_ringbuffer_read_space(jackdata->m_jack_buffsize) > 0)
+    jack_nframes_t cyclestart = jack_last_frame_time(jackdata->m_jack_client);
+    jack_nframes_t lastoffset = 0;
+    jack_message_header_t header;
+    while
+    (
+        jack_ringbuffer_read_space(jackdata->m_jack_buffsize) >= sizeof header
+    )
     {
-        int space;
-        (void) jack_ringbuffer_read
+        (void) jack_ringbuffer_peek
+        (
+            jackdata->m_jack_buffsize, (char *) &header, sizeof header
+        );
+
+        /*
+         * The signed difference handles the wrap-around of the frame
+         * counter.  Play the message one period after it was sent.
+         */
+
+        int32_t offset = int32_t(header.jh_frame + nframes - cyclestart);
+        if (offset >= int32_t(nframes))
+            break;                                  /* for a later cycle    */
+
+        if (offset < int32_t(lastoffset))
+            offset = int32_t(lastoffset);           /* late, keep in order  */
+
+        jack_ringbuffer_read_advance(jackdata->m_jack_buffsize, sizeof header);
+        size_t space = size_t(header.jh_size);
+        jack_midi_data_t * md = jack_midi_event_reserve
         (
-            jackdata->m_jack_buffsize, (char *) &space, sizeof space
+            buf, jack_nframes_t(offset), space
         );
-        jack_midi_data_t * md = jack_midi_event_reserve(buf, soffset, space);
         if (not_nullptr(md))
         {
             char * mididata = reinterpret_cast<char *>(md);
             (void) jack_ringbuffer_read         /* copy into mididata */
             (
-                jackdata->m_jack_buffmessage, mididata, size_t(space)
+                jackdata->m_jack_buffmessage, mididata, space
             );
+            lastoffset = jack_nframes_t(offset);
 
 #ifdef SEQ64_SHOW_API_CALLS_TMI
-            printf("%d bytes read: ", space);
-            for (int i = 0; i < space; ++i)
+            printf("%d bytes read at %d: ", int(space), int(offset));
+            for (size_t i = 0; i < space; ++i)
                 printf("%x ", (unsigned char)(mididata[i]));
 
             printf("\n");
@@ -399,6 +542,7 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
         }
         else
         {
+            jack_ringbuffer_read_advance(jackdata->m_jack_buffmessage, space);
             errprint("jack_midi_event_reserve() returned a null pointer");
         }
     }
@@ -454,6 +598,9 @@ midi_jack::~midi_jack ()
     if (not_nullptr(m_jack_data.m_jack_buffmessage))
         jack_ringbuffer_free(m_jack_data.m_jack_buffmessage);
 
+    if (not_nullptr(m_jack_data.m_jack_sysex))
+        jack_ringbuffer_free(m_jack_data.m_jack_sysex);
+
     apiprint("~midi_jack", "jack");
 }
 
@@ -752,50 +899,127 @@ midi_jack::api_play (event * e24, midibyte channel)
 }
 
 /**
- *  Sends a JACK MIDI output message.  It writes the full message size and
- *  the message itself to the JACK ring buffer.
+ *  Sends a JACK MIDI output message.  It writes the message itself, and then
+ *  a header holding the message size and JACK frame time, to the JACK ring
+ *  buffers.  The header is written last, so that the process callback never
+ *  sees a header without its bytes.  If there is no room for both, nothing is
+ *  written.
  *
  * \param message
  *      Provides the MIDI message object, which contains the bytes to send.
  *
+ * \param frame
+ *      Provides the JACK frame time at which the message is sent.  The
+ *      process callback plays the message one period after this time.  If
+ *      SEQ64_JACK_FRAME_NOW is passed, the current jack_frame_time() is used.
+ *
  * \return
  *      Returns true if the buffer message and buffer size seem to be written
  *      correctly.
  */
 
 bool
-midi_jack::send_message (const midi_message & message)
+midi_jack::send_message (const midi_message & message, jack_nframes_t frame)
+{
+#ifdef PLATFORM_DEBUG_TMI
+    message.show();
+#endif
+    return send_data(message.array(), message.count(), frame);
+}
+
+/**
+ *  Writes the bytes of one MIDI message, and then its header, to the JACK
+ *  ring buffers, as described for send_message().  This lower-level version
+ *  takes the bytes directly, so that SysEx messages, which are too large
+ *  for a midi_message, can be sent as well.
+ *
+ * \param bytes
+ *      Points to the bytes of the message.
+ *
+ * \param nbytes
+ *      The number of bytes in the message.
+ *
+ * \param frame
+ *      Provides the JACK frame time at which the message is sent, or
+ *      SEQ64_JACK_FRAME_NOW.
+ *
+ * \return
+ *      Returns true if the message and its header were written.  False means
+ *      there was no room for both, and nothing was written.
+ */
+
+bool
+midi_jack::send_data (const char * bytes, int nbytes, jack_nframes_t frame)
 {
-    int nbytes = message.count();
     bool result = nbytes > 0;
     if (result)
     {
-#ifdef PLATFORM_DEBUG_TMI
-        message.show();
-#endif
-        int count1 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffmessage, message.array(), message.count()
-        );
-        int count2 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffsize, (char *) &nbytes, sizeof nbytes
-        );
-        apiprint("send_message", "jack");
-        result = (count1 > 0) && (count2 > 0);
+        jack_message_header_t header;
+        header.jh_frame = frame == SEQ64_JACK_FRAME_NOW ?
+            jack_frame_time(client_handle()) : frame ;
+
+        header.jh_size = nbytes;
+        result =
+            jack_ringbuffer_write_space(m_jack_data.m_jack_buffmessage) >=
+                size_t(nbytes) &&
+            jack_ringbuffer_write_space(m_jack_data.m_jack_buffsize) >=
+                sizeof header;
+
+        if (result)
+        {
+            (void) jack_ringbuffer_write
+            (
+                m_jack_data.m_jack_buffmessage, bytes, size_t(nbytes)
+            );
+            (void) jack_ringbuffer_write
+            (
+                m_jack_data.m_jack_buffsize, (char *) &header, sizeof header
+            );
+            apiprint("send_message", "jack");
+        }
     }
     return result;
 }
 
 /**
- * \todo
- *      Flesh out this routine.
+ *  Sends a whole SysEx message as one JACK MIDI event.  JACK MIDI events
+ *  must be complete messages, so api_sysex_chunk() returns 0, and
+ *  midibase::send_sysex() hands over each message whole; the pacing is
+ *  applied between messages.  The message goes through the same
+ *  ring-buffers as the channel events, in order with them, and is played
+ *  by the process callback one period after it is sent.
+ *
+ * \param data
+ *      Points to the bytes of the message, starting with 0xF0.
+ *
+ * \param len
+ *      The number of bytes in the message.
+ *
+ * \return
+ *      Returns false if the ring-buffers have no room for the message right
+ *      now, so that it is offered again later.  A message that could never
+ *      fit is reported and dropped, and true is returned.
  */
 
-void
-midi_jack::api_sysex (event * /* e24 */)
+bool
+midi_jack::api_sysex (const midibyte * data, int len)
 {
-    // Will put this one off until later....
+    bool result = true;
+    if (m_jack_data.valid_buffer())
+    {
+        if (len < JACK_RINGBUFFER_SIZE)
+        {
+            result = send_data
+            (
+                reinterpret_cast<const char *>(data), len, SEQ64_JACK_FRAME_NOW
+            );
+        }
+        else
+        {
+            errprint("SysEx message too large for the JACK ring-buffer");
+        }
+    }
+    return result;
 }
 
 /**
@@ -1261,6 +1485,8 @@ midi_jack::register_port (bool input, const std::string & portname)
         {
             port_handle(p);
             result = true;
+            if (input)
+                result = create_sysex_ringbuffer(JACK_RINGBUFFER_SIZE);
         }
         else
         {
@@ -1321,6 +1547,35 @@ midi_jack::create_ringbuffer (size_t rbsize)
     return result;
 }
 
+/**
+ *  Creates the JACK ring-buffer that carries long incoming SysEx messages out
+ *  of the input process callback.  Called once the input port is registered,
+ *  so that the callback never has to allocate.
+ *
+ * \param rbsize
+ *      The size of the ring-buffer in bytes.
+ *
+ * \return
+ *      Returns true if the ring-buffer exists.
+ */
+
+bool
+midi_jack::create_sysex_ringbuffer (size_t rbsize)
+{
+    bool result = not_nullptr(m_jack_data.m_jack_sysex);
+    if (! result && rbsize > 0)
+    {
+        m_jack_data.m_jack_sysex = jack_ringbuffer_create(rbsize);
+        result = not_nullptr(m_jack_data.m_jack_sysex);
+        if (! result)
+        {
+            m_error_string = func_message("JACK SysEx ringbuffer error");
+            error(rterror::WARNING, m_error_string);
+        }
+    }
+    return result;
+}
+
 /*
  * MIDI JACK input class.
  */
@@ -1357,8 +1612,11 @@ midi_in_jack::midi_in_jack (midibus & parentbus, midi_info & masterinfo)
 
 /**
  *  Checks the rtmidi_in_data queue for the number of items in the queue.
- *
- *  WE MAY NEED LOCKING.
+ *  If the queue is empty, but a long SysEx message is waiting in the SysEx
+ *  ring-buffer, 1 is returned.  This function no longer sleeps; waiting for
+ *  input is done for all JACK input ports at once by
+ *  midi_jack_info::api_poll_for_midi().  The queue is lock-free, so no
+ *  locking is needed.
  *
  * \return
  *      Returns the value of rtindata->queue().count(), unless the caller is
@@ -1371,13 +1629,16 @@ midi_in_jack::api_poll_for_midi ()
     rtmidi_in_data * rtindata = m_jack_data.m_jack_rtmidiin;
     if (rtindata->using_callback())
     {
-        millisleep(1);
         return 0;
     }
     else
     {
-        millisleep(1);
-        return rtindata->queue().count();
+        int result = rtindata->queue().count();
+        jack_ringbuffer_t * rb = m_jack_data.m_jack_sysex;
+        if (result == 0 && not_nullptr(rb) && jack_ringbuffer_read_space(rb) > 0)
+            result = 1;
+
+        return result;
     }
 }
 
@@ -1412,8 +1673,20 @@ midi_in_jack::api_get_midi_event (event * inev)
     if (result)
     {
         midi_message mm = rtindata->queue().pop_front();
-        inev->set_timestamp(mm.timestamp());
-        if (mm.count() == 3)
+        inev->set_timestamp                     /* arrival time, in us  */
+        (
+            midipulse(int64_t(mm.timestamp()))
+        );
+        if (mm.is_sysex() && mm.count() > 3)
+        {
+            midibyte * data = const_cast<midibyte *>
+            (
+                reinterpret_cast<const midibyte *>(mm.array())
+            );
+            inev->set_status(EVENT_MIDI_SYSEX);
+            (void) inev->set_sysex(data, mm.count());
+        }
+        else if (mm.count() == 3)
         {
             inev->set_status_keep_channel(mm[0]);
             inev->set_data(mm[1], mm[2]);
@@ -1497,6 +1770,47 @@ midi_in_jack::api_get_midi_event (event * inev)
 #endif
         }
     }
+    else
+        result = get_sysex_event(inev);
+
+    return result;
+}
+
+/**
+ *  Gets the next long SysEx message, if any, that the input process callback
+ *  stored in the SysEx ring-buffer.  This is the non-real-time end of that
+ *  ring-buffer, so it is free to allocate the event's SysEx data.  The size
+ *  is only peeked at, and the record is consumed only once all of its bytes
+ *  are readable.
+ *
+ * \param inev
+ *      Provides the destination for the SysEx event.
+ *
+ * \return
+ *      Returns true if a SysEx event was obtained.
+ */
+
+bool
+midi_in_jack::get_sysex_event (event * inev)
+{
+    bool result = false;
+    jack_ringbuffer_t * rb = m_jack_data.m_jack_sysex;
+    int size = 0;
+    size_t space = not_nullptr(rb) ? jack_ringbuffer_read_space(rb) : 0 ;
+    if (space >= sizeof size)
+    {
+        (void) jack_ringbuffer_peek(rb, (char *) &size, sizeof size);
+        if (size > 0 && space >= sizeof size + size_t(size))
+        {
+            std::vector<midibyte> data(size);
+            jack_ringbuffer_read_advance(rb, sizeof size);
+            (void) jack_ringbuffer_read(rb, (char *) &data[0], size_t(size));
+            inev->set_timestamp(0);
+            inev->set_status(EVENT_MIDI_SYSEX);
+            (void) inev->set_sysex(&data[0], size);
+            result = true;
+        }
+    }
     return result;
 }
 
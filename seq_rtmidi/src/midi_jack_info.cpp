@@ -40,6 +40,14 @@
 #include "midibus_common.hpp"           /* from the libseq64 sub-project    */
 #include "settings.hpp"                 /* seq64::rc() configuration object */
 
+/**
+ *  The longest time, in milliseconds, that api_poll_for_midi() sleeps
+ *  waiting for input.  It bounds how long the input thread takes to notice
+ *  that it should exit; input itself wakes it up immediately.
+ */
+
+#define SEQ64_JACK_INPUT_WAIT_MS        100
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -73,6 +81,7 @@ extern int jack_process_rtmidi_output (jack_nframes_t nframes, void * arg);
 int
 jack_process_io (jack_nframes_t nframes, void * arg)
 {
+    SEQ64_RT_ALLOC_GUARD();
     if (nframes > 0)
     {
         midi_jack_info * self = reinterpret_cast<midi_jack_info *>(arg);
@@ -123,6 +132,7 @@ midi_jack_info::midi_jack_info
 ) :
     midi_info               (appname, ppqn, bpm),
     m_jack_ports            (),
+    m_poll_fds              (),
     m_jack_client           (nullptr),              /* inited for connect() */
     m_jack_client_2         (nullptr)
 {
@@ -144,6 +154,14 @@ midi_jack_info::midi_jack_info
 midi_jack_info::~midi_jack_info ()
 {
     disconnect();
+
+#ifdef SEQ64_RTMIDI_CHECK_RT_ALLOC
+    unsigned long rtallocs = rt_alloc_guard::count();
+    if (rtallocs > 0)
+    {
+        errprintf("%lu heap allocations in JACK process callbacks\n", rtallocs);
+    }
+#endif
 }
 
 /**
@@ -531,14 +549,75 @@ midi_jack_info::api_port_start
 }
 
 /**
- *  MUCH TO DO!
+ *  Waits for MIDI input on any of the JACK input ports.  The input process
+ *  callback signals each port's queue when it adds data to it, so here we
+ *  poll() all of the queues' wake-up descriptors at once, and sleep until
+ *  one of them is signalled or SEQ64_JACK_INPUT_WAIT_MS passes.  The timeout
+ *  lets the input thread notice when it is told to stop.
+ *
+ *  If the platform has no wake-up descriptors, this falls back to the old
+ *  one-millisecond sleep.
+ *
+ * \return
+ *      Returns the number of input ports with data waiting.
  */
 
 int
 midi_jack_info::api_poll_for_midi ()
 {
-    millisleep(1);
-    return 0;       // TODO TODO TODO
+    int result = 0;
+    m_poll_fds.clear();
+
+    std::vector<midi_jack *>::iterator mi;
+    for (mi = m_jack_ports.begin(); mi != m_jack_ports.end(); ++mi)
+    {
+        rtmidi_in_data * rtindata = (*mi)->jack_data().m_jack_rtmidiin;
+        if (not_nullptr(rtindata) && (*mi)->parent_bus().is_input_port())
+        {
+            midi_queue & q = rtindata->queue();
+            if (! q.empty())
+                ++result;
+            else if (q.wake_fd() >= 0)
+            {
+                struct pollfd pfd;
+                pfd.fd = q.wake_fd();
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                m_poll_fds.push_back(pfd);
+            }
+        }
+    }
+    if (result == 0)
+    {
+        if (m_poll_fds.empty())
+        {
+            millisleep(1);
+        }
+        else
+        {
+            int rc = poll
+            (
+                &m_poll_fds[0], nfds_t(m_poll_fds.size()),
+                SEQ64_JACK_INPUT_WAIT_MS
+            );
+            if (rc > 0)
+            {
+                for (mi = m_jack_ports.begin(); mi != m_jack_ports.end(); ++mi)
+                {
+                    rtmidi_in_data * rtindata =
+                        (*mi)->jack_data().m_jack_rtmidiin;
+
+                    if (not_nullptr(rtindata))
+                    {
+                        rtindata->queue().clear_signal();
+                        if (! rtindata->queue().empty())
+                            ++result;
+                    }
+                }
+            }
+        }
+    }
+    return result;
 }
 
 /**
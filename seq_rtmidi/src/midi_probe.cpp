@@ -154,7 +154,7 @@ midi_input_callback (midi_message & message, void * /*userdata*/)
     {
         std::cout
             << "Message (" << message.count() << " bytes, "
-            << "delta = " << message.timestamp() << "):"
+            << "time = " << message.timestamp() << " us):"
             << std::endl
             ;
         for (int i = 0; i < message.count(); ++i)
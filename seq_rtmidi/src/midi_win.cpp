@@ -379,13 +379,16 @@ midi_win::api_play (event * e24, midibyte channel)
 
 /**
  * \todo
- *      Flesh out this routine.
+ *      Flesh out this routine.  The piece is dropped for now.
+ *
+ * \return
+ *      Always returns true, so that the piece is not offered again.
  */
 
-void
-midi_win::api_sysex (event * /* e24 */)
+bool
+midi_win::api_sysex (const midibyte * /* data */, int /* len */)
 {
-    // Will put this one off until later....
+    return true;                            /* put this one off until later */
 }
 
 /**
@@ -966,7 +969,7 @@ midi_in_win::api_get_midi_event (event * inev)
     if (result)
     {
         midi_message mm = rtindata->queue().pop_front();
-        inev->set_timestamp(mm.timestamp());
+        inev->set_timestamp(0);                 /* arrival time unknown */
         if (mm.count() == 3)
         {
             inev->set_status_keep_channel(mm[0]);
@@ -377,6 +377,57 @@ midibus::api_play (event * e24, midibyte channel)
     m_rt_midi->api_play(e24, channel);
 }
 
+/**
+ *  Forwards a scheduled event to the API.  Only the ALSA API schedules it;
+ *  the others play it immediately.
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param when_us
+ *      The output-queue time, in microseconds, at which the event is due.
+ */
+
+void
+midibus::api_play_at (event * e24, midibyte channel, int64_t when_us)
+{
+    m_rt_midi->api_play_at(e24, channel, when_us);
+}
+
+/**
+ *  Forwards one piece of a SysEx message to the API.
+ *
+ * \param data
+ *      Points to the bytes of the piece.
+ *
+ * \param len
+ *      The number of bytes in the piece.
+ *
+ * \return
+ *      Returns false if the API has no room for the piece right now.
+ */
+
+bool
+midibus::api_sysex (const midibyte * data, int len)
+{
+    return m_rt_midi->api_sysex(data, len);
+}
+
+/**
+ * \return
+ *      Returns the size of the SysEx pieces the API wants; 0 means whole
+ *      messages.
+ */
+
+int
+midibus::api_sysex_chunk () const
+{
+    return m_rt_midi->api_sysex_chunk();
+}
+
 /**
  *  Continue from the given tick.  This function implements only the
  *  RtMidi-specific code.
@@ -13,9 +13,19 @@
  *  loosely based on Gary Scavone's RtMidi library.
  */
 
+#include <atomic>                       /* std::atomic<unsigned long>   */
+#include <cstdlib>                      /* std::malloc(), std::free()   */
+#include <cstring>                      /* std::memcpy()                */
+#include <new>                          /* std::bad_alloc               */
+
 #include "easy_macros.h"                /* errprintfunc() macro, etc.   */
 #include "rtmidi_types.hpp"             /* seq64::rtmidi, etc.          */
 
+#ifdef PLATFORM_LINUX
+#include <sys/eventfd.h>                /* eventfd(), eventfd_t         */
+#include <unistd.h>                     /* read(), write(), close()     */
+#endif
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -34,11 +44,45 @@ namespace seq64
 midi_message::midi_message ()
  :
     m_bytes     (),
+    m_count     (0),
     m_timestamp (0.0)
 {
     // Empty body
 }
 
+/**
+ *  Replaces the contents of the message with a block of bytes, in one copy.
+ *  Safe to call from a real-time callback.
+ *
+ * \param data
+ *      Provides the bytes to copy.
+ *
+ * \param len
+ *      Provides the number of bytes to copy.
+ *
+ * \return
+ *      Returns false if the bytes do not fit in the message.  In that case
+ *      the message is left empty, and the caller has to route the data
+ *      elsewhere.
+ */
+
+bool
+midi_message::assign (const midibyte * data, int len)
+{
+    bool result = len >= 0 && len <= SEQ64_MIDI_MESSAGE_SIZE;
+    if (result)
+    {
+        if (len > 0)
+            std::memcpy(m_bytes, data, size_t(len));
+
+        m_count = len;
+    }
+    else
+        m_count = 0;
+
+    return result;
+}
+
 /**
  *  Shows the bytes in a message, for trouble-shooting.
  */
@@ -46,7 +90,7 @@ midi_message::midi_message ()
 void
 midi_message::show () const
 {
-    if (m_bytes.empty())
+    if (empty())
     {
         fprintf(stderr, "midi_message: empty\n");
         fflush(stderr);
@@ -54,14 +98,9 @@ midi_message::show () const
     else
     {
         fprintf(stderr, "midi_message:\n");
-        for
-        (
-            container::const_iterator ci = m_bytes.begin();
-            ci != m_bytes.end(); ++ci
-        )
-        {
-            fprintf(stderr, " 0x%2x", int(*ci));
-        }
+        for (int i = 0; i < m_count; ++i)
+            fprintf(stderr, " 0x%2x", int(m_bytes[i]));
+
         fprintf(stderr, "\n");
         fflush(stderr);
     }
@@ -72,17 +111,21 @@ midi_message::show () const
  */
 
 /**
- *  Default constructor.
+ *  Default constructor.  Allocates the ring, and on Linux creates the
+ *  non-blocking eventfd used to wake up the consumer.
  */
 
 midi_queue::midi_queue ()
  :
     m_front     (0),
     m_back      (0),
-    m_size      (0),
     m_ring_size (0),
-    m_ring      (nullptr)
+    m_ring      (nullptr),
+    m_wake_fd   (-1)
 {
+#ifdef PLATFORM_LINUX
+    m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
     allocate();
 }
 
@@ -93,12 +136,21 @@ midi_queue::midi_queue ()
 midi_queue::~midi_queue ()
 {
     deallocate();
+#ifdef PLATFORM_LINUX
+    if (m_wake_fd >= 0)
+        (void) close(m_wake_fd);
+#endif
 }
 
 /**
+ *  Allocates the ring.  Not thread-safe; it must be called before the
+ *  producer and consumer start using the queue.
  *
  *  This would be better off as a constructor operation.  But one step at a
  *  time.
+ *
+ * \param queuesize
+ *      The number of messages the queue can hold.
  */
 
 void
@@ -107,9 +159,9 @@ midi_queue::allocate (unsigned queuesize)
     deallocate();
     if (queuesize > 0 && is_nullptr(m_ring))
     {
-        m_ring = new(std::nothrow) midi_message[queuesize];
+        m_ring = new(std::nothrow) midi_message[queuesize + 1];
         if (not_nullptr(m_ring))
-            m_ring_size = queuesize;
+            m_ring_size = queuesize + 1;
     }
 }
 
@@ -127,11 +179,21 @@ midi_queue::deallocate ()
         delete [] m_ring;
         m_ring = nullptr;
     }
+    m_ring_size = 0;
+    m_front.store(0);
+    m_back.store(0);
 }
 
 /**
- *
  *  As long as we haven't reached our queue size limit, push the message.
+ *  Producer side only.  The message is copied into the slot before the new
+ *  back index is published, so the consumer never sees a partial message.
+ *
+ * \param mmsg
+ *      The message to copy into the queue.
+ *
+ * \return
+ *      Returns false if the queue was full, and the message was dropped.
  */
 
 bool
@@ -140,11 +202,9 @@ midi_queue::add (const midi_message & mmsg)
     bool result = ! full();
     if (result)
     {
-        m_ring[m_back++] = mmsg;
-        if (m_back == m_ring_size)
-            m_back = 0;
-
-        ++m_size;
+        unsigned b = m_back.load(std::memory_order_relaxed);
+        m_ring[b] = mmsg;
+        m_back.store(next_index(b), std::memory_order_release);
     }
     else
     {
@@ -155,7 +215,7 @@ midi_queue::add (const midi_message & mmsg)
 
 /**
  *  Pops, so to speak, the front message out of the queue, effectively
- *  throwing it away.  One useful call sequence is:
+ *  throwing it away.  Consumer side only.  One useful call sequence is:
  *
 \verbatim
     midi_message latest = queue.front();
@@ -168,17 +228,16 @@ midi_queue::add (const midi_message & mmsg)
 void
 midi_queue::pop ()
 {
-    --m_size;
-    ++m_front;
-    if (m_front == m_ring_size)
-        m_front = 0;
+    if (! empty())
+    {
+        unsigned f = m_front.load(std::memory_order_relaxed);
+        m_front.store(next_index(f), std::memory_order_release);
+    }
 }
 
 /**
- *  Pops a copy of the front message.   Could be a little inefficient, since a
- *  couple of copies are made, and we cannot use return-code optimization.
- *
- *  Perhaps at some point we could use move semantics?
+ *  Pops a copy of the front message.  Consumer side only.  The copy is a
+ *  fixed-size object, so nothing is allocated.
  *
  * \return
  *      Returns a copy of the message that was in front before the popping.
@@ -190,15 +249,49 @@ midi_message
 midi_queue::pop_front ()
 {
     midi_message result;
-    if (m_size != 0)
+    if (! empty())
     {
-        midi_message & mmr = m_ring[m_front];
-        result = mmr;
+        result = front();
         pop();
     }
     return result;
 }
 
+/**
+ *  Wakes up a consumer blocked in a poll() on wake_fd().
+ *  Producer side.  Writing to a non-blocking eventfd does not block or
+ *  allocate, so this is safe to call from a real-time callback.  It is meant
+ *  to be called once per batch of add() calls, not per message.
+ */
+
+void
+midi_queue::signal ()
+{
+#ifdef PLATFORM_LINUX
+    if (m_wake_fd >= 0)
+    {
+        eventfd_t one = 1;
+        (void) write(m_wake_fd, &one, sizeof one);
+    }
+#endif
+}
+
+/**
+ *  Resets the wake-up descriptor after a wake-up.  Consumer side.
+ */
+
+void
+midi_queue::clear_signal ()
+{
+#ifdef PLATFORM_LINUX
+    if (m_wake_fd >= 0)
+    {
+        eventfd_t value;
+        (void) read(m_wake_fd, &value, sizeof value);
+    }
+#endif
+}
+
 /*
  * class rtmidi_in_data
  */
@@ -219,8 +312,87 @@ rtmidi_in_data::rtmidi_in_data ()
     // no body
 }
 
+#ifdef SEQ64_RTMIDI_CHECK_RT_ALLOC
+
+/*
+ * class rt_alloc_guard
+ */
+
+/**
+ *  The nesting depth of rt_alloc_guard objects in the current thread.  A
+ *  plain thread-local is enough, since only the owning thread touches it.
+ */
+
+static thread_local int s_rt_depth = 0;
+
+/**
+ *  The number of heap allocations seen while s_rt_depth was non-zero, in any
+ *  thread.
+ */
+
+static std::atomic<unsigned long> s_rt_allocations(0);
+
+/**
+ *  Enters a real-time section.
+ */
+
+rt_alloc_guard::rt_alloc_guard ()
+{
+    ++s_rt_depth;
+}
+
+/**
+ *  Leaves a real-time section.
+ */
+
+rt_alloc_guard::~rt_alloc_guard ()
+{
+    --s_rt_depth;
+}
+
+/**
+ * \getter s_rt_allocations
+ */
+
+unsigned long
+rt_alloc_guard::count ()
+{
+    return s_rt_allocations.load();
+}
+
+#endif      // SEQ64_RTMIDI_CHECK_RT_ALLOC
+
 }           // namespace seq64
 
+#ifdef SEQ64_RTMIDI_CHECK_RT_ALLOC
+
+/**
+ *  Replaces the global allocator to count allocations made inside an
+ *  rt_alloc_guard.  The array and nothrow forms, and sized delete, forward to
+ *  these two in the standard library, so they need not be replaced.
+ */
+
+void *
+operator new (std::size_t sz)
+{
+    if (seq64::s_rt_depth > 0)
+        ++seq64::s_rt_allocations;
+
+    void * result = std::malloc(sz > 0 ? sz : 1);
+    if (is_nullptr(result))
+        throw std::bad_alloc();
+
+    return result;
+}
+
+void
+operator delete (void * p) noexcept
+{
+    std::free(p);
+}
+
+#endif      // SEQ64_RTMIDI_CHECK_RT_ALLOC
+
 /*
  * rtmidi_types.cpp
  *